@@ -0,0 +1,44 @@
+#ifndef FastSimulation_TrackerSetup_TrackerAliasTable_H
+#define FastSimulation_TrackerSetup_TrackerAliasTable_H
+
+#include <vector>
+
+/** A Walker alias table over the bins of a histogrammed density on
+ *  [xMin,xMax] : a sample costs one bin lookup and one comparison, from
+ *  two uniform random numbers, whatever the shape of the density.
+ */
+
+class TrackerAliasTable {
+
+ public:
+
+  /// An empty table (see build())
+  TrackerAliasTable() : theXMin(0.), theStep(0.) {}
+
+  /// The table of the bin weights (not necessarily normalized) of a
+  /// density on [xMin,xMax]
+  void build(const std::vector<double>& weights, double xMin, double xMax);
+
+  /// A value of x from two uniform random numbers in [0,1) : u chooses
+  /// the bin (and its alias), v the position inside the bin
+  inline double sample(double u, double v) const {
+    double scaled = u*theProbability.size();
+    unsigned bin = static_cast<unsigned>(scaled);
+    if ( bin >= theProbability.size() ) bin = theProbability.size()-1;
+    if ( scaled-bin >= theProbability[bin] ) bin = theAlias[bin];
+    return theXMin + (bin+v)*theStep;
+  }
+
+  /// Number of bins
+  inline unsigned size() const { return theProbability.size(); }
+
+ private:
+
+  double theXMin;
+  double theStep;
+  /// Probability to keep bin i rather than taking its alias
+  std::vector<float> theProbability;
+  std::vector<unsigned short> theAlias;
+
+};
+#endif
@@ -0,0 +1,104 @@
+#ifndef FastSimulation_TrackerSetup_TrackerBatchPropagator_H
+#define FastSimulation_TrackerSetup_TrackerBatchPropagator_H
+
+#include <boost/thread/mutex.hpp>
+
+#include <vector>
+
+class TrackerInteractionGeometry;
+
+/** Straight-line propagation of many particles (photons, neutral hadrons)
+ *  through the interaction geometry, layer by layer rather than particle 
+ *  by particle. The particles are grouped by side (sign of eta) and first
+ *  layer, and split in batches. Each batch goes through the layers one at
+ *  a time, so that the data of a layer are used for the whole batch.
+ *  Batches are independent : with several threads, each idle thread takes
+ *  the next batch. The number of particles tested and crossing each layer
+ *  is recorded, to tune the batch size.
+ */
+
+class TrackerBatchPropagator {
+
+ public:
+
+  /// A straight line from (0,0,z0), starting at the layer firstLayer of 
+  /// its side (0 for particles from the primary vertex)
+  struct Particle { 
+    float eta;
+    float z0;
+    unsigned short firstLayer;
+  };
+
+  /// A layer crossing
+  struct Crossing { 
+    /// Index of the particle in the input vector
+    unsigned particle;
+    /// Index of the layer in TrackerInteractionGeometry::layer(side,i)
+    unsigned short layer;
+    /// Path length from (0,0,z0) to the crossing (cm)
+    float path;
+    /// Material (x/X0) seen at the crossing, fudge factors included
+    float radLen;
+  };
+
+  /// Constructor
+  TrackerBatchPropagator(const TrackerInteractionGeometry& geometry,
+			 unsigned batchSize);
+
+  /// Propagate the particles of an event. The crossings are ordered by 
+  /// batch, then by layer, then by particle.
+  void propagate(const std::vector<Particle>& particles,
+		 std::vector<Crossing>& crossings,
+		 unsigned nThreads=1);
+
+  /// Number of batches of the last event
+  inline unsigned nBatches() const { return theBatches.size(); }
+
+  /// Number of particles tested on, and crossing, the i-th layer of a 
+  /// side, summed over all events so far
+  inline unsigned long tested(unsigned side, unsigned i) const { return theTested[side][i]; }
+  inline unsigned long crossed(unsigned side, unsigned i) const { return theCrossed[side][i]; }
+
+  /// Mean number of particles of a batch crossing the i-th layer of a side
+  double occupancy(unsigned side, unsigned i) const;
+
+  /// Reset the counters
+  void resetCounters();
+
+ private:
+
+  struct Batch { 
+    unsigned side;
+    unsigned firstLayer;
+    unsigned begin;
+    unsigned end;
+  };
+
+  /// Propagate one batch, and fill its crossings and layer counters
+  void propagate(const Batch& batch,
+		 const std::vector<Particle>& particles,
+		 std::vector<Crossing>& crossings,
+		 std::vector<unsigned long>* tested,
+		 std::vector<unsigned long>* crossed) const;
+
+  /// The loop of a worker thread
+  void work(const std::vector<Particle>* particles);
+
+ private:
+
+  const TrackerInteractionGeometry& theGeometry;
+  unsigned theBatchSize;
+
+  /// The particle indices, sorted by side and first layer
+  std::vector<unsigned> theOrder;
+  std::vector<Batch> theBatches;
+  std::vector< std::vector<Crossing> > theBatchCrossings;
+  unsigned theNextBatch;
+  boost::mutex theMutex;
+
+  std::vector<unsigned long> theTested[2];
+  std::vector<unsigned long> theCrossed[2];
+  std::vector<unsigned long> theBatchesAtLayer[2];
+
+};
+#endif
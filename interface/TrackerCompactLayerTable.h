@@ -0,0 +1,107 @@
+#ifndef FastSimulation_TrackerSetup_TrackerCompactLayerTable_H
+#define FastSimulation_TrackerSetup_TrackerCompactLayerTable_H
+
+#include <vector>
+#include <algorithm>
+
+class TrackerLayer;
+
+/** A single-precision copy of the layer quantities used by the straight
+ *  line crossing and material kernels, stored as one array per quantity
+ *  and per side. Disks store (|z|, inner radius, outer radius), cylinders
+ *  store (radius, half length, |z| beyond which the modules are tilted,
+ *  with the cosine and sine of the tilt). The fudge factors of layer i are
+ *  [theFudgeOffsets[i],theFudgeOffsets[i+1]). The configuration values 
+ *  have about five significant digits, well within single precision.
+ */
+
+class TrackerCompactLayerTable {
+
+ public:
+
+  /// Constructor from the layers of each side
+  TrackerCompactLayerTable(const std::vector<const TrackerLayer*>& positiveLayers,
+			   const std::vector<const TrackerLayer*>& negativeLayers);
+
+  /// Number of layers of a side
+  inline unsigned nLayers(unsigned side) const { return theForward[side].size(); }
+
+  /// Same as TrackerLayer::straightCrossing, for the i-th layer of a side
+  inline bool straightCrossing(unsigned side, unsigned i, 
+			       float z0, float sinTheta, float cosTheta,
+			       float& path, float& dim, float& angle) const {
+    if ( theForward[side][i] ) { 
+      if ( cosTheta <= 0.f ) return false;
+      path = (thePosition[side][i]-z0)/cosTheta;
+      if ( path <= 0.f ) return false;
+      dim = path*sinTheta;
+      angle = 1.f/cosTheta;
+      return dim >= theLow[side][i] && dim <= theHigh[side][i];
+    }
+    if ( sinTheta <= 0.f ) return false;
+    path = thePosition[side][i]/sinTheta;
+    float z = z0+path*cosTheta;
+    dim = z < 0.f ? -z : z;
+    if ( dim <= theHigh[side][i] ) { 
+      angle = 1.f/sinTheta;
+    } else { 
+      float cosNormal = sinTheta*theCosTilt[side][i] + (z > 0.f ? cosTheta : -cosTheta)*theSinTilt[side][i];
+      angle = 1.f/std::max(cosNormal < 0.f ? -cosNormal : cosNormal,1E-6f);
+    }
+    return dim <= theLow[side][i];
+  }
+
+  /// The first fudge factor of the i-th layer of a side at dim (1 if none)
+  inline float fudgeFactorAt(unsigned side, unsigned i, float dim) const { 
+    for ( unsigned iFudge=theFudgeOffsets[side][i]; iFudge<theFudgeOffsets[side][i+1]; ++iFudge ) 
+      if ( dim > theFudgeMin[side][iFudge] && dim < theFudgeMax[side][iFudge] ) 
+	return theFudgeFactor[side][iFudge];
+    return 1.f;
+  }
+
+  /// Same as TrackerLayer::straightRadLen, for the i-th layer of a side
+  inline float straightRadLen(unsigned side, unsigned i, 
+			      float z0, float sinTheta, float cosTheta) const {
+    float path, dim, angle;
+    if ( !straightCrossing(side,i,z0,sinTheta,cosTheta,path,dim,angle) ) return 0.f;
+    return theRadLen[side][i] * fudgeFactorAt(side,i,dim) * angle;
+  }
+
+  /// Same as TrackerInteractionGeometry::materialBudget
+  float materialBudget(float eta, float z0) const;
+
+  /// Memory used by the table (bytes)
+  unsigned size() const;
+
+  /// The columns of a side, e.g. for bindings to other languages
+  inline const std::vector<unsigned short>& layerNumbers(unsigned side) const { return theLayerNumber[side]; }
+  inline const std::vector<unsigned char>& forward(unsigned side) const { return theForward[side]; }
+  inline const std::vector<float>& positions(unsigned side) const { return thePosition[side]; }
+  inline const std::vector<float>& lows(unsigned side) const { return theLow[side]; }
+  inline const std::vector<float>& highs(unsigned side) const { return theHigh[side]; }
+  inline const std::vector<float>& radLens(unsigned side) const { return theRadLen[side]; }
+  inline const std::vector<float>& cosTilts(unsigned side) const { return theCosTilt[side]; }
+  inline const std::vector<float>& sinTilts(unsigned side) const { return theSinTilt[side]; }
+  inline const std::vector<unsigned short>& fudgeOffsets(unsigned side) const { return theFudgeOffsets[side]; }
+  inline const std::vector<float>& fudgeMins(unsigned side) const { return theFudgeMin[side]; }
+  inline const std::vector<float>& fudgeMaxs(unsigned side) const { return theFudgeMax[side]; }
+  inline const std::vector<float>& fudgeFactors(unsigned side) const { return theFudgeFactor[side]; }
+
+ private:
+
+  std::vector<unsigned short> theLayerNumber[2];
+  std::vector<unsigned char> theForward[2];
+  std::vector<float> thePosition[2];
+  std::vector<float> theLow[2];
+  std::vector<float> theHigh[2];
+  std::vector<float> theRadLen[2];
+  std::vector<float> theCosTilt[2];
+  std::vector<float> theSinTilt[2];
+
+  std::vector<unsigned short> theFudgeOffsets[2];
+  std::vector<float> theFudgeMin[2];
+  std::vector<float> theFudgeMax[2];
+  std::vector<float> theFudgeFactor[2];
+
+};
+#endif
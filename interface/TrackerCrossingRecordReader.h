@@ -0,0 +1,56 @@
+#ifndef FastSimulation_TrackerSetup_TrackerCrossingRecordReader_H
+#define FastSimulation_TrackerSetup_TrackerCrossingRecordReader_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/** Read-only access to a file written by TrackerCrossingRecorder. The file
+ *  is memory-mapped, and the columns of each block are used in place.
+ */
+
+class TrackerCrossingRecordReader {
+
+ public:
+
+  /// The columns of one block (pointers into the mapped file)
+  struct Block { 
+    unsigned size;
+    const unsigned* event;
+    const unsigned short* layer;
+    const unsigned char* side;
+    const signed char* fudgeBin;
+    const float* r;
+    const float* z;
+    const float* phi;
+    const float* path;
+    const float* radLen;
+  };
+
+  /// Constructor : map the file and index its blocks
+  TrackerCrossingRecordReader(const std::string& fileName);
+
+  /// Destructor : unmap the file
+  ~TrackerCrossingRecordReader();
+
+  /// The blocks of the file
+  inline unsigned nBlocks() const { return theBlocks.size(); }
+  inline const Block& block(unsigned i) const { return theBlocks[i]; }
+
+  /// Total number of crossings
+  unsigned long nCrossings() const;
+
+ private:
+
+  /// Not copyable
+  TrackerCrossingRecordReader(const TrackerCrossingRecordReader&);
+  TrackerCrossingRecordReader& operator=(const TrackerCrossingRecordReader&);
+
+ private:
+
+  void* theData;
+  std::size_t theSize;
+  std::vector<Block> theBlocks;
+
+};
+#endif
@@ -0,0 +1,95 @@
+#ifndef FastSimulation_TrackerSetup_TrackerCrossingRecorder_H
+#define FastSimulation_TrackerSetup_TrackerCrossingRecorder_H
+
+#include "DataFormats/GeometryVector/interface/GlobalPoint.h"
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class TrackerLayer;
+
+namespace boost { 
+  class thread;
+}
+
+/** Records layer crossings in a binary file, in blocks of columns, for the
+ *  offline tuning of the fudge factors. Crossings are added to one block 
+ *  while the previous block is written by a background thread (double 
+ *  buffering) : the caller only waits if the writer is a full block late.
+ *
+ *  File format : the 8-byte header "TKXREC01", then blocks made of the 
+ *  number of rows n (uint32) and of the columns
+ *    event (n x uint32), r, z, phi, path, radLen (n x float each),
+ *    layer (n x uint16), side (n x uint8), fudge bin (n x int8, -1 if none),
+ *  in this order, so that every column is 4-byte aligned in the file.
+ *  Read with TrackerCrossingRecordReader.
+ */
+
+class TrackerCrossingRecorder {
+
+ public:
+
+  /// One block of crossings, one vector per column
+  struct Block { 
+    std::vector<unsigned> event;
+    std::vector<unsigned short> layer;
+    std::vector<unsigned char> side;
+    std::vector<signed char> fudgeBin;
+    std::vector<float> r;
+    std::vector<float> z;
+    std::vector<float> phi;
+    std::vector<float> path;
+    std::vector<float> radLen;
+    void clear();
+    inline unsigned size() const { return event.size(); }
+  };
+
+  /// Constructor : the output file, and the number of crossings per block
+  TrackerCrossingRecorder(const std::string& fileName, unsigned blockSize=65536);
+
+  /// Destructor : write the last block and close the file
+  ~TrackerCrossingRecorder();
+
+  /// The event of the next crossings
+  inline void beginEvent(unsigned event) { theEvent = event; }
+
+  /// Record a crossing of the i-th layer of a side
+  void record(unsigned side, unsigned layerIndex, const TrackerLayer& layer,
+	      const GlobalPoint& position, double path, double radLen);
+
+  /// Number of crossings recorded so far
+  inline unsigned long nCrossings() const { return theNCrossings; }
+
+ private:
+
+  /// Hand the current block to the writer thread
+  void flush();
+
+  /// The loop of the writer thread
+  void write();
+
+ private:
+
+  std::FILE* theFile;
+  unsigned theBlockSize;
+  unsigned theEvent;
+  unsigned long theNCrossings;
+
+  /// The block being filled, and the block being written
+  Block theBlocks[2];
+  Block* theFilling;
+  Block* theWriting;
+  bool theWritingFull;
+  bool theStop;
+
+  boost::mutex theMutex;
+  boost::condition_variable theCondition;
+  boost::scoped_ptr<boost::thread> theWriter;
+
+};
+#endif
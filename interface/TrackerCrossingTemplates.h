@@ -0,0 +1,104 @@
+#ifndef FastSimulation_TrackerSetup_TrackerCrossingTemplates_H
+#define FastSimulation_TrackerSetup_TrackerCrossingTemplates_H
+
+#include <vector>
+#include <utility>
+
+class TrackerLayer;
+
+/** Ordered lists of the layers crossed by a straight line (photons, neutral
+ *  hadrons), precomputed on a grid of (|eta|, vertex z) for each side of
+ *  the tracker, with the material of each crossing and the cumulative 
+ *  material in front of it. Negative eta is folded with (eta, z0) -> 
+ *  (-eta, -z0) and looked up in the templates of the negative side.
+ */
+
+class TrackerCrossingTemplates {
+
+ public:
+
+  /// One layer crossing
+  struct Crossing {
+    /// Index of the layer in TrackerInteractionGeometry::layer(side,i),
+    /// with the side of the sign of eta
+    unsigned short layer;
+    /// Path length from the vertex to the crossing (cm)
+    float path;
+    /// Material correction for the crossing angle (1/cos)
+    float angle;
+    /// r (disks) or |z| (cylinders) of the crossing, for the fudge factors
+    float dim;
+    /// Material (x/X0) of the crossing, fudge factors (averaged over phi)
+    /// and crossing angle included
+    float radLen;
+    /// Material (x/X0) of the crossings before this one along the line
+    float radLenBefore;
+  };
+
+  typedef std::pair<std::vector<Crossing>::const_iterator,
+                    std::vector<Crossing>::const_iterator> CrossingRange;
+
+  /// Constructor : the layers of each side, 
+  /// nEta bins in [0,etaMax], nZ bins in [-zMax,zMax]
+  TrackerCrossingTemplates(const std::vector<const TrackerLayer*>& positiveLayers,
+			   const std::vector<const TrackerLayer*>& negativeLayers,
+			   unsigned nEta, double etaMax,
+			   unsigned nZ, double zMax);
+
+  /// Is the (eta, z0) point inside the grid ?
+  bool covers(double eta, double z0) const;
+
+  /// The template of the nearest grid node (no intersection computed)
+  CrossingRange crossings(double eta, double z0) const;
+
+  /// The exact crossings, computed only for the layers present in the
+  /// templates of the four surrounding grid nodes, ordered by path length
+  void refinedCrossings(double eta, double z0,
+			std::vector<Crossing>& result) const;
+
+  /// Number of templates and of stored crossings
+  inline unsigned nTemplates() const 
+    { return theOffsets[0].size()+theOffsets[1].size()-2; }
+  inline unsigned nCrossings() const 
+    { return theCrossings[0].size()+theCrossings[1].size(); }
+
+ private:
+
+  /// Fill the crossings of a straight line, ordered by path length
+  void fill(unsigned side, double eta, double z0,
+	    const std::vector<unsigned short>& candidates,
+	    std::vector<Crossing>& result) const;
+
+  /// Fold (eta, z0) to positive eta, and return the side
+  inline static unsigned fold(double& eta, double& z0) {
+    unsigned side = eta < 0.;
+    double sign = 1.-2.*side;
+    eta *= sign;
+    z0 *= sign;
+    return side;
+  }
+
+  inline unsigned node(unsigned iEta, unsigned iZ) const {
+    return iEta*(theNZ+1)+iZ;
+  }
+
+ private:
+
+  std::vector<const TrackerLayer*> theLayers[2];
+  /// x/X0 of the layers, read once from their surfaces
+  std::vector<float> theRadLen[2];
+
+  unsigned theNEta;
+  double theEtaMax;
+  double theEtaStep;
+  unsigned theNZ;
+  double theZMax;
+  double theZStep;
+
+  /// All templates of a side, concatenated. 
+  /// Template i is [theOffsets[side][i],theOffsets[side][i+1])
+  std::vector<Crossing> theCrossings[2];
+  std::vector<unsigned> theOffsets[2];
+
+};
+#endif
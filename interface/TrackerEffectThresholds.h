@@ -0,0 +1,75 @@
+#ifndef FastSimulation_TrackerSetup_TrackerEffectThresholds_H
+#define FastSimulation_TrackerSetup_TrackerEffectThresholds_H
+
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerStepper.h"
+
+#include <vector>
+
+/** The momenta above which the material effects of a layer crossing are
+ *  negligible : the multiple scattering angle 13.6 MeV/p sqrt(x/X0)
+ *  (1 + 0.038 ln(x/X0)) below a tolerance (rad), and the mean ionization
+ *  loss (silicon-equivalent) below a fraction of the momentum. They are
+ *  computed once per layer, fudge factor range and bin of crossing angle
+ *  correction (at the upper edge of the bin, so that they are upper
+ *  bounds), and per layer for any crossing up to the largest angle
+ *  correction. A propagation loop can then leave out the effects of most
+ *  of the crossings of energetic particles without computing them.
+ *  Bremsstrahlung and nuclear interactions are not covered : their
+ *  probabilities do not decrease with the momentum.
+ */
+
+class TrackerEffectThresholds {
+
+ public:
+
+  enum Effect { MultipleScattering=0, EnergyLoss=1, NEffects=2 };
+
+  /// Constructor from the layers of the geometry, with nAngle bins of
+  /// angle correction in [1,maxAngle]
+  TrackerEffectThresholds(const TrackerInteractionGeometry& geometry,
+			  double msTolerance, double energyLossTolerance,
+			  unsigned nAngle, double maxAngle);
+
+  /// The threshold (GeV) of an effect at the crossing of the i-th layer of
+  /// a side, at dim (|z| for a cylinder, r for a disk) and angle correction
+  float threshold(Effect effect, unsigned side, unsigned i,
+		  double dim, double angle) const;
+
+  /// The threshold of an effect for any crossing of the i-th layer of a
+  /// side, with an angle correction up to maxAngle
+  inline float layerThreshold(Effect effect, unsigned side, unsigned i) const {
+    return theLayerThresholds[side][i*NEffects+effect];
+  }
+
+  /// The effects to compute for the crossings of a particle of momentum p
+  /// (bit e set if effect e is not negligible)
+  void filter(unsigned side, double p,
+	      const std::vector<TrackerLayerStepper::Crossing>& crossings,
+	      std::vector<unsigned char>& needed) const;
+
+ private:
+
+  /// The bin of a crossing in the layer table
+  unsigned bin(unsigned side, unsigned i, double dim) const;
+
+ private:
+
+  const TrackerInteractionGeometry* theGeometry;
+  unsigned theNAngle;
+  double theMaxAngle;
+  double theInvAngleStep;
+
+  /// Bins of layer i are [theOffsets[side][i],theOffsets[side][i+1]) :
+  /// no fudge range, then one per fudge range (or one for a material map)
+  std::vector<unsigned> theOffsets[2];
+
+  /// Thresholds, (bin, angle, effect) with effect fastest
+  std::vector<float> theThresholds[2];
+
+  /// Thresholds per layer, (layer, effect), and the largest x/X0 of a
+  /// crossing they cover (the thresholds increase with x/X0)
+  std::vector<float> theLayerThresholds[2];
+  std::vector<float> theLayerMaxRadLen[2];
+
+};
+#endif
@@ -0,0 +1,120 @@
+#ifndef FastSimulation_TrackerSetup_TrackerGeometryProfiler_H
+#define FastSimulation_TrackerSetup_TrackerGeometryProfiler_H
+
+#include <boost/thread/mutex.hpp>
+
+#include <string>
+#include <vector>
+
+namespace edm { 
+  class ParameterSet;
+}
+
+/** Timing and memory of the construction phases of the interaction 
+ *  geometry, and sampled latencies of the geometry queries. The phases 
+ *  are summarized in the log, and can be written as Chrome trace events
+ *  (JSON) for the usual trace viewers. The sampled queries are only 
+ *  aggregated per query name (count, total, maximum and a histogram of 
+ *  the latencies), so that the memory used does not grow with the job.
+ */
+
+class TrackerGeometryProfiler {
+
+ public:
+
+  /// A construction phase
+  struct Record { 
+    std::string name;
+    /// Start time and duration (microseconds since the profiler creation)
+    double start;
+    double duration;
+    /// Change of the allocated heap memory during the phase (bytes)
+    long allocated;
+    /// Nesting depth of the phase
+    unsigned depth;
+  };
+
+  /// The sampled latencies of a query : bin i of the histogram counts 
+  /// the latencies in [2^(i-1),2^i) us (bin 0 : below 1 us, last bin : 
+  /// everything above)
+  static const unsigned nQueryBins = 16;
+  struct QueryStatistics { 
+    const char* name;
+    unsigned long count;
+    double sum;
+    double max;
+    unsigned long histogram[nQueryBins];
+  };
+
+  /// Times a phase from construction to destruction (nothing if the 
+  /// profiler is 0)
+  class Scope { 
+  public:
+    Scope(TrackerGeometryProfiler* profiler, const char* name) : 
+      theProfiler(profiler) { if ( theProfiler ) theProfiler->begin(name); }
+    ~Scope() { if ( theProfiler ) theProfiler->end(); }
+  private:
+    TrackerGeometryProfiler* theProfiler;
+  };
+
+  /// Constructor : sample 1 query in querySampling (0 = none), write the
+  /// trace to traceFile if not empty
+  TrackerGeometryProfiler(unsigned querySampling, const std::string& traceFile);
+
+  /// Destructor : summarize the sampled queries, and write the trace
+  ~TrackerGeometryProfiler();
+
+  /// The profiler requested by the configuration, 0 if none
+  static TrackerGeometryProfiler* create(const edm::ParameterSet& trackerMaterial);
+
+  /// The trace file name with a label appended before the extension, so
+  /// that the geometries of different labels do not overwrite each other
+  static std::string traceFile(const std::string& traceFile, const std::string& label);
+
+  /// Start and end a construction phase (phases may be nested)
+  void begin(const char* name);
+  void end();
+
+  /// Add the construction phases timed by another profiler (e.g., before
+  /// the geometry was created), on the same time axis
+  void add(const TrackerGeometryProfiler& other);
+
+  /// Summarize the construction phases in the log
+  void summarizeConstruction() const;
+
+  /// Should this query be timed ? If so, returns its start time
+  bool sampleQuery(double& start);
+  /// Add a sampled query started at start to the statistics of its name
+  /// (a string literal : the statistics keep the pointer)
+  void endQuery(const char* name, double start);
+
+  /// Microseconds since the profiler creation
+  double now() const;
+
+  /// The construction phases so far
+  inline const std::vector<Record>& records() const { return theRecords; }
+
+  /// The statistics of the sampled queries so far, one per query name
+  inline const std::vector<QueryStatistics>& queries() const { return theQueries; }
+
+ private:
+
+  /// Currently allocated heap memory (bytes)
+  static long allocatedMemory();
+
+  /// Write the records as Chrome trace events
+  void writeTrace() const;
+
+ private:
+
+  double theOrigin;
+  unsigned theQuerySampling;
+  unsigned long theNQueries;
+  std::string theTraceFile;
+  std::vector<Record> theRecords;
+  std::vector<unsigned> theOpen;
+  std::vector<QueryStatistics> theQueries;
+  boost::mutex theMutex;
+
+};
+#endif
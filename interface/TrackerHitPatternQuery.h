@@ -0,0 +1,84 @@
+#ifndef FastSimulation_TrackerSetup_TrackerHitPatternQuery_H
+#define FastSimulation_TrackerSetup_TrackerHitPatternQuery_H
+
+#include <vector>
+
+class TrackerInteractionGeometry;
+
+/** The layers expected to be crossed by a helix on its way out, as bit
+ *  masks : bit n of the sensitive mask for the sensitive layer number n,
+ *  bit n of the dead mask for the dead-material layer number 100+n. The
+ *  constructor throws if a layer of the geometry has no bit (sensitive
+ *  numbers from 64, dead ones from 164).
+ *  Only the (r, |z|) extent of the layers is used : the crossing of a
+ *  cylinder is where the transverse circle reaches its radius, the
+ *  crossing of a disk is where the helix reaches its z. The helix is
+ *  followed from its start to its largest radius (half a turn at most).
+ *
+ *  The helix follows the convention of TrackerLooperCache : the point at
+ *  turning angle a >= 0 is
+ *  (xc + R cos(phi0 + q a), yc + R sin(phi0 + q a), z0 + a dz/dphi).
+ */
+
+class TrackerHitPatternQuery {
+
+ public:
+
+  /// The helix parameters
+  struct Helix {
+    float xc, yc, radius;
+    float phi0;
+    int q;
+    float z0, dzdphi;
+  };
+
+  /// The expected layers
+  struct HitPattern {
+    unsigned long long sensitive;
+    unsigned long long dead;
+  };
+
+  /// Constructor : a copy of the layer extents of both sides
+  TrackerHitPatternQuery(const TrackerInteractionGeometry& geometry);
+
+  /// The layers crossed by one helix
+  HitPattern hitPattern(const Helix& helix) const;
+
+  /// Same for all the helices of an event
+  void hitPatterns(const std::vector<Helix>& helices,
+		   std::vector<HitPattern>& patterns) const;
+
+  /// Number of layers in a pattern
+  static unsigned count(const HitPattern& pattern);
+
+ private:
+
+  /// The layers of one side
+  struct Layers {
+    /// Cylinders : radius, half length, bit
+    std::vector<float> cylinderRadius;
+    std::vector<float> cylinderHalfLength;
+    std::vector<unsigned short> cylinderBit;
+    /// Disks : |z|, inner and outer radius, bit
+    std::vector<float> diskZ;
+    std::vector<float> diskInnerRadius;
+    std::vector<float> diskOuterRadius;
+    std::vector<unsigned short> diskBit;
+  };
+
+  /// The bit of a layer number (64 + bit for dead material), throws if
+  /// none
+  static unsigned short bit(unsigned layerNumber);
+
+  /// Set a bit in a pattern
+  static inline void set(HitPattern& pattern, unsigned short bit) {
+    if ( bit < 64 ) pattern.sensitive |= 1ULL << bit;
+    else pattern.dead |= 1ULL << (bit-64);
+  }
+
+ private:
+
+  Layers theLayers[2];
+
+};
+#endif
@@ -9,12 +9,25 @@
 
 //FAMOS Headers
 #include "FastSimulation/TrackerSetup/interface/TrackerLayer.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerCrossingTemplates.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerMaterialPalette.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerMaterialSamplingTables.h"
 
 #include <list>
 #include <vector>
+#include <string>
 
 class MediumProperties;
 class GeometricSearchTracker;
+class TrackerLayerModuleGrid;
+class TrackerLayerMaterialMap;
+class TrackerMaterialVoxelGrid;
+class TrackerLayerPairTables;
+class TrackerEffectThresholds;
+class TrackerLayerIndex;
+class TrackerLayerPositions;
+class TrackerCompactLayerTable;
+class TrackerGeometryProfiler;
 
 namespace edm { 
   class ParameterSet;
@@ -27,15 +40,35 @@ class TrackerInteractionGeometry
 
   enum FirstCylinders { PXB=0,PXD=3,TIB=5,TID=9,TOB=12,TEC=18 };
 
+  /// The two sides of the tracker. The disks of the negative side are at
+  /// negative z, the cylinders of both sides are identical in shape.
+  enum Side { PositiveZ=0, NegativeZ=1 };
+
   /// Constructor : get the configurable parameters
   TrackerInteractionGeometry(const edm::ParameterSet& trackerMaterial,
 			     const GeometricSearchTracker* geomSearchTracker);
 
+  /// Constructor from the active layer positions only
+  TrackerInteractionGeometry(const edm::ParameterSet& trackerMaterial,
+			     const TrackerLayerPositions* layerPositions);
+
+  /// Constructor of the part that does not depend on the active layer 
+  /// positions (material tables, media, fixed dead material), e.g. in a 
+  /// thread while the reco geometry is built. Complete it with build().
+  TrackerInteractionGeometry(const edm::ParameterSet& trackerMaterial);
+
+  /// Build a geometry from the constructor above, with the same 
+  /// configuration and the active layer positions
+  void build(const edm::ParameterSet& trackerMaterial,
+	     const TrackerLayerPositions* layerPositions);
+
   /// Destructor
   ~TrackerInteractionGeometry();
 
-  /// Initialize the interaction geometry
-  /// void initialize(const GeometricSearchTracker* geomSearchTracker);
+  /// Build the module lookup grids of the sensitive layers, in nThreads
+  /// threads (needs the reco geometry)
+  void buildModuleGrids(const GeometricSearchTracker* geomSearchTracker,
+			unsigned nPhi, unsigned nU, unsigned nThreads=1);
 
   /// Returns the first pointer in the cylinder list
   inline std::list<TrackerLayer>::const_iterator cylinderBegin() const
@@ -49,18 +82,211 @@ class TrackerInteractionGeometry
   inline const int nCylinders() const 
     { return static_cast<const int>(_theCylinders.size()); }
 
+  /// Returns the i-th layer of the cylinder list (inside to outside)
+  inline const TrackerLayer& layer(unsigned i) const 
+    { return *_theLayers[i]; }
+
+  /// The side of a given z (or of a direction with a given cos(theta))
+  inline static Side side(double z) 
+    { return static_cast<Side>(z < 0.); }
+
+  /// Same as above, for the cylinder list of a given side
+  inline std::list<TrackerLayer>::const_iterator cylinderBegin(Side side) const
+    { return _theSides[side]->begin(); }
+  inline std::list<TrackerLayer>::const_iterator cylinderEnd(Side side) const
+    { return _theSides[side]->end(); }
+  inline const int nCylinders(Side side) const 
+    { return static_cast<const int>(_theSides[side]->size()); }
+  inline const TrackerLayer& layer(Side side, unsigned i) const 
+    { return *(*_theSideLayers[side])[i]; }
+
+  /// Returns the index of the layers of a side in (r,|z|), for 
+  /// non-nested geometries and fast lookups among many layers
+  inline const TrackerLayerIndex& layerIndex(Side side) const 
+    { return *_theLayerIndex[side]; }
+
+  /// Returns how far (cm) a misaligned layer surface can be from its 
+  /// ideal position, to widen the index lookups (0 if ideal)
+  inline double misalignmentMargin() const { return _theMisalignmentMargin; }
+
+  /// Returns the profiler of the construction and of the queries (0 if
+  /// profiling was not requested)
+  inline TrackerGeometryProfiler* profiler() const { return _theProfiler; }
+
+  /// Returns the straight-line crossing templates for neutral particles
+  /// (0 if they were not requested)
+  inline const TrackerCrossingTemplates* neutralCrossingTemplates() const 
+    { return _theNeutralTemplates; }
+
+  /// Returns the distinct materials of the layers (see 
+  /// TrackerLayer::materialIndex()), empty unless material_palette or
+  /// sampling_tables was requested
+  inline const TrackerMaterialPalette& materialPalette() const 
+    { return _thePalette; }
+
+  /// Returns the alias tables of the energy loss fluctuations, per 
+  /// material of the palette, and of the energy sharing of photon 
+  /// conversions (0 if they were not requested)
+  inline const TrackerMaterialSamplingTables* energyLossTables() const 
+    { return _theEnergyLossTables; }
+  inline const TrackerMaterialSamplingTables* conversionTables() const 
+    { return _theConversionTables; }
+
+  /// Returns the density of the energy loss tables, which converts
+  /// their samples into energy losses (0 if they were not requested)
+  inline const TrackerMaterialSamplingTables::LandauEnergyLoss* energyLossDensity() const 
+    { return _theEnergyLossDensity; }
+
+  /// Returns the material and multiple scattering tables between the
+  /// sensitive layer pairs (0 if they were not requested)
+  inline const TrackerLayerPairTables* layerPairTables() const 
+    { return _theLayerPairTables; }
+
+  /// Returns the momentum thresholds of the material effects
+  /// (0 if they were not requested)
+  inline const TrackerEffectThresholds* effectThresholds() const 
+    { return _theEffectThresholds; }
+
+  /// Returns the single-precision copy of the layer table
+  /// (0 if it was not requested)
+  inline const TrackerCompactLayerTable* compactLayerTable() const 
+    { return _theCompactTable; }
+
+  /// Returns the (r,z) voxel grid of a side (0 if not requested)
+  inline const TrackerMaterialVoxelGrid* voxelGrid(Side side) const 
+    { return _theVoxelGrid[side]; }
+
+  /// Returns the material (x/X0, fudge factors included) seen by a 
+  /// straight line from (0,0,z0) at pseudo-rapidity eta, from the 
+  /// surfaces or from the voxel grids (material_backend)
+  double materialBudget(double eta, double z0=0.) const;
+
  private:
 
   // Fudge factors to apply to each layer material (private use only)
   std::vector<double> fudgeFactors(unsigned layerNr); 
   std::vector<double> minDim(unsigned layerNr);
   std::vector<double> maxDim(unsigned layerNr);
+
+  /// Initialize the interaction geometry
+  void initialize(const edm::ParameterSet& trackerMaterial,
+		  const TrackerLayerPositions* layerPositions);
+
+  /// Read the material tables of the hardcoded geometry from the 
+  /// configuration, or take them from the generated tables
+  void readMaterialTables(const edm::ParameterSet& trackerMaterial);
+  void loadGeneratedTables();
+
+  /// The material tables, the media, and the surfaces of the dead 
+  /// material that do not depend on the active layer positions
+  void prepareDeadMaterial(const edm::ParameterSet& trackerMaterial);
+  void clearFixedDeadMaterial();
+
+  /// Hand over a surface built by prepareDeadMaterial (layerNr >= 100)
+  BoundCylinder* fixedCylinder(unsigned layerNr);
+  BoundDisk* fixedDisk(unsigned layerNr);
+
+  /// Build the negative side as the mirror image of the positive side,
+  /// with the forward sensitive layers of the negative side of the tracker
+  void buildNegativeSide(const TrackerLayerPositions& layerPositions);
+
+  /// The negative-z image of a layer, with its own material and position
+  TrackerLayer negativeLayer(const TrackerLayer& layer, double thickness,
+			     double z, double innerRadius, double outerRadius);
+
+  /// Set the first-order misalignment of the sensitive layers
+  void applyMisalignment(const TrackerLayerPositions& layerPositions);
+
+  /// Rasterize the layers of each side into nR x nZ cells
+  void buildVoxelGrids(unsigned nR, unsigned nZ);
+
+  /// Check that the layers of a list are nested
+  void checkNesting(const std::list<TrackerLayer>& cylinders) const;
+
+  /// Fudge factors of the flexible geometry, per barrel or disk layer
+  void flexibleFudgeFactors(const edm::ParameterSet& trackerMaterial,
+			    const std::string& prefix,
+			    std::vector< std::vector<double> >& theMin,
+			    std::vector< std::vector<double> >& theMax,
+			    std::vector< std::vector<double> >& theFudge) const;
+
+  /// Material maps of the layers, from the configuration, from a file
+  /// or from the fudge factor ranges
+  void buildMaterialMaps(const edm::ParameterSet& trackerMaterial);
+
+  /// The medium with a given radiation length, shared by all layers 
+  /// with that radiation length
+  MediumProperties* medium(double radLen);
+
+  /// Whether a layer reaches into the region r < region_max_radius and
+  /// |z| < region_max_z (a disk : inner radius and z, a cylinder : radius)
+  bool reachesRegion(bool forward, double radius, double z) const;
+
+  /// Add a layer of the hardcoded geometry to the positive side if it
+  /// reaches into the region, free its surface otherwise
+  void addLayer(const TrackerLayer& layer);
+
+  /// Index of the reco barrel (forward) layer of a sensitive layer of the
+  /// hardcoded geometry, from its layer number (-1 for dead material)
+  static int recoLayerIndex(const TrackerLayer& layer);
+
+  /// Merge adjacent dead-material layers closer than tolerance (in cm)
+  void mergeDeadLayers(Side side, double tolerance);
+  /// Can two adjacent layers be replaced by a single effective layer ?
+  bool mergeable(const TrackerLayer& first, 
+		 const TrackerLayer& second, 
+		 double tolerance) const;
+  /// The effective layer equivalent to two mergeable layers
+  TrackerLayer mergedLayer(const TrackerLayer& first, 
+			   const TrackerLayer& second);
  
  private:
 
   /// The list of tracker (sensistive or not) layers
   std::list<TrackerLayer> _theCylinders;
 
+  /// The same list, for the negative side
+  std::list<TrackerLayer> _theNegativeCylinders;
+
+  /// Direct access to the same layers, by index
+  std::vector<const TrackerLayer*> _theLayers;
+  std::vector<const TrackerLayer*> _theNegativeLayers;
+
+  /// The lists of each side, indexed by Side
+  std::list<TrackerLayer>* _theSides[2];
+  std::vector<const TrackerLayer*>* _theSideLayers[2];
+
+  /// The layers of each side, sorted in r and |z|
+  TrackerLayerIndex* _theLayerIndex[2];
+
+  /// Straight-line crossing templates for neutral particles
+  TrackerCrossingTemplates* _theNeutralTemplates;
+
+  /// Module lookup grids of the sensitive layers
+  std::vector<TrackerLayerModuleGrid*> _theModuleGrids;
+
+  /// Material maps of the layers (shared by the layers of both sides)
+  std::vector<TrackerLayerMaterialMap*> _theMaterialMaps;
+
+  /// Misalignments of the sensitive layers
+  std::vector<TrackerLayerMisalignment*> _theMisalignments;
+  double _theMisalignmentMargin;
+
+  /// The region the layers must reach into (cm)
+  double _theRegionMaxRadius;
+  double _theRegionMaxZ;
+
+  /// Single-precision copy of the layer table
+  TrackerCompactLayerTable* _theCompactTable;
+
+  /// The (r,z) voxel grids of each side, and whether they are used 
+  /// for the material budget
+  TrackerMaterialVoxelGrid* _theVoxelGrid[2];
+  bool _useVoxels;
+
+  /// Construction and query profile (0 if not requested)
+  TrackerGeometryProfiler* _theProfiler;
+
   /// Thickness of all layers
   /// Version of the description
   unsigned int version;
@@ -221,8 +447,29 @@ class TrackerInteractionGeometry
   MediumProperties *_theMPEndcapOutside;
   MediumProperties *_theMPEndcapOutside2;
 
+  /// The dead material surfaces built ahead of the layer positions, by 
+  /// layer number - 100 (0 once handed over, or if position dependent)
+  bool _deadMaterialReady;
+  BoundCylinder* _theFixedCylinders[16];
+  BoundDisk* _theFixedDisks[16];
+
+  /// All the distinct media (owned)
   std::vector<MediumProperties *> _mediumProperties;
 
+  /// The distinct materials (media and fudge factors) of the layers
+  TrackerMaterialPalette _thePalette;
+
+  /// Alias tables of the energy loss and of the conversion sharing
+  TrackerMaterialSamplingTables* _theEnergyLossTables;
+  TrackerMaterialSamplingTables* _theConversionTables;
+  TrackerMaterialSamplingTables::LandauEnergyLoss* _theEnergyLossDensity;
+
+  /// Material between the sensitive layer pairs
+  TrackerLayerPairTables* _theLayerPairTables;
+
+  /// Momentum thresholds of the material effects
+  TrackerEffectThresholds* _theEffectThresholds;
+
   //use hardcoded pre-Phase I upgrade tracker geometry or use flexible geometry
   bool use_hardcoded;
 
@@ -0,0 +1,71 @@
+#ifndef FastSimulation_TrackerSetup_TrackerInteractionGeometryView_H
+#define FastSimulation_TrackerSetup_TrackerInteractionGeometryView_H
+
+#include "FastSimulation/TrackerSetup/interface/TrackerInteractionGeometry.h"
+
+#include <vector>
+
+/** A restricted view of the interaction geometry : the layers (of both
+ *  sides) reaching into r < maxRadius and |z| < maxZ, or the sensitive
+ *  layers of a few subdetectors with the dead material they enclose.
+ *  The view only holds pointers to the layers of the geometry, in the
+ *  same inside-to-outside order, so that iterating over it never touches
+ *  the layers outside the region.
+ */
+
+class TrackerInteractionGeometryView {
+
+ public:
+
+  typedef std::vector<const TrackerLayer*>::const_iterator const_iterator;
+
+  /// The layers reaching into a region
+  TrackerInteractionGeometryView(const TrackerInteractionGeometry& geometry,
+				 double maxRadius, 
+				 double maxZ);
+
+  /// The sensitive layers of the given subdetectors (PXB, PXD, TIB, ...),
+  /// and the dead material layers inside their envelope
+  TrackerInteractionGeometryView(const TrackerInteractionGeometry& geometry,
+				 const std::vector<TrackerInteractionGeometry::FirstCylinders>& subDetectors);
+
+  /// The layers of a side in the view
+  inline const_iterator begin(TrackerInteractionGeometry::Side side) const 
+    { return theLayers[side].begin(); }
+  inline const_iterator end(TrackerInteractionGeometry::Side side) const 
+    { return theLayers[side].end(); }
+  inline unsigned size(TrackerInteractionGeometry::Side side) const 
+    { return theLayers[side].size(); }
+  inline const TrackerLayer& layer(TrackerInteractionGeometry::Side side, unsigned i) const 
+    { return *theLayers[side][i]; }
+
+  /// The index of the i-th layer of the view in the full geometry
+  /// (TrackerInteractionGeometry::layer(side,i))
+  inline unsigned geometryIndex(TrackerInteractionGeometry::Side side, unsigned i) const 
+    { return theIndices[side][i]; }
+
+  /// The region of the view
+  inline double maxRadius() const { return theMaxRadius; }
+  inline double maxZ() const { return theMaxZ; }
+
+  /// Does a layer reach into the region of the view ?
+  bool reaches(const TrackerLayer& layer) const;
+
+  /// The subdetector (PXB, PXD, ...) of a sensitive layer number
+  static TrackerInteractionGeometry::FirstCylinders subDetector(unsigned layerNumber);
+
+ private:
+
+  /// Fill the view with the layers passing the selection
+  void fill(const TrackerInteractionGeometry& geometry,
+	    const std::vector<TrackerInteractionGeometry::FirstCylinders>* subDetectors);
+
+ private:
+
+  double theMaxRadius;
+  double theMaxZ;
+  std::vector<const TrackerLayer*> theLayers[2];
+  std::vector<unsigned> theIndices[2];
+
+};
+#endif
@@ -0,0 +1,82 @@
+#ifndef FastSimulation_TrackerSetup_TrackerInteractionProfile_H
+#define FastSimulation_TrackerSetup_TrackerInteractionProfile_H
+
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerStepper.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerCrossingTemplates.h"
+
+#include <vector>
+
+/** The layers crossed by a straight line, with the cumulative material
+ *  (x/X0) in front of each, to sample in one go where the first discrete
+ *  interaction (bremsstrahlung, conversion, nuclear interaction...) takes
+ *  place, if anywhere. Each process is described by its mean free path
+ *  in units of X0 (e.g., 9/7 for conversions). A particle can then jump
+ *  to the layer of its first interaction, or straight out of the tracker,
+ *  with the continuous effects (energy loss, multiple scattering) applied
+ *  for the material in between.
+ *
+ *  For lines from the beam line, the profile is copied from the crossing
+ *  templates of the nearest (eta, z0) grid node, cumulative material 
+ *  included, without any layer intersection.
+ */
+
+class TrackerInteractionProfile {
+
+ public:
+
+  /// An empty profile (no layer crossed)
+  TrackerInteractionProfile() : theCumulative(1,0.) {}
+
+  /// The largest transverse distance (cm) of a vertex from the beam line
+  /// for the crossing templates to be used
+  static const double maxTemplateVertexRadius;
+
+  /// The layers crossed by a line from vertex along direction, from the
+  /// layer firstLayer on (as with TrackerLayerStepper). With firstLayer = 0
+  /// and a vertex on the beam line, from the crossing templates of the 
+  /// geometry (see below) if they exist and cover the line; otherwise 
+  /// with a layer stepper.
+  void fill(const TrackerInteractionGeometry& geometry,
+	    const GlobalPoint& vertex,
+	    const GlobalVector& direction,
+	    unsigned firstLayer=0);
+
+  /// The layers crossed by a line from vertex along direction, from the 
+  /// template of the nearest grid node (the transverse position of the
+  /// vertex is neglected, the fudge factors are averaged over phi). 
+  /// Returns false, with the profile unchanged, if the templates do not 
+  /// cover the line.
+  bool fill(const TrackerCrossingTemplates& templates,
+	    const GlobalPoint& vertex,
+	    const GlobalVector& direction);
+
+  /// Number of layers crossed, and the i-th crossing
+  inline unsigned size() const { return theCrossings.size(); }
+  inline const TrackerLayerStepper::Crossing& crossing(unsigned i) const
+    { return theCrossings[i]; }
+
+  /// Material (x/X0) of the crossings before the i-th one, and in total
+  inline double radLenBefore(unsigned i) const { return theCumulative[i]; }
+  inline double totalRadLen() const { return theCumulative.back(); }
+
+  /// Probability of an interaction of mean free path lambda (in X0)
+  /// up to and including the i-th crossing, and over the whole line
+  double probability(unsigned i, double lambda) const;
+  double probability(double lambda) const;
+
+  /// The crossing of the first interaction among processes of mean free
+  /// paths lambdas (in X0), from two uniform random numbers u and v.
+  /// Returns -1 if the particle leaves the tracker without interacting,
+  /// otherwise the crossing index and the process (index in lambdas).
+  int firstInteraction(double u, double v,
+		       const std::vector<double>& lambdas,
+		       unsigned& process) const;
+
+ private:
+
+  std::vector<TrackerLayerStepper::Crossing> theCrossings;
+  /// theCumulative[i] = x/X0 before crossing i (size()+1 values)
+  std::vector<double> theCumulative;
+
+};
+#endif
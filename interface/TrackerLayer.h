@@ -4,8 +4,14 @@
 #include "DataFormats/GeometrySurface/interface/BoundSurface.h"
 #include "DataFormats/GeometrySurface/interface/BoundCylinder.h"
 #include "DataFormats/GeometrySurface/interface/BoundDisk.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerMaterialMap.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerMisalignment.h"
 
 #include <vector>
+#include <cmath>
+#include <algorithm>
+
+class TrackerLayerModuleGrid;
 
 /** A class that gives some properties of the Tracker Layers in FAMOS
  */
@@ -26,19 +32,33 @@ public:
     theDimensionMinValues(theMinDim),
     theDimensionMaxValues(theMaxDim),
     theFudgeFactors(theFudge),
-    theNumberOfFudgeFactors(theFudgeFactors.size())
+    theNumberOfFudgeFactors(theFudgeFactors.size()),
+    theModuleGrid(0),
+    theMaterialIndex(0),
+    theMaterialMap(0),
+    theMisalignment(0),
+    theTilt(0.),
+    theCosTilt(1.),
+    theSinTilt(0.),
+    theTiltZMin(0.)
    { 
      isSensitive = (theLayerNumber<100);
      if ( isForward ) { 
        theDisk = dynamic_cast<BoundDisk*>(theSurface);
        theDiskInnerRadius = theDisk->innerRadius();
        theDiskOuterRadius = theDisk->outerRadius();
+       theDiskZPosition = theDisk->position().z();
        theCylinder = 0;
+       theCylinderRadius = 0.;
+       theCylinderHalfLength = 0.;
      } else {
        theCylinder = dynamic_cast<BoundCylinder*>(theSurface);
+       theCylinderRadius = theCylinder->radius();
+       theCylinderHalfLength = theCylinder->bounds().length()/2.;
        theDisk = 0;
        theDiskInnerRadius = 0.;
        theDiskOuterRadius = 0.;
+       theDiskZPosition = 0.;
      }
 
    }
@@ -53,19 +73,33 @@ public:
     theDimensionMinValues(theMinDim),
     theDimensionMaxValues(theMaxDim),
     theFudgeFactors(theFudge),
-    theNumberOfFudgeFactors(theFudgeFactors.size())
+    theNumberOfFudgeFactors(theFudgeFactors.size()),
+    theModuleGrid(0),
+    theMaterialIndex(0),
+    theMaterialMap(0),
+    theMisalignment(0),
+    theTilt(0.),
+    theCosTilt(1.),
+    theSinTilt(0.),
+    theTiltZMin(0.)
    { 
      isSensitive = true;
      isForward = true;
      theDisk = dynamic_cast<BoundDisk*>(theSurface);
      theDiskInnerRadius = theDisk->innerRadius();
      theDiskOuterRadius = theDisk->outerRadius();
+     theDiskZPosition = theDisk->position().z();
      theCylinder = 0;
+     theCylinderRadius = 0.;
+     theCylinderHalfLength = 0.;
    }
 
   /// Is the layer sensitive ?
   inline bool sensitive() const { return isSensitive; }
 
+  /// Flag the layer as sensitive or dead (flexible geometry)
+  inline void setSensitive(bool sensitive) { isSensitive = sensitive; }
+
   /// Is the layer forward ?
   inline bool forward() const { return isForward; }
 
@@ -87,6 +121,64 @@ public:
   /// Returns the outer radius of a disk
   inline double diskOuterRadius() const { return theDiskOuterRadius; }
 
+  /// Returns the z position of a disk
+  inline double diskZPosition() const { return theDiskZPosition; }
+
+  /// Returns the radius of a cylinder
+  inline double cylinderRadius() const { return theCylinderRadius; }
+
+  /// Returns the half length of a cylinder
+  inline double cylinderHalfLength() const { return theCylinderHalfLength; }
+
+  /// Returns the thickness of the layer in x/X0 (before fudge factors)
+  inline double radLen() const { return theSurface->mediumProperties().radLen(); }
+
+  /// Returns the module lookup grid of a sensitive layer (0 if none)
+  inline const TrackerLayerModuleGrid* moduleGrid() const { return theModuleGrid; }
+
+  /// Set the module lookup grid (owned by TrackerInteractionGeometry)
+  inline void setModuleGrid(const TrackerLayerModuleGrid* grid) { theModuleGrid = grid; }
+
+  /// The index of the material of the layer in the material palette
+  /// (0 if the palette was not built)
+  inline unsigned short materialIndex() const { return theMaterialIndex; }
+  inline void setMaterialIndex(unsigned short index) { theMaterialIndex = index; }
+
+  /// The (u, phi) map of the material inhomogeneities (0 if none)
+  inline const TrackerLayerMaterialMap* materialMap() const { return theMaterialMap; }
+
+  /// Set the material map (owned by TrackerInteractionGeometry), used
+  /// instead of the fudge factor ranges
+  inline void setMaterialMap(const TrackerLayerMaterialMap* map) { theMaterialMap = map; }
+
+  /// The first-order misalignment of the layer (0 if ideal)
+  inline const TrackerLayerMisalignment* misalignment() const { return theMisalignment; }
+
+  /// Set the misalignment (owned by TrackerInteractionGeometry)
+  inline void setMisalignment(const TrackerLayerMisalignment* misalignment) 
+    { theMisalignment = misalignment; }
+
+  /// The tilt (rad) of the modules of a cylinder in the (r,z) plane, 
+  /// beyond |z| = tiltZMin, towards the interaction point
+  inline double tilt() const { return theTilt; }
+  inline double tiltZMin() const { return theTiltZMin; }
+  inline void setTilt(double tilt, double zMin) { 
+    theTilt = tilt;
+    theCosTilt = std::cos(tilt);
+    theSinTilt = std::sin(tilt);
+    theTiltZMin = zMin;
+  }
+
+  /// The material correction for the crossing angle of a cylinder, for a
+  /// unit direction of components cosRadial along the radius and cosZ 
+  /// along z, at the crossing z : the modules of the tilted rings are seen
+  /// along their own normal
+  inline double cylinderAngle(double cosRadial, double cosZ, double z) const { 
+    if ( theTilt == 0. || std::abs(z) <= theTiltZMin ) return 1./cosRadial;
+    double cosNormal = std::abs(cosRadial*theCosTilt + (z > 0. ? cosZ : -cosZ)*theSinTilt);
+    return 1./std::max(cosNormal,1E-6);
+  }
+
   /// Set a fudge factor for material inhomogeneities in this layer
   /*
   void setFudgeFactor(double min, double max, double f) { 
@@ -109,6 +201,63 @@ public:
     return (iFudge < theNumberOfFudgeFactors) ? theFudgeFactors[iFudge] : 0.;
   }
 
+  /// The fudge factor applicable at a given dimension (|z| for a 
+  /// cylinder, r for a disk), averaged over phi if the layer has a 
+  /// material map
+  inline double fudgeFactorAt(double dim) const { 
+    return theMaterialMap ? theMaterialMap->meanFactor(dim) : rangeFudgeFactorAt(dim);
+  }
+
+  /// Same at a given phi
+  inline double fudgeFactorAt(double dim, double phi) const { 
+    return theMaterialMap ? theMaterialMap->factor(dim,phi) : rangeFudgeFactorAt(dim);
+  }
+
+  /// The factor of the first fudge factor range containing a given 
+  /// dimension (1 if none), as fudgeBinAt
+  inline double rangeFudgeFactorAt(double dim) const { 
+    int iFudge = fudgeBinAt(dim);
+    return iFudge < 0 ? 1. : theFudgeFactors[iFudge];
+  }
+
+  /// The first fudge factor applicable at a given dimension, -1 if none
+  inline int fudgeBinAt(double dim) const { 
+    for ( unsigned iFudge=0; iFudge<theNumberOfFudgeFactors; ++iFudge ) 
+      if ( dim > theDimensionMinValues[iFudge] && dim < theDimensionMaxValues[iFudge] )
+	return iFudge;
+    return -1;
+  }
+
+  /// Crossing of a straight line starting at (0,0,z0) with direction 
+  /// (sinTheta,cosTheta), in coordinates folded to the side of the layer 
+  /// (z -> |z|, so that cosTheta >= 0 for a line going towards the disks).
+  /// Returns false if the layer is not crossed. Otherwise, returns the path 
+  /// length to the crossing, the dimension used by the fudge factors and 
+  /// the material correction for the crossing angle.
+  inline bool straightCrossing(double z0, double sinTheta, double cosTheta,
+			       double& path, double& dim, double& angle) const {
+    if ( isForward ) { 
+      if ( cosTheta <= 0. ) return false;
+      path = (std::abs(theDiskZPosition)-z0)/cosTheta;
+      if ( path <= 0. ) return false;
+      dim = path*sinTheta;
+      angle = 1./cosTheta;
+      return dim >= theDiskInnerRadius && dim <= theDiskOuterRadius;
+    } 
+    if ( sinTheta <= 0. ) return false;
+    path = theCylinderRadius/sinTheta;
+    dim = std::abs(z0+path*cosTheta);
+    angle = cylinderAngle(sinTheta,cosTheta,z0+path*cosTheta);
+    return dim <= theCylinderHalfLength;
+  }
+
+  /// Material (x/X0, fudge factors included) seen by the straight line above
+  inline double straightRadLen(double z0, double sinTheta, double cosTheta) const {
+    double path, dim, angle;
+    if ( !straightCrossing(z0,sinTheta,cosTheta,path,dim,angle) ) return 0.;
+    return radLen() * fudgeFactorAt(dim) * angle;
+  }
+
 private:
 
   BoundSurface* theSurface;
@@ -119,6 +268,9 @@ private:
   bool isSensitive;
   double theDiskInnerRadius;
   double theDiskOuterRadius;
+  double theDiskZPosition;
+  double theCylinderRadius;
+  double theCylinderHalfLength;
 
   /// These are fudges factors to account for the inhomogeneities of the material
   std::vector<double> theDimensionMinValues;
@@ -126,6 +278,24 @@ private:
   std::vector<double> theFudgeFactors;
   unsigned int  theNumberOfFudgeFactors;  
 
+  /// The modules of a sensitive layer, for fast hit-to-module lookup
+  const TrackerLayerModuleGrid* theModuleGrid;
+
+  /// The material of the layer in the material palette
+  unsigned short theMaterialIndex;
+
+  /// The material map of the layer, if any
+  const TrackerLayerMaterialMap* theMaterialMap;
+
+  /// The misalignment of the layer, if any
+  const TrackerLayerMisalignment* theMisalignment;
+
+  /// The tilt of the modules of a cylinder, and where it starts
+  double theTilt;
+  double theCosTilt;
+  double theSinTilt;
+  double theTiltZMin;
+
 };
 #endif
 
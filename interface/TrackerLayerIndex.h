@@ -0,0 +1,107 @@
+#ifndef FastSimulation_TrackerSetup_TrackerLayerIndex_H
+#define FastSimulation_TrackerSetup_TrackerLayerIndex_H
+
+#include <vector>
+
+class TrackerLayer;
+
+/** Cylinders sorted by radius and disks sorted by |z|, to find the layers
+ *  in a region of (r, |z|) without walking the whole nested list. Layers
+ *  are not required to be nested : overlapping layers are found the same
+ *  way. On top of the sorted arrays, two interval trees :
+ *  - a max-tree of the cylinder half lengths (disk outer radii), giving
+ *    the first cylinder (disk) beyond a position that reaches a given
+ *    |z| (r) in O(log N);
+ *  - a segment tree of the disk [inner,outer] radius intervals, each node
+ *    holding the positions of its disks in |z| order, giving the first
+ *    disk beyond |z| that contains a given r in O(log^2 N).
+ *  A straight line then visits the layers it crosses in path order, plus
+ *  the few layers that pass these tests but are not crossed.
+ */
+
+class TrackerLayerIndex {
+
+ public:
+
+  /// Constructor from the layers of one side
+  TrackerLayerIndex(const std::vector<const TrackerLayer*>& layers);
+
+  /// The indices of the layers with a surface in the box
+  /// [rMin,rMax] x [zMin,zMax] (|z|), in no particular order
+  void layers(double rMin, double rMax, double zMin, double zMax,
+	      std::vector<unsigned>& result) const;
+
+  /// The index of the first cylinder outside radius r that covers |z|,
+  /// -1 if none
+  int nextCylinder(double r, double z) const;
+
+  /// The index of the first disk beyond |z| that covers radius r,
+  /// -1 if none
+  int nextDisk(double r, double z) const;
+
+  /// Material (x/X0, fudge factors included, see
+  /// TrackerLayer::straightRadLen) seen by a straight line from (0,0,z0),
+  /// summed over the layers it crosses
+  double straightRadLen(double z0, double sinTheta, double cosTheta) const;
+
+  /// Number of indexed cylinders and disks
+  inline unsigned nCylinders() const { return theCylinderRadius.size(); }
+  inline unsigned nDisks() const { return theDiskZ.size(); }
+
+  /// Positions in the sorted arrays : the first cylinder with a radius
+  /// larger than r, the first disk beyond |z|
+  unsigned cylinderPosition(double r) const;
+  unsigned diskPosition(double z) const;
+
+  /// The first cylinder from position from on with a half length of at
+  /// least z, the first disk from position from on with an outer radius
+  /// of at least r (nCylinders() / nDisks() if none)
+  unsigned firstCylinder(unsigned from, double z) const;
+  unsigned firstDisk(unsigned from, double r) const;
+
+  /// The layer index (in the layers of the side) and the radius of the
+  /// cylinder, or the |z| of the disk, at a position
+  inline unsigned cylinder(unsigned position) const { return theCylinderIndex[position]; }
+  inline double cylinderRadius(unsigned position) const { return theCylinderRadius[position]; }
+  inline unsigned disk(unsigned position) const { return theDiskIndex[position]; }
+  inline double diskZ(unsigned position) const { return theDiskZ[position]; }
+
+ private:
+
+  /// The first leaf from position from on with a value of at least x,
+  /// below a node of a max-tree covering the leaves [low,high)
+  static unsigned firstAtLeast(const std::vector<double>& tree, unsigned node,
+			       unsigned low, unsigned high, unsigned from, double x);
+
+  /// Fill the internal nodes of a max-tree
+  static void buildMaxTree(std::vector<double>& tree, unsigned nLeaves);
+
+ private:
+
+  std::vector<const TrackerLayer*> theLayers;
+
+  /// Cylinders, sorted by radius, and the max-tree of their half lengths
+  std::vector<double> theCylinderRadius;
+  std::vector<double> theCylinderHalfLength;
+  std::vector<unsigned> theCylinderIndex;
+  unsigned theCylinderLeaves;
+  std::vector<double> theCylinderTree;
+
+  /// Disks, sorted by |z|, and the max-tree of their outer radii
+  std::vector<double> theDiskZ;
+  std::vector<double> theDiskInnerRadius;
+  std::vector<double> theDiskOuterRadius;
+  std::vector<unsigned> theDiskIndex;
+  unsigned theDiskLeaves;
+  std::vector<double> theDiskTree;
+
+  /// Segment tree of the disk radius intervals : the sorted distinct
+  /// radii r_k cut the radius axis into pieces (2k for r = r_k, 2k+1 for
+  /// r_k < r < r_k+1), each node holds the sorted positions of the disks
+  /// covering all its pieces
+  std::vector<double> theDiskRadii;
+  unsigned theDiskPieces;
+  std::vector< std::vector<unsigned> > theDiskNodes;
+
+};
+#endif
@@ -0,0 +1,90 @@
+#ifndef FastSimulation_TrackerSetup_TrackerLayerMaterialMap_H
+#define FastSimulation_TrackerSetup_TrackerLayerMaterialMap_H
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+class TrackerLayer;
+
+/** A (u, phi) map of the factors on the x/X0 of a layer (u = |z| for a
+ *  cylinder, r for a disk), to describe the material inhomogeneities
+ *  in phi as well. The factors are stored phi-major in single precision,
+ *  and are found with a clamped bin computation rather than a search.
+ *  The 1D fudge factor ranges of a layer can be converted to a map
+ *  with a single phi bin.
+ */
+
+class TrackerLayerMaterialMap {
+
+ public:
+
+  /// Constructor : nU x nPhi factors (phi-major) over [uMin,uMax] x [-pi,pi]
+  TrackerLayerMaterialMap(unsigned nU, double uMin, double uMax,
+			  unsigned nPhi, const std::vector<float>& factors);
+
+  /// Conversion of the fudge factor ranges of a layer, on nU bins
+  /// over the layer extent (each bin has the mean factor over the bin)
+  TrackerLayerMaterialMap(const TrackerLayer& layer, unsigned nU);
+
+  /// The factor of the bin containing (u, phi)
+  inline float factor(double u, double phi) const {
+    return theFactors[iPhi(phi)*theNU+iU(u)];
+  }
+
+  /// The factor averaged over phi, for the bin containing u
+  inline float meanFactor(double u) const { return theMeanFactors[iU(u)]; }
+
+  /// Bilinear interpolation between the bin centers (periodic in phi)
+  float interpolated(double u, double phi) const;
+
+  /// The factors of the bins of n points
+  void factors(unsigned n, const float* u, const float* phi, float* result) const;
+
+  /// Number of bins, and range in u
+  inline unsigned nU() const { return theNU; }
+  inline unsigned nPhi() const { return theNPhi; }
+  inline double uMin() const { return theUMin; }
+  inline double uMax() const { return theUMax; }
+
+  /// The factors, phi-major
+  inline const std::vector<float>& values() const { return theFactors; }
+
+  /// Read maps from a binary file ("TKMMAP01", then for each map :
+  /// layer number, nU, nPhi as unsigned, uMin, uMax and the nU*nPhi
+  /// factors as float). The maps are owned by the caller.
+  static void read(const std::string& fileName,
+		   std::vector<unsigned>& layerNumbers,
+		   std::vector<TrackerLayerMaterialMap*>& maps);
+
+ private:
+
+  inline unsigned iU(double u) const {
+    int i = static_cast<int>((u-theUMin)*theInvUStep);
+    return std::min(std::max(i,0),theLastU);
+  }
+
+  inline unsigned iPhi(double phi) const {
+    int i = static_cast<int>((phi+M_PI)*theInvPhiStep);
+    return std::min(std::max(i,0),theLastPhi);
+  }
+
+  /// Factors averaged over phi
+  void fillMeanFactors();
+
+ private:
+
+  unsigned theNU;
+  unsigned theNPhi;
+  int theLastU;
+  int theLastPhi;
+  double theUMin;
+  double theUMax;
+  double theInvUStep;
+  double theInvPhiStep;
+  std::vector<float> theFactors;
+  std::vector<float> theMeanFactors;
+
+};
+#endif
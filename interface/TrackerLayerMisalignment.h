@@ -0,0 +1,45 @@
+#ifndef FastSimulation_TrackerSetup_TrackerLayerMisalignment_H
+#define FastSimulation_TrackerSetup_TrackerLayerMisalignment_H
+
+/** Small offsets (cm) and tilts (rad) of a layer, applied to first order :
+ *  the layer is shifted by (dx,dy,dz) and rotated by tiltX (tiltY) around
+ *  the x (y) axis through (dx,dy,zCenter+dz), where zCenter is 0 for a
+ *  cylinder and the z of a disk. A straight line is brought into the
+ *  frame of the ideal layer, where the ideal intersection is used. The
+ *  values are in the coordinates folded to the side of the layer.
+ */
+
+struct TrackerLayerMisalignment {
+
+  double dx, dy, dz;
+  double tiltX, tiltY;
+  double zCenter;
+
+  /// The same misalignment seen from the other side (z -> -z)
+  inline TrackerLayerMisalignment folded() const {
+    TrackerLayerMisalignment result = *this;
+    result.dz = -dz;
+    result.tiltX = -tiltX;
+    result.tiltY = -tiltY;
+    result.zCenter = -zCenter;
+    return result;
+  }
+
+  /// A line (point and direction) in the frame of the ideal layer
+  inline void toLayer(double& x, double& y, double& z,
+		      double& ux, double& uy, double& uz) const {
+    double vx = x-dx;
+    double vy = y-dy;
+    double vz = z-zCenter-dz;
+    x = vx - tiltY*vz;
+    y = vy + tiltX*vz;
+    z = vz - tiltX*vy + tiltY*vx + zCenter;
+    double wx = ux - tiltY*uz;
+    double wy = uy + tiltX*uz;
+    uz = uz - tiltX*uy + tiltY*ux;
+    ux = wx;
+    uy = wy;
+  }
+
+};
+#endif
@@ -0,0 +1,65 @@
+#ifndef FastSimulation_TrackerSetup_TrackerLayerModuleGrid_H
+#define FastSimulation_TrackerSetup_TrackerLayerModuleGrid_H
+
+#include "DataFormats/GeometryVector/interface/GlobalPoint.h"
+
+#include <vector>
+
+class GeomDet;
+
+/** A (phi, z) grid for barrel layers, or a (phi, r) grid for forward
+ *  layers, giving the modules of a sensitive layer that may contain a
+ *  given crossing point. Each cell holds the few modules overlapping it,
+ *  so that finding the module of a crossing only needs a cell lookup and
+ *  one or two local checks.
+ */
+
+class TrackerLayerModuleGrid {
+
+ public:
+
+  /// Constructor : the modules of a layer, nPhi x nU cells (u = z or r)
+  TrackerLayerModuleGrid(const std::vector<const GeomDet*>& modules,
+			 bool isForward,
+			 unsigned nPhi,
+			 unsigned nU);
+
+  /// The module containing the (projected) crossing point, 0 if none
+  const GeomDet* module(const GlobalPoint& point) const;
+
+  /// The candidate modules of the cell containing a given point
+  void candidates(const GlobalPoint& point,
+		  std::vector<const GeomDet*>& result) const;
+
+  /// Number of modules in the layer
+  inline unsigned nModules() const { return theModules.size(); }
+
+  /// Largest number of candidate modules in a cell
+  unsigned maxCandidates() const;
+
+ private:
+
+  /// The cell containing a given point (-1 if outside the grid)
+  int cell(const GlobalPoint& point) const;
+
+  inline double u(const GlobalPoint& point) const {
+    return isForward ? point.perp() : point.z();
+  }
+
+ private:
+
+  std::vector<const GeomDet*> theModules;
+  bool isForward;
+  unsigned theNPhi;
+  unsigned theNU;
+  double thePhiStep;
+  double theUMin;
+  double theUMax;
+  double theUStep;
+
+  /// Module indices of cell i are [theOffsets[i],theOffsets[i+1])
+  std::vector<unsigned> theOffsets;
+  std::vector<unsigned> theIndices;
+
+};
+#endif
@@ -0,0 +1,84 @@
+#ifndef FastSimulation_TrackerSetup_TrackerLayerPairTables_H
+#define FastSimulation_TrackerSetup_TrackerLayerPairTables_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+class TrackerLayer;
+
+/** The material between two sensitive layers (numbered below 100), for
+ *  straight lines from the nominal vertex, as a function of eta : x/X0
+ *  of the first layer and of all the layers (sensitive or dead) crossed
+ *  before the second one, and the multiple scattering coefficient of
+ *  that material, c = 13.6 MeV sqrt(x/X0) (1 + 0.038 ln(x/X0)), so that
+ *  the scattering angle is c/(p beta). The tables of a triplet (a,b,c)
+ *  are those of the pairs (a,b) and (b,c). Seeding windows are thus
+ *  found without walking through the layers.
+ */
+
+class TrackerLayerPairTables {
+
+ public:
+
+  /// Constructor from the layers of each side, with nEta bins in [0,etaMax]
+  TrackerLayerPairTables(const std::vector<const TrackerLayer*>& positiveLayers,
+			 const std::vector<const TrackerLayer*>& negativeLayers,
+			 unsigned nEta, double etaMax);
+
+  /// x/X0 between the sensitive layers of numbers a and b at a given
+  /// eta, -1 if the line does not cross a, then b
+  inline float radLen(unsigned a, unsigned b, double eta) const {
+    unsigned i = index(a,b,eta);
+    return i == NotFound ? -1.f : theRadLen[i];
+  }
+
+  /// The multiple scattering coefficient (GeV) of the same material,
+  /// 0 if the line does not cross a, then b
+  inline float scatteringCoefficient(unsigned a, unsigned b, double eta) const {
+    unsigned i = index(a,b,eta);
+    return i == NotFound ? 0.f : theCoefficient[i];
+  }
+
+  /// Number of sensitive layers (per side), and size in memory (bytes)
+  inline unsigned nSensitive() const { return theNSensitive; }
+  inline unsigned size() const {
+    return (theRadLen.size()+theCoefficient.size())*sizeof(float);
+  }
+
+ private:
+
+  enum { NotFound = 0xFFFFFFFF, MaxLayerNumber = 100 };
+
+  /// The table entry of a pair of layer numbers at eta
+  inline unsigned index(unsigned a, unsigned b, double eta) const {
+    if ( a >= MaxLayerNumber || b >= MaxLayerNumber ) return NotFound;
+    unsigned side = eta < 0.;
+    int iA = theSensitiveIndex[side][a];
+    int iB = theSensitiveIndex[side][b];
+    if ( iA < 0 || iB < 0 ) return NotFound;
+    int iEta = static_cast<int>(std::abs(eta)*theInvEtaStep);
+    iEta = std::min(iEta,static_cast<int>(theNEta)-1);
+    unsigned i = ((side*theNSensitive+iA)*theNSensitive+iB)*theNEta+iEta;
+    return theRadLen[i] < 0.f ? NotFound : i;
+  }
+
+  /// Fill the tables of a side
+  void fill(unsigned side, const std::vector<const TrackerLayer*>& layers);
+
+ private:
+
+  unsigned theNEta;
+  double theEtaStep;
+  double theInvEtaStep;
+  unsigned theNSensitive;
+
+  /// Index of each sensitive layer number in the tables (-1 if none)
+  std::vector<int> theSensitiveIndex[2];
+
+  /// (side, a, b, eta), eta fastest
+  std::vector<float> theRadLen;
+  std::vector<float> theCoefficient;
+
+};
+#endif
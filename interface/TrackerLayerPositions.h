@@ -0,0 +1,95 @@
+#ifndef FastSimulation_TrackerSetup_TrackerLayerPositions_H
+#define FastSimulation_TrackerSetup_TrackerLayerPositions_H
+
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerMisalignment.h"
+#include "DataFormats/GeometryVector/interface/GlobalPoint.h"
+
+#include <vector>
+#include <string>
+
+class GeometricSearchTracker;
+
+namespace edm { 
+  class ParameterSet;
+}
+
+/** The few numbers of the tracker geometry needed by the hardcoded 
+ *  interaction geometry : radius and length of each barrel layer, inner
+ *  and outer radii and z of each forward layer (both sides). 
+ *  They are taken either from the reco geometry, or from a configuration 
+ *  snapshot of the ideal geometry (the producer refuses it for a labelled,
+ *  e.g. misaligned, geometry). The snapshot is a stopgap : it is not read 
+ *  from the geometry or alignment records, it has the negative side 
+ *  mirrored from the positive side, and it goes stale when the geometry 
+ *  changes. The producer compares it with the reco geometry (maxDifference)
+ *  unless checkLayerPositions is switched off.
+ */
+
+class TrackerLayerPositions {
+
+ public:
+
+  /// Constructor from the reco geometry. The first-order misalignment 
+  /// is fitted to its module positions against those of the ideal 
+  /// geometry, if given (none otherwise).
+  TrackerLayerPositions(const GeometricSearchTracker& geomSearchTracker,
+			const GeometricSearchTracker* idealGeomSearchTracker=0);
+
+  /// Constructor from a configuration snapshot
+  TrackerLayerPositions(const edm::ParameterSet& layerPositions);
+
+  /// Barrel layers, inside to outside
+  inline unsigned nBarrelLayers() const { return theBarrelRadius.size(); }
+  inline double barrelRadius(unsigned i) const { return theBarrelRadius[i]; }
+  inline double barrelLength(unsigned i) const { return theBarrelLength[i]; }
+
+  /// Forward layers of a side (0 = positive z, 1 = negative z), by |z|
+  inline unsigned nForwardLayers() const { return theForwardZ[0].size(); }
+  inline double forwardInnerRadius(unsigned side, unsigned i) const 
+    { return theForwardInnerRadius[side][i]; }
+  inline double forwardOuterRadius(unsigned side, unsigned i) const 
+    { return theForwardOuterRadius[side][i]; }
+  inline double forwardZ(unsigned side, unsigned i) const 
+    { return theForwardZ[side][i]; }
+
+  /// First-order misalignment of the layers, fitted to the module 
+  /// positions of the reco geometry (in the coordinates of the tracker, 
+  /// not folded). Not available from a configuration snapshot.
+  inline bool hasMisalignment() const { return !theBarrelMisalignment.empty(); }
+  inline const TrackerLayerMisalignment& barrelMisalignment(unsigned i) const 
+    { return theBarrelMisalignment[i]; }
+  inline const TrackerLayerMisalignment& forwardMisalignment(unsigned side, unsigned i) const 
+    { return theForwardMisalignment[side][i]; }
+
+  /// Set the misalignment of all the layers by hand (e.g., a random one 
+  /// for studies), barrel layers first, then the forward layers of each side
+  void setMisalignment(const std::vector<TrackerLayerMisalignment>& barrel,
+		       const std::vector<TrackerLayerMisalignment>& positiveForward,
+		       const std::vector<TrackerLayerMisalignment>& negativeForward);
+
+  /// The misalignment of a barrel layer (of a forward layer at z), fitted
+  /// to the displacements of its modules from their ideal positions. 
+  /// The ideal positions themselves give no misalignment.
+  static TrackerLayerMisalignment fitBarrelMisalignment(const std::vector<GlobalPoint>& ideal,
+							const std::vector<GlobalPoint>& misaligned);
+  static TrackerLayerMisalignment fitForwardMisalignment(const std::vector<GlobalPoint>& ideal,
+							 const std::vector<GlobalPoint>& misaligned,
+							 double z);
+
+  /// The largest difference (cm) of the radii, lengths and z positions 
+  /// with other layer positions, and the layer where it is found. 
+  /// Throws if the numbers of layers differ.
+  double maxDifference(const TrackerLayerPositions& other, std::string& where) const;
+
+ private:
+
+  std::vector<double> theBarrelRadius;
+  std::vector<double> theBarrelLength;
+  std::vector<double> theForwardInnerRadius[2];
+  std::vector<double> theForwardOuterRadius[2];
+  std::vector<double> theForwardZ[2];
+  std::vector<TrackerLayerMisalignment> theBarrelMisalignment;
+  std::vector<TrackerLayerMisalignment> theForwardMisalignment[2];
+
+};
+#endif
@@ -0,0 +1,116 @@
+#ifndef FastSimulation_TrackerSetup_TrackerLayerStepper_H
+#define FastSimulation_TrackerSetup_TrackerLayerStepper_H
+
+#include "FastSimulation/TrackerSetup/interface/TrackerInteractionGeometry.h"
+#include "DataFormats/GeometryVector/interface/GlobalPoint.h"
+#include "DataFormats/GeometryVector/interface/GlobalVector.h"
+
+class TrackerCrossingRecorder;
+
+/** The walk of a straight outgoing line through the layers of one side of
+ *  the interaction geometry, one crossing at a time. The whole state of the
+ *  walk is held by the stepper (a small value, no heap allocation), so that
+ *  many walks can be interleaved, suspended (e.g., to create secondaries 
+ *  at a crossing) and resumed later by calling next() again. Secondaries
+ *  start a stepper of their own at the crossing point, from the next layer.
+ *
+ *  The candidate layers come from the layer index of the side : the next
+ *  cylinder long enough to reach the current |z|, and the next disk large
+ *  enough to reach the current radius. The crossings are returned in path 
+ *  order, also for overlapping (non-nested) layers.
+ */
+
+class TrackerLayerStepper {
+
+ public:
+
+  /// A layer crossing
+  struct Crossing { 
+    /// Index of the layer in TrackerInteractionGeometry::layer(side,i)
+    unsigned short layer;
+    /// Crossing point
+    GlobalPoint position;
+    /// Path length from the start of the walk (cm)
+    double path;
+    /// Material (x/X0) seen at the crossing, fudge factors and crossing
+    /// angle included
+    double radLen;
+  };
+
+  /// Constructor : a line from vertex along direction, walking through the
+  /// layers of the side of the direction with an index of at least 
+  /// firstLayer. The crossings are also given to the recorder, if any.
+  TrackerLayerStepper(const TrackerInteractionGeometry& geometry,
+		      const GlobalPoint& vertex,
+		      const GlobalVector& direction,
+		      unsigned firstLayer=0,
+		      TrackerCrossingRecorder* recorder=0);
+
+  /// Move to the next crossing. Returns false when the walk is over.
+  bool next(Crossing& crossing);
+
+  /// Is the walk over ?
+  inline bool done() const { 
+    return theCylinder.position >= theNCylinders && theDisk.position >= theNDisks; 
+  }
+
+  /// The side of the walk
+  inline TrackerInteractionGeometry::Side side() const { return theSide; }
+
+  /// Path length from the start to the last crossing (cm)
+  inline double path() const { return thePath; }
+
+  /// Walk through the ideal layers, ignoring their misalignment
+  inline void ignoreMisalignment() { isIdeal = true; }
+
+ private:
+
+  /// The next crossed cylinder or disk (position in the layer index, 
+  /// nCylinders() or nDisks() if none), and its crossing
+  struct Candidate { 
+    unsigned position;
+    double t, dim, angle;
+    bool found;
+  };
+
+  /// Find the next crossed cylinder, or disk, from its current position
+  void nextCylinder();
+  void nextDisk();
+
+  /// The smallest radius of the line from path t on
+  double minRadius(double t) const;
+
+  /// The crossing of the line with a layer, if any, to first order in
+  /// the misalignment of the layer
+  bool crossing(const TrackerLayer& layer, double& t, double& dim, double& angle) const;
+
+  /// The crossing of a line with an ideal layer
+  static bool crossing(const TrackerLayer& layer, 
+		       double x, double y, double z, 
+		       double dx, double dy, double dz,
+		       double& t, double& dim, double& angle);
+
+ private:
+
+  const TrackerInteractionGeometry* theGeometry;
+  const TrackerLayerIndex* theIndex;
+  TrackerInteractionGeometry::Side theSide;
+  unsigned theFirstLayer;
+  unsigned theNCylinders;
+  unsigned theNDisks;
+  Candidate theCylinder;
+  Candidate theDisk;
+  /// Lower bounds of the |z| and radius of the line ahead, and the margin
+  /// taken on them for misaligned layers
+  double theZLower;
+  double theRLower;
+  double theMargin;
+  /// Start and unit direction, z folded to the side of the walk
+  double theX, theY, theZ;
+  double theDX, theDY, theDZ;
+  double thePath;
+  TrackerCrossingRecorder* theRecorder;
+  bool isIdeal;
+
+};
+#endif
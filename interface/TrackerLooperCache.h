@@ -0,0 +1,75 @@
+#ifndef FastSimulation_TrackerSetup_TrackerLooperCache_H
+#define FastSimulation_TrackerSetup_TrackerLooperCache_H
+
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerStepper.h"
+
+#include <cmath>
+#include <vector>
+
+/** The cylinder crossings of one turn of a helix, for low-pT particles
+ *  curling inside the tracker. The transverse circle of the helix meets
+ *  the same cylinders at the same turning angles at each turn : only z
+ *  moves along, by 2 pi dz/dphi per turn. The crossings of any later
+ *  turn are replayed from the cached ones (turning angle, crossing angle,
+ *  path length), with the fudge factors of the new z, until the helix
+ *  reaches a disk or the z = 0 plane, or until its radius (energy loss)
+ *  changes beyond a given tolerance.
+ *
+ *  The helix point at turning angle a >= 0 is
+ *  (xc + R cos(phi0 + q a), yc + R sin(phi0 + q a), z0 + a dz/dphi).
+ */
+
+class TrackerLooperCache {
+
+ public:
+
+  /// Constructor from the helix parameters (q = +1 counter-clockwise, -1
+  /// clockwise), with the layers of the side of z0
+  TrackerLooperCache(const TrackerInteractionGeometry& geometry,
+		     double xc, double yc, double radius,
+		     double phi0, int q,
+		     double z0, double dzdphi);
+
+  /// Number of cylinder crossings per turn
+  inline unsigned size() const { return theCrossings.size(); }
+
+  /// Number of full turns over which the cached sequence is valid
+  unsigned nTurns() const;
+
+  /// Is the sequence still valid for a helix of a given radius ?
+  inline bool valid(double radius, double tolerance) const {
+    return std::abs(radius-theRadius) <= tolerance*theRadius;
+  }
+
+  /// The crossings of the k-th turn (k = 0 for the first one), with the
+  /// path length from the start of the helix
+  void turn(unsigned k, std::vector<TrackerLayerStepper::Crossing>& result) const;
+
+ private:
+
+  /// A cached crossing
+  struct Crossing {
+    /// Index of the layer in TrackerInteractionGeometry::layer(side,i)
+    unsigned short layer;
+    /// Turning angle in [0,2 pi)
+    double angle;
+    /// x/X0 at the crossing, crossing angle included, fudge factors not
+    double radLen;
+  };
+
+ private:
+
+  const TrackerInteractionGeometry* theGeometry;
+  TrackerInteractionGeometry::Side theSide;
+  double theXC, theYC, theRadius;
+  double thePhi0;
+  int theQ;
+  double theZ0, theDZDPhi;
+  /// Path length per unit turning angle
+  double thePathPerAngle;
+  /// Turning angle up to which the sequence is valid
+  double theMaxAngle;
+  std::vector<Crossing> theCrossings;
+
+};
+#endif
@@ -0,0 +1,61 @@
+#ifndef FastSimulation_TrackerSetup_TrackerMaterialPalette_H
+#define FastSimulation_TrackerSetup_TrackerMaterialPalette_H
+
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerMaterialMap.h"
+
+#include <vector>
+
+class TrackerLayer;
+
+/** The distinct materials of the tracker layers : a material is a radiation
+ *  length (x/X0) and a set of fudge factor ranges, or a material map. Many 
+ *  layers share the same material, so that the palette is small (a few 
+ *  tens of entries, at most one per layer) and each layer only needs a 
+ *  two-byte index into it.
+ */
+
+class TrackerMaterialPalette {
+
+ public:
+
+  /// The index of the material of a layer, added to the palette if new
+  unsigned short add(const TrackerLayer& layer);
+
+  /// Number of materials
+  inline unsigned size() const { return theRadLen.size(); }
+
+  /// x/X0 of all materials
+  inline const std::vector<float>& radLens() const { return theRadLen; }
+  inline float radLen(unsigned short i) const { return theRadLen[i]; }
+
+  /// The material map of a material (0 if none)
+  inline const TrackerLayerMaterialMap* materialMap(unsigned short i) const { return theMaterialMap[i]; }
+
+  /// x/X0 of a material at a given dimension (|z| for a cylinder, r for 
+  /// a disk), first fudge factor (or the map, averaged over phi) included
+  inline float radLenAt(unsigned short i, float dim) const { 
+    if ( theMaterialMap[i] ) return theRadLen[i] * theMaterialMap[i]->meanFactor(dim);
+    for ( unsigned iFudge=theFudgeOffsets[i]; iFudge<theFudgeOffsets[i+1]; ++iFudge ) 
+      if ( dim > theFudgeMin[iFudge] && dim < theFudgeMax[iFudge] ) 
+	return theRadLen[i] * theFudgeFactor[iFudge];
+    return theRadLen[i];
+  }
+
+  /// Number of fudge factor ranges of a material
+  inline unsigned fudgeNumber(unsigned short i) const { 
+    return theFudgeOffsets[i+1]-theFudgeOffsets[i];
+  }
+
+ private:
+
+  std::vector<float> theRadLen;
+  /// A layer with a map has a material of its own (maps are not compared)
+  std::vector<const TrackerLayerMaterialMap*> theMaterialMap;
+  /// The ranges of material i are [theFudgeOffsets[i],theFudgeOffsets[i+1])
+  std::vector<unsigned short> theFudgeOffsets;
+  std::vector<float> theFudgeMin;
+  std::vector<float> theFudgeMax;
+  std::vector<float> theFudgeFactor;
+
+};
+#endif
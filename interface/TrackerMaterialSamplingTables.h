@@ -0,0 +1,113 @@
+#ifndef FastSimulation_TrackerSetup_TrackerMaterialSamplingTables_H
+#define FastSimulation_TrackerSetup_TrackerMaterialSamplingTables_H
+
+#include "FastSimulation/TrackerSetup/interface/TrackerAliasTable.h"
+
+#include <boost/thread/mutex.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/** Alias tables of a density that depends on the material thickness
+ *  (x/X0) and on the energy, for each material of the palette, binned in
+ *  crossing-angle correction (1/cos of the incidence, in [1,maxAngle])
+ *  and in log(energy). The set of materials is small and fixed once the
+ *  geometry is built, so that all the tables are computed at once (in
+ *  a few threads), and each sample then costs two random numbers.
+ */
+
+class TrackerMaterialSamplingTables {
+
+ public:
+
+  /// A density in x, for a thickness (x/X0) and an energy (GeV)
+  class Density {
+  public:
+    virtual ~Density() {}
+    virtual double operator()(double x, double thickness, double energy) const = 0;
+    /// The range of x for a thickness and an energy
+    virtual void range(double thickness, double energy, double& xMin, double& xMax) const = 0;
+  };
+
+  /// The energy loss of a charged particle of a given mass in silicon, in
+  /// units of the Landau width xi, from the most probable loss : Moyal
+  /// approximation of the Landau density, cut at the maximum energy
+  /// transfer to an electron
+  class LandauEnergyLoss : public Density {
+  public:
+    LandauEnergyLoss(double mass) : theMass(mass) {}
+    virtual double operator()(double lambda, double thickness, double energy) const;
+    virtual void range(double thickness, double energy, double& xMin, double& xMax) const;
+    /// The Landau width xi (GeV)
+    double xi(double thickness, double energy) const;
+    /// The most probable energy loss (GeV)
+    double mostProbableLoss(double thickness, double energy) const;
+    /// The energy loss (GeV) of a sample lambda of the density
+    double energyLoss(double lambda, double thickness, double energy) const;
+  private:
+    double theMass;
+  };
+
+  /// The energy fraction of the electron of a photon conversion
+  /// (Bethe-Heitler, complete screening), within the kinematic limits
+  class ConversionSharing : public Density {
+  public:
+    virtual double operator()(double x, double thickness, double energy) const;
+    virtual void range(double thickness, double energy, double& xMin, double& xMax) const;
+  };
+
+  /// Constructor : the tables of a density for materials of given
+  /// thicknesses, built in nThreads threads
+  TrackerMaterialSamplingTables(const std::vector<float>& thicknesses,
+				unsigned nAngle, double maxAngle,
+				unsigned nEnergy, double energyMin, double energyMax,
+				unsigned nBins,
+				const Density& density,
+				unsigned nThreads);
+
+  /// The table of the bin closest to a material, angle correction and energy
+  inline const TrackerAliasTable& table(unsigned material, double angle, double energy) const {
+    int iAngle = static_cast<int>((angle-1.)*theInvAngleStep);
+    int iEnergy = static_cast<int>(std::log(energy/theEnergyMin)*theInvLogEnergyStep);
+    iAngle = std::min(std::max(iAngle,0),static_cast<int>(theNAngle)-1);
+    iEnergy = std::min(std::max(iEnergy,0),static_cast<int>(theNEnergy)-1);
+    return theTables[(material*theNAngle+iAngle)*theNEnergy+iEnergy];
+  }
+
+  /// A sample of the density, from two uniform random numbers
+  inline double sample(unsigned material, double angle, double energy,
+		       double u, double v) const {
+    return table(material,angle,energy).sample(u,v);
+  }
+
+  /// Number of tables, and size in memory (bytes)
+  inline unsigned nTables() const { return theTables.size(); }
+  unsigned size() const;
+
+ private:
+
+  /// The loop of a worker thread
+  void work(const Density* density);
+
+ private:
+
+  std::vector<float> theThicknesses;
+  unsigned theNAngle;
+  double theAngleStep;
+  double theInvAngleStep;
+  unsigned theNEnergy;
+  double theEnergyMin;
+  double theLogEnergyStep;
+  double theInvLogEnergyStep;
+  unsigned theNBins;
+
+  /// Tables, (material, angle, energy) with energy fastest
+  std::vector<TrackerAliasTable> theTables;
+
+  /// The next table to build, shared by the worker threads
+  unsigned theNextTable;
+  boost::mutex theMutex;
+
+};
+#endif
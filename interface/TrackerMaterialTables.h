@@ -0,0 +1,97 @@
+#ifndef FastSimulation_TrackerSetup_TrackerMaterialTables_H
+#define FastSimulation_TrackerSetup_TrackerMaterialTables_H
+
+// Generated by scripts/generateTrackerMaterialTables.py from
+// python/TrackerMaterial_cfi.py : do not edit.
+
+namespace TrackerMaterialTables {
+
+  /// Digest of the tables, as computed by trackerMaterialDigest()
+  static const char digest[] = "b5aa93bc46705747d239972af73c21a9";
+
+  /// Number of material versions, and of fudge factors
+  static const unsigned nVersions = 5;
+  static const unsigned nFudges = 86;
+
+  /// Names of the tables, in digest order (the fudge factors last)
+  static const unsigned nTables = 69;
+  static const char* const tableNames[nTables] = { "BeamPipeThickness", "PXBThickness", "PXB1CablesThickness", "PXB2CablesThickness", "PXB3CablesThickness", "PXBOutCables1Thickness", "PXBOutCables2Thickness", "PXDThickness", "PXDOutCables1Thickness", "PXDOutCables2Thickness", "TIBLayer1Thickness", "TIBLayer2Thickness", "TIBLayer3Thickness", "TIBLayer4Thickness", "TIBOutCables1Thickness", "TIBOutCables2Thickness", "TIDLayer1Thickness", "TIDLayer2Thickness", "TIDLayer3Thickness", "TIDOutsideThickness", "TOBInsideThickness", "TOBLayer1Thickness", "TOBLayer2Thickness", "TOBLayer3Thickness", "TOBLayer4Thickness", "TOBLayer5Thickness", "TOBLayer6Thickness", "TOBOutsideThickness", "TECLayerThickness", "BarrelCablesThickness", "EndcapCables1Thickness", "EndcapCables2Thickness", "BeamPipeRadius", "BeamPipeLength", "PXB1CablesInnerRadius", "PXB2CablesInnerRadius", "PXB3CablesInnerRadius", "PXBOutCables1InnerRadius", "PXBOutCables1OuterRadius", "PXBOutCables1ZPosition", "PXBOutCables2InnerRadius", "PXBOutCables2OuterRadius", "PXBOutCables2ZPosition", "PixelOutCablesRadius", "PixelOutCablesLength", "PixelOutCablesInnerRadius", "PixelOutCablesOuterRadius", "PixelOutCablesZPosition", "TIBOutCables1InnerRadius", "TIBOutCables1OuterRadius", "TIBOutCables1ZPosition", "TIBOutCables2InnerRadius", "TIBOutCables2OuterRadius", "TIBOutCables2ZPosition", "TOBInCablesRadius", "TOBInCablesLength", "TIDOutCablesInnerRadius", "TIDOutCablesZPosition", "TOBOutCablesInnerRadius", "TOBOutCablesOuterRadius", "TOBOutCablesZPosition", "TOBOutCablesRadius", "TOBOutCablesLength", "TECOutCables1InnerRadius", "TECOutCables1OuterRadius", "TECOutCables1ZPosition", "TECOutCables2InnerRadius", "TECOutCables2OuterRadius", "TECOutCables2ZPosition" };
+  static const char* const fudgeNames[4] = { "FudgeLayer", "FudgeMin", "FudgeMax", "FudgeFactor" };
+
+  static const double BeamPipeThickness[nVersions] = { 0.0038, 0.00265, 0.00265, 0.00265, 0.0024 };
+  static const double PXBThickness[nVersions] = { 0.0222, 0.0217, 0.0217, 0.0217, 0.0217 };
+  static const double PXB1CablesThickness[nVersions] = { 0.1, 0.042, 0.042, 0.0, 0.0 };
+  static const double PXB2CablesThickness[nVersions] = { 0.04, 0.042, 0.042, 0.0, 0.0 };
+  static const double PXB3CablesThickness[nVersions] = { 0.03, 0.042, 0.042, 0.0, 0.0 };
+  static const double PXBOutCables1Thickness[nVersions] = { 0.04, 0.04, 0.04, 0.04, 0.04 };
+  static const double PXBOutCables2Thickness[nVersions] = { 0.025, 0.015, 0.015, 0.012, 0.012 };
+  static const double PXDThickness[nVersions] = { 0.044, 0.058, 0.058, 0.058, 0.058 };
+  static const double PXDOutCables1Thickness[nVersions] = { 0.023, 0.034, 0.034, 0.05, 0.05 };
+  static const double PXDOutCables2Thickness[nVersions] = { 0.085, 0.185, 0.25, 0.25, 0.25 };
+  static const double TIBLayer1Thickness[nVersions] = { 0.06, 0.053, 0.053, 0.053, 0.053 };
+  static const double TIBLayer2Thickness[nVersions] = { 0.047, 0.053, 0.053, 0.053, 0.053 };
+  static const double TIBLayer3Thickness[nVersions] = { 0.035, 0.035, 0.035, 0.035, 0.035 };
+  static const double TIBLayer4Thickness[nVersions] = { 0.033, 0.04, 0.04, 0.04, 0.04 };
+  static const double TIBOutCables1Thickness[nVersions] = { 0.04, 0.108, 0.108, 0.13, 0.13 };
+  static const double TIBOutCables2Thickness[nVersions] = { 0.04, 0.0, 0.0, 0.0, 0.0 };
+  static const double TIDLayer1Thickness[nVersions] = { 0.05, 0.04, 0.04, 0.04, 0.04 };
+  static const double TIDLayer2Thickness[nVersions] = { 0.05, 0.04, 0.04, 0.04, 0.04 };
+  static const double TIDLayer3Thickness[nVersions] = { 0.05, 0.055, 0.055, 0.055, 0.055 };
+  static const double TIDOutsideThickness[nVersions] = { 0.07, 0.074, 0.074, 0.074, 0.074 };
+  static const double TOBInsideThickness[nVersions] = { 0.017, 0.009, 0.009, 0.009, 0.009 };
+  static const double TOBLayer1Thickness[nVersions] = { 0.044, 0.03, 0.03, 0.03, 0.03 };
+  static const double TOBLayer2Thickness[nVersions] = { 0.044, 0.03, 0.03, 0.03, 0.03 };
+  static const double TOBLayer3Thickness[nVersions] = { 0.033, 0.022, 0.022, 0.022, 0.022 };
+  static const double TOBLayer4Thickness[nVersions] = { 0.033, 0.022, 0.022, 0.022, 0.022 };
+  static const double TOBLayer5Thickness[nVersions] = { 0.033, 0.022, 0.022, 0.022, 0.022 };
+  static const double TOBLayer6Thickness[nVersions] = { 0.033, 0.022, 0.022, 0.022, 0.022 };
+  static const double TOBOutsideThickness[nVersions] = { 0.09, 0.15, 0.15, 0.15, 0.15 };
+  static const double TECLayerThickness[nVersions] = { 0.041, 0.045, 0.045, 0.05, 0.05 };
+  static const double BarrelCablesThickness[nVersions] = { 0.1, 0.038, 0.038, 0.042, 0.042 };
+  static const double EndcapCables1Thickness[nVersions] = { 0.26, 0.21, 0.21, 0.21, 0.21 };
+  static const double EndcapCables2Thickness[nVersions] = { 0.08, 0.0, 0.0, 0.0, 0.0 };
+  static const double BeamPipeRadius[nVersions] = { 3.0, 3.0, 3.0, 3.0, 3.0 };
+  static const double BeamPipeLength[nVersions] = { 26.4, 28.3, 28.3, 28.3, 28.3 };
+  static const double PXB1CablesInnerRadius[nVersions] = { 3.6, 3.7, 3.7, 3.7, 3.7 };
+  static const double PXB2CablesInnerRadius[nVersions] = { 6.1, 6.3, 6.3, 6.3, 6.3 };
+  static const double PXB3CablesInnerRadius[nVersions] = { 8.5, 9.0, 9.0, 9.0, 9.0 };
+  static const double PXBOutCables1InnerRadius[nVersions] = { 11.9, 11.9, 11.9, 4.2, 4.2 };
+  static const double PXBOutCables1OuterRadius[nVersions] = { 15.5, 15.5, 15.5, 16.5, 16.5 };
+  static const double PXBOutCables1ZPosition[nVersions] = { 27.999, 28.799, 28.799, 28.799, 28.799 };
+  static const double PXBOutCables2InnerRadius[nVersions] = { 3.8, 3.8, 3.8, 3.8, 3.8 };
+  static const double PXBOutCables2OuterRadius[nVersions] = { 16.5, 16.5, 16.5, 16.5, 16.5 };
+  static const double PXBOutCables2ZPosition[nVersions] = { 28.0, 28.8, 28.8, 28.8, 28.8 };
+  static const double PixelOutCablesRadius[nVersions] = { 17.1, 17.5, 17.5, 17.5, 17.5 };
+  static const double PixelOutCablesLength[nVersions] = { 64.8, 72.0, 72.0, 65.0, 65.0 };
+  static const double PixelOutCablesInnerRadius[nVersions] = { 3.0, 3.0, 7.197, 7.2, 6.5 };
+  static const double PixelOutCablesOuterRadius[nVersions] = { 17.3, 17.61, 17.61, 17.61, 17.61 };
+  static const double PixelOutCablesZPosition[nVersions] = { 64.9, 72.1, 72.1, 65.1, 65.1 };
+  static const double TIBOutCables1InnerRadius[nVersions] = { 22.5, 22.5, 22.5, 22.5, 22.5 };
+  static const double TIBOutCables1OuterRadius[nVersions] = { 53.9, 53.9, 53.9, 53.9, 53.9 };
+  static const double TIBOutCables1ZPosition[nVersions] = { 75.001, 74.0, 74.0, 74.0, 74.0 };
+  static const double TIBOutCables2InnerRadius[nVersions] = { 35.5, 35.5, 35.5, 35.5, 35.5 };
+  static const double TIBOutCables2OuterRadius[nVersions] = { 53.901, 53.901, 53.901, 53.901, 53.901 };
+  static const double TIBOutCables2ZPosition[nVersions] = { 75.001, 74.001, 74.001, 74.001, 74.001 };
+  static const double TOBInCablesRadius[nVersions] = { 54.5, 54.5, 54.6, 54.6, 54.6 };
+  static const double TOBInCablesLength[nVersions] = { 108.2, 108.2, 108.2, 108.2, 108.2 };
+  static const double TIDOutCablesInnerRadius[nVersions] = { 32.0, 22.0, 22.0, 22.0, 22.0 };
+  static const double TIDOutCablesZPosition[nVersions] = { 108.0, 108.0, 108.0, 108.0, 108.0 };
+  static const double TOBOutCablesInnerRadius[nVersions] = { 55.0, 55.0, 55.0, 55.0, 55.0 };
+  static const double TOBOutCablesOuterRadius[nVersions] = { 109.5, 111.0, 111.0, 111.0, 111.0 };
+  static const double TOBOutCablesZPosition[nVersions] = { 110.0, 115.0, 115.0, 115.0, 115.0 };
+  static const double TOBOutCablesRadius[nVersions] = { 119.5, 119.5, 119.5, 119.5, 119.5 };
+  static const double TOBOutCablesLength[nVersions] = { 299.9, 299.9, 299.9, 299.9, 299.9 };
+  static const double TECOutCables1InnerRadius[nVersions] = { 6.0, 30.0, 4.42, 4.42, 4.42 };
+  static const double TECOutCables1OuterRadius[nVersions] = { 120.001, 120.001, 120.001, 120.001, 120.001 };
+  static const double TECOutCables1ZPosition[nVersions] = { 300.0, 300.0, 300.0, 300.0, 300.0 };
+  static const double TECOutCables2InnerRadius[nVersions] = { 70.0, 68.0, 68.0, 68.0, 68.0 };
+  static const double TECOutCables2OuterRadius[nVersions] = { 120.001, 120.001, 120.001, 120.001, 120.001 };
+  static const double TECOutCables2ZPosition[nVersions] = { 300.0, 300.0, 300.0, 300.0, 300.0 };
+
+  static const unsigned FudgeLayer[nFudges] = { 104, 104, 104, 104, 104, 104, 104, 106, 106, 107, 107, 107, 6, 7, 8, 9, 10, 11, 12, 110, 110, 111, 111, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15, 15, 15, 16, 16, 16, 16, 17, 17, 17, 17, 18, 18, 18, 18, 112, 112, 112, 19, 19, 19, 20, 20, 20, 21, 21, 21, 22, 22, 22, 23, 23, 23, 24, 24, 24, 25, 25, 26, 26, 27, 27, 113, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114, 114 };
+  static const double FudgeMin[nFudges] = { 0.0, 4.2, 5.1, 7.1, 8.2, 10.0, 11.0, 0.0, 27.5, 0.0, 10.0, 16.0, 35.0, 35.0, 35.0, 35.0, 34.0, 34.0, 34.0, 47.5, 22.0, 27.5, 72.0, 0.0, 18.0, 36.0, 55.0, 0.0, 18.0, 36.0, 55.0, 0.0, 18.0, 36.0, 55.0, 0.0, 18.0, 36.0, 55.0, 0.0, 18.0, 36.0, 55.0, 0.0, 18.0, 36.0, 55.0, 55.0, 62.0, 78.0, 0.0, 24.0, 34.0, 0.0, 24.0, 34.0, 0.0, 24.0, 34.0, 0.0, 32.0, 41.0, 0.0, 32.0, 41.0, 0.0, 32.0, 41.0, 0.0, 32.0, 0.0, 32.0, 0.0, 32.0, 120.0, 4.42, 4.65, 4.84, 7.37, 10.99, 14.7, 16.24, 22.0, 28.5, 31.5, 36.0 };
+  static const double FudgeMax[nFudges] = { 4.2, 5.1, 7.1, 8.2, 10.0, 11.0, 11.9, 27.5, 32.0, 10.0, 11.0, 18.0, 68.0, 68.0, 68.0, 68.0, 42.0, 42.0, 42.0, 54.0, 24.0, 30.5, 110.0, 18.0, 30.0, 46.0, 108.0, 18.0, 30.0, 46.0, 108.0, 18.0, 30.0, 46.0, 108.0, 18.0, 30.0, 46.0, 108.0, 18.0, 30.0, 46.0, 108.0, 18.0, 30.0, 46.0, 108.0, 60.0, 78.0, 92.0, 24.0, 34.0, 39.0, 24.0, 34.0, 39.0, 24.0, 34.0, 39.0, 32.0, 40.0, 46.0, 32.0, 40.0, 46.0, 32.0, 40.0, 46.0, 32.0, 60.0, 32.0, 60.0, 32.0, 60.0, 301.0, 4.65, 4.84, 7.37, 10.99, 14.7, 16.24, 22.0, 28.5, 31.5, 36.0, 120.0 };
+  static const double FudgeFactor[nFudges] = { 0.0, 2.5, 0.0, 2.7, 0.0, 2.8, 0.5, 0.27, 1.9, 1.6, 1.3, 0.7, 1.45, 1.45, 1.45, 1.45, 2.0, 2.0, 2.0, 2.5, 1.5, 4.0, 5.5, 0.7, 2.0, 2.0, 2.0, 0.7, 2.0, 2.0, 2.0, 0.7, 2.0, 2.0, 2.0, 0.7, 2.0, 2.0, 2.0, 0.7, 2.0, 2.0, 2.0, 0.7, 2.0, 2.0, 2.0, 0.5, 1.5, 1.8, 2.0, 0.8, 1.6, 2.0, 0.8, 1.6, 2.0, 0.8, 1.6, 2.3, 0.6, 1.4, 2.3, 0.6, 1.4, 2.5, 0.6, 1.4, 2.7, 0.6, 3.0, 0.6, 3.0, 0.6, 3.8, 18.74, 2.3, 0.604, 0.424, 0.327, 0.591, 7.0, 4.4, 3.3, 1.4, 1.6 };
+
+}
+#endif
@@ -0,0 +1,52 @@
+#ifndef FastSimulation_TrackerSetup_TrackerMaterialVoxelGrid_H
+#define FastSimulation_TrackerSetup_TrackerMaterialVoxelGrid_H
+
+#include <vector>
+
+class TrackerLayer;
+
+/** The layers of one side rasterized into a fixed (r, z) grid of x/X0
+ *  per cm, in the coordinates folded to that side (a cylinder covers
+ *  both signs of z, a disk only z > 0). A straight line from the beam
+ *  axis is a straight line in (r, z), so that its material budget is
+ *  found by walking the cells it crosses (2D DDA): the cost scales with
+ *  the number of cells crossed rather than with the number of layers.
+ *  The layer material is spread over the cell containing the surface,
+ *  so that a line crossing the whole cell sees the material of the
+ *  layer at its incidence angle.
+ */
+
+class TrackerMaterialVoxelGrid {
+
+ public:
+
+  /// Constructor from the layers of one side, with nR x nZ cells
+  /// over [0,rMax] x [-zMax,zMax]
+  TrackerMaterialVoxelGrid(const std::vector<const TrackerLayer*>& layers,
+			   unsigned nR, double rMax,
+			   unsigned nZ, double zMax);
+
+  /// Material (x/X0) seen by a straight line from (0,0,z0) with
+  /// direction (sinTheta,cosTheta), in the folded coordinates.
+  /// Optionally returns the number of cells walked through.
+  double materialBudget(double z0, double sinTheta, double cosTheta,
+			unsigned* nCells=0) const;
+
+  /// Number of cells, and size in memory (bytes)
+  inline unsigned nCells() const { return theDensity.size(); }
+  inline unsigned size() const { return theDensity.size()*sizeof(float); }
+
+ private:
+
+  unsigned theNR;
+  unsigned theNZ;
+  double theRMax;
+  double theZMax;
+  double theRStep;
+  double theZStep;
+
+  /// x/X0 per cm, r-major : cell (iR,iZ) is iR*theNZ+iZ
+  std::vector<float> theDensity;
+
+};
+#endif
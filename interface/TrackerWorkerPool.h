@@ -0,0 +1,74 @@
+#ifndef FastSimulation_TrackerSetup_TrackerWorkerPool_H
+#define FastSimulation_TrackerSetup_TrackerWorkerPool_H
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <exception>
+#include <string>
+
+/** Runs a job in a few worker threads (in the calling thread if there
+ *  is only one), the job taking its work items from a shared counter
+ *  until none is left. An exception escaping a thread would end the
+ *  whole program, so the workers catch them : the first one is thrown
+ *  again in the calling thread once all the workers have returned.
+ */
+
+class TrackerWorkerPool {
+
+ public:
+
+  /// Constructor : the number of threads (0 is taken as 1)
+  TrackerWorkerPool(unsigned nThreads) : theNThreads(nThreads ? nThreads : 1), theFailed(false) {}
+
+  /// Run a job in every thread
+  void run(const boost::function<void ()>& job) {
+    if ( theNThreads == 1 ) {
+      job();
+      return;
+    }
+    theFailed = false;
+    theError.clear();
+    boost::thread_group threads;
+    for ( unsigned iThread=0; iThread<theNThreads; ++iThread )
+      threads.create_thread(boost::bind(&TrackerWorkerPool::guard,this,job));
+    threads.join_all();
+    if ( theFailed )
+      throw cms::Exception("FastSimulation/TrackerWorkerPool")
+	<< "A worker thread failed : " << theError;
+  }
+
+ private:
+
+  /// The loop of a worker thread
+  void guard(boost::function<void ()> job) {
+    try {
+      job();
+    } catch ( std::exception& e ) {
+      fail(e.what());
+    } catch ( ... ) {
+      fail("unknown exception");
+    }
+  }
+
+  /// Keep the first error
+  void fail(const std::string& what) {
+    boost::mutex::scoped_lock lock(theMutex);
+    if ( theFailed ) return;
+    theFailed = true;
+    theError = what;
+  }
+
+ private:
+
+  unsigned theNThreads;
+  bool theFailed;
+  std::string theError;
+  boost::mutex theMutex;
+
+};
+#endif
@@ -1,33 +1,223 @@
 #include "FastSimulation/TrackerSetup/plugins/TrackerInteractionGeometryESProducer.h"
 #include "RecoTracker/Record/interface/TrackerRecoGeometryRecord.h"
+#include "RecoTracker/TkDetLayers/interface/GeometricSearchTracker.h"
 
 #include "FWCore/Framework/interface/ESHandle.h"
 #include "FWCore/Framework/interface/ModuleFactory.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <exception>
 #include <memory>
 
 TrackerInteractionGeometryESProducer::TrackerInteractionGeometryESProducer(const edm::ParameterSet & p) 
 {
     setWhatProduced(this);
+    setWhatProduced(this,&TrackerInteractionGeometryESProducer::produceLayerPositions);
     _label = p.getUntrackedParameter<std::string>("trackerGeometryLabel","");
+    _dataLabel = p.existsAs<std::string>("appendToDataLabel") ? 
+      p.getParameter<std::string>("appendToDataLabel") : "";
 
     theTrackerMaterial = p.getParameter<edm::ParameterSet>("TrackerMaterial");
 
+    // Each label writes its own trace, and profiles the reco geometry and 
+    // the extraction of the layer positions too
+    if ( theTrackerMaterial.getUntrackedParameter<bool>("profiling",false) ) { 
+      std::string traceFile = theTrackerMaterial.getUntrackedParameter<std::string>("profiling_trace_file","");
+      theTrackerMaterial.addUntrackedParameter<std::string>("profiling_trace_file",
+							     TrackerGeometryProfiler::traceFile(traceFile,_dataLabel));
+      _profiler.reset(new TrackerGeometryProfiler(0,""));
+    }
+
+    // The active layer positions : from the reco geometry (default), 
+    // or from a configuration snapshot (no GeometricSearchTracker built).
+    // The snapshot is a stopgap until the positions are read from the 
+    // geometry records : it is the ideal geometry only, and is checked 
+    // against the reco geometry unless told otherwise.
+    std::string source = p.getUntrackedParameter<std::string>("layerPositionsSource","RecoGeometry");
+    _positionsFromReco = source == "RecoGeometry";
+    if ( !_positionsFromReco ) { 
+      if ( source != "Configuration" ) 
+	throw cms::Exception("FastSimulation/TrackerInteractionGeometryESProducer") 
+	  << "Unknown layerPositionsSource " << source 
+	  << " (should be RecoGeometry or Configuration)";
+      if ( !_label.empty() ) 
+	throw cms::Exception("FastSimulation/TrackerInteractionGeometryESProducer") 
+	  << "layerPositionsSource Configuration is a snapshot of the ideal geometry :"
+	  << " it cannot stand for the " << _label << " tracker geometry (use RecoGeometry)";
+      theLayerPositions = p.getParameter<edm::ParameterSet>("LayerPositions");
+    }
+    _checkPositions = !_positionsFromReco && p.getUntrackedParameter<bool>("checkLayerPositions",true);
+    _positionsTolerance = p.getUntrackedParameter<double>("layerPositionsTolerance",0.01);
+
+    // When the geometry does not depend on the reco geometry (flexible 
+    // geometry, or layer positions from the configuration), it can be built 
+    // in a background thread while the rest of the job is set up. Otherwise
+    // the part that does not depend on the layer positions (material tables,
+    // media, fixed dead material) is prepared in the background while the 
+    // reco geometry is built. Each label has its own producer, hence its 
+    // own thread.
+    bool use_hardcoded = theTrackerMaterial.getParameter<bool>("use_hardcoded_geometry");
+    _needsReco = use_hardcoded && 
+      ( _positionsFromReco || theTrackerMaterial.getUntrackedParameter<bool>("module_grids",false) );
+    if ( p.getUntrackedParameter<bool>("concurrentBuild",false) ) 
+      _thread.reset(new boost::thread(boost::bind(&TrackerInteractionGeometryESProducer::buildInBackground,this)));
+
 }
 
-TrackerInteractionGeometryESProducer::~TrackerInteractionGeometryESProducer() {}
+TrackerInteractionGeometryESProducer::~TrackerInteractionGeometryESProducer() {
+  if ( _thread ) _thread->join();
+}
 
-boost::shared_ptr<TrackerInteractionGeometry> 
-TrackerInteractionGeometryESProducer::produce(const TrackerInteractionGeometryRecord & iRecord){ 
+void 
+TrackerInteractionGeometryESProducer::buildInBackground() { 
+
+  // Exceptions cannot cross the thread boundary : keep the message
+  try { 
+    if ( _needsReco ) { 
+      _prebuilt = boost::shared_ptr<TrackerInteractionGeometry>
+	(new TrackerInteractionGeometry(theTrackerMaterial));
+    } else if ( theTrackerMaterial.getParameter<bool>("use_hardcoded_geometry") ) { 
+      TrackerLayerPositions thePositions(theLayerPositions);
+      _prebuilt = boost::shared_ptr<TrackerInteractionGeometry>
+	(new TrackerInteractionGeometry(theTrackerMaterial,&thePositions));
+    } else { 
+      _prebuilt = boost::shared_ptr<TrackerInteractionGeometry>
+	(new TrackerInteractionGeometry(theTrackerMaterial,
+					static_cast<const TrackerLayerPositions*>(0)));
+    }
+  } catch ( std::exception& e ) { 
+    _backgroundError = e.what();
+  } catch ( ... ) { 
+    _backgroundError = "Unknown exception";
+  }
+
+}
+
+void 
+TrackerInteractionGeometryESProducer::waitForBackground() { 
+
+  _thread->join();
+  _thread.reset();
+  if ( !_backgroundError.empty() ) 
+    throw cms::Exception("FastSimulation/TrackerInteractionGeometryESProducer") 
+      << "The concurrent construction of the interaction geometry failed : "
+      << _backgroundError;
+
+}
+
+boost::shared_ptr<TrackerLayerPositions> 
+TrackerInteractionGeometryESProducer::produceLayerPositions(const TrackerInteractionGeometryRecord & iRecord){ 
+
+  if ( !_positionsFromReco ) { 
+    { 
+      TrackerGeometryProfiler::Scope scope(_profiler.get(),"layer positions from the configuration");
+      _positions = boost::shared_ptr<TrackerLayerPositions>
+	(new TrackerLayerPositions(theLayerPositions));
+    }
+    if ( _checkPositions ) checkLayerPositions(iRecord,*_positions);
+    return _positions;
+  }
+
+  // The misalignment is fitted against the ideal geometry (none for
+  // the ideal geometry itself)
+  edm::ESHandle<GeometricSearchTracker> theGeomSearchTracker;
+  edm::ESHandle<GeometricSearchTracker> theIdealGeomSearchTracker;
+  bool misaligned = !_label.empty() && theTrackerMaterial.getParameter<bool>("first_order_misalignment");
+  { 
+    TrackerGeometryProfiler::Scope scope(_profiler.get(),"reco geometry");
+    iRecord.getRecord<TrackerRecoGeometryRecord>().get(_label, theGeomSearchTracker );
+    if ( misaligned ) 
+      iRecord.getRecord<TrackerRecoGeometryRecord>().get(theIdealGeomSearchTracker);
+  }
+  TrackerGeometryProfiler::Scope scope(_profiler.get(),"active layer extraction");
+  _positions = boost::shared_ptr<TrackerLayerPositions>
+    (new TrackerLayerPositions(*theGeomSearchTracker,
+			       misaligned ? &(*theIdealGeomSearchTracker) : 0));
+  return _positions;
 
+}
+
+void
+TrackerInteractionGeometryESProducer::checkLayerPositions(const TrackerInteractionGeometryRecord & iRecord,
+							  const TrackerLayerPositions & thePositions) { 
+
+  TrackerGeometryProfiler::Scope scope(_profiler.get(),"layer position check");
   edm::ESHandle<GeometricSearchTracker> theGeomSearchTracker;
-  
   iRecord.getRecord<TrackerRecoGeometryRecord>().get(_label, theGeomSearchTracker );
-  _tracker = boost::shared_ptr<TrackerInteractionGeometry>
-    (new TrackerInteractionGeometry(theTrackerMaterial,&(*theGeomSearchTracker)));
+  TrackerLayerPositions recoPositions(*theGeomSearchTracker);
+  std::string where;
+  double diff = thePositions.maxDifference(recoPositions,where);
+  if ( diff > _positionsTolerance ) 
+    throw cms::Exception("FastSimulation/TrackerInteractionGeometryESProducer") 
+      << "The configuration snapshot of the layer positions differs from the reco geometry by " 
+      << diff << " cm (tolerance " << _positionsTolerance << " cm) for the " << where 
+      << " (snapshot/reco) : update TrackerLayerPositions_cfi.py";
+  edm::LogInfo("TrackerInteractionGeometry") 
+    << "Layer positions from the configuration agree with the reco geometry within " 
+    << diff << " cm";
+
+}
+
+boost::shared_ptr<TrackerInteractionGeometry> 
+TrackerInteractionGeometryESProducer::produce(const TrackerInteractionGeometryRecord & iRecord){ 
+
+  // The layer positions first : with the reco geometry, it is built 
+  // while the background thread (if any) prepares the rest.
+  // The flexible geometry does not need any active layer position.
+  bool use_hardcoded = theTrackerMaterial.getParameter<bool>("use_hardcoded_geometry");
+  const TrackerLayerPositions* thePositions = 0;
+  edm::ESHandle<TrackerLayerPositions> theLayerPositions;
+  if ( use_hardcoded ) { 
+    iRecord.get(_dataLabel, theLayerPositions);
+    thePositions = &(*theLayerPositions);
+  }
+
+  // The geometry built in the background is used for the first IOV only
+  if ( _thread ) waitForBackground();
+  if ( _prebuilt && !_needsReco ) { 
+    _tracker = _prebuilt;
+    _prebuilt.reset();
+    addProfile();
+    return _tracker;
+  }
+
+  if ( _prebuilt ) { 
+    _tracker = _prebuilt;
+    _prebuilt.reset();
+    _tracker->build(theTrackerMaterial,thePositions);
+  } else { 
+    _tracker = boost::shared_ptr<TrackerInteractionGeometry>
+      (new TrackerInteractionGeometry(theTrackerMaterial,thePositions));
+  }
+
+  // The module lookup grids need the full reco geometry
+  if ( use_hardcoded && theTrackerMaterial.getUntrackedParameter<bool>("module_grids",false) ) { 
+    edm::ESHandle<GeometricSearchTracker> theGeomSearchTracker;
+    iRecord.getRecord<TrackerRecoGeometryRecord>().get(_label, theGeomSearchTracker );
+    _tracker->buildModuleGrids(&(*theGeomSearchTracker),
+			       theTrackerMaterial.getUntrackedParameter<unsigned>("module_grids_phi_bins",128),
+			       theTrackerMaterial.getUntrackedParameter<unsigned>("module_grids_u_bins",32),
+			       theTrackerMaterial.getUntrackedParameter<unsigned>("module_grids_threads",4));
+  }
+
+  addProfile();
   return _tracker;
 
 }
 
+void
+TrackerInteractionGeometryESProducer::addProfile() { 
+
+  // The phases of this IOV only
+  if ( !_profiler || !_tracker->profiler() ) return;
+  _profiler->summarizeConstruction();
+  _tracker->profiler()->add(*_profiler);
+  _profiler.reset(new TrackerGeometryProfiler(0,""));
+
+}
+
 
 DEFINE_FWK_EVENTSETUP_MODULE(TrackerInteractionGeometryESProducer);
@@ -5,18 +5,54 @@
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FastSimulation/TrackerSetup/interface/TrackerInteractionGeometryRecord.h"
 #include "FastSimulation/TrackerSetup/interface/TrackerInteractionGeometry.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerPositions.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerGeometryProfiler.h"
 #include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <string>
 
+namespace boost { 
+  class thread;
+}
+
 class  TrackerInteractionGeometryESProducer: public edm::ESProducer{
  public:
   TrackerInteractionGeometryESProducer(const edm::ParameterSet & p);
   virtual ~TrackerInteractionGeometryESProducer(); 
   boost::shared_ptr<TrackerInteractionGeometry> produce(const TrackerInteractionGeometryRecord &);
+  boost::shared_ptr<TrackerLayerPositions> produceLayerPositions(const TrackerInteractionGeometryRecord &);
+ private:
+  /// Build the geometry in a background thread, started at construction
+  void buildInBackground();
+  /// Wait for the background thread, and rethrow its exception if any
+  void waitForBackground();
+  /// Compare the layer positions of the configuration with the reco 
+  /// geometry, and throw if they differ
+  void checkLayerPositions(const TrackerInteractionGeometryRecord &,
+			   const TrackerLayerPositions &);
+  /// Add the phases profiled by the producer to the profile of the 
+  /// geometry, which writes the trace
+  void addProfile();
  private:
   boost::shared_ptr<TrackerInteractionGeometry> _tracker;
+  boost::shared_ptr<TrackerLayerPositions> _positions;
   std::string _label;
+  std::string _dataLabel;
+  bool _positionsFromReco;
+  bool _checkPositions;
+  double _positionsTolerance;
   edm::ParameterSet theTrackerMaterial;
+  edm::ParameterSet theLayerPositions;
+  /// The geometry built ahead of the first produce() call, if any 
+  /// (only prepared, without the layer positions, if it needs the reco
+  /// geometry)
+  bool _needsReco;
+  boost::scoped_ptr<boost::thread> _thread;
+  boost::shared_ptr<TrackerInteractionGeometry> _prebuilt;
+  std::string _backgroundError;
+  /// The phases timed before the geometry is created (reco geometry, 
+  /// active layer extraction), added to the profile of the geometry
+  boost::scoped_ptr<TrackerGeometryProfiler> _profiler;
 };
 
 
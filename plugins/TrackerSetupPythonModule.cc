@@ -0,0 +1,222 @@
+// Python bindings of the interaction geometry, for material-tuning studies.
+// The geometry is built from the configuration only (layer positions from
+// a snapshot, see TrackerLayerPositions_cfi.py), and its single-precision
+// layer table is exposed without copy, as read-only memory buffers. See 
+// python/TrackerGeometryTable.py for the NumPy interface. This is a library
+// of its own (libFastSimulationTrackerSetupPython), so that the package 
+// library does not depend on Python.
+
+// Python.h first
+#include <boost/python.hpp>
+
+#include "FastSimulation/TrackerSetup/interface/TrackerInteractionGeometry.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerPositions.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerCompactLayerTable.h"
+
+#include "FWCore/PythonParameterSet/interface/PythonParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace { 
+
+  // The exporter of a read-only buffer over memory owned by another Python
+  // object (the geometry), which it keeps alive : the memoryviews, and the
+  // arrays made from them, hold a reference to the exporter
+  struct ColumnBuffer { 
+    PyObject_HEAD
+    PyObject* owner;
+    void* data;
+    Py_ssize_t size;
+  };
+
+  int getColumnBuffer(PyObject* self, Py_buffer* view, int flags) { 
+    ColumnBuffer* column = reinterpret_cast<ColumnBuffer*>(self);
+    return PyBuffer_FillInfo(view,self,column->data,column->size,1,flags);
+  }
+
+  void deleteColumnBuffer(PyObject* self) { 
+    Py_XDECREF(reinterpret_cast<ColumnBuffer*>(self)->owner);
+    PyObject_Del(self);
+  }
+
+  PyBufferProcs columnBufferProcs;
+  PyTypeObject columnBufferType = { PyVarObject_HEAD_INIT(NULL,0) };
+
+  void registerColumnBuffer() { 
+    columnBufferProcs.bf_getbuffer = getColumnBuffer;
+    columnBufferType.tp_name = "libFastSimulationTrackerSetupPython.ColumnBuffer";
+    columnBufferType.tp_basicsize = sizeof(ColumnBuffer);
+    columnBufferType.tp_dealloc = deleteColumnBuffer;
+    columnBufferType.tp_as_buffer = &columnBufferProcs;
+#if PY_MAJOR_VERSION >= 3
+    columnBufferType.tp_flags = Py_TPFLAGS_DEFAULT;
+#else
+    columnBufferType.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_NEWBUFFER;
+#endif
+    if ( PyType_Ready(&columnBufferType) < 0 ) boost::python::throw_error_already_set();
+  }
+
+  // A read-only memoryview over a column of the layer table of owner
+  template <class T> 
+  boost::python::object buffer(const std::vector<T>& column, boost::python::object owner) { 
+    ColumnBuffer* exporter = PyObject_New(ColumnBuffer,&columnBufferType);
+    if ( !exporter ) boost::python::throw_error_already_set();
+    exporter->owner = boost::python::incref(owner.ptr());
+    exporter->data = column.empty() ? 0 : const_cast<T*>(&column[0]);
+    exporter->size = column.size()*sizeof(T);
+    boost::python::handle<> theExporter(reinterpret_cast<PyObject*>(exporter));
+    return boost::python::object(boost::python::handle<>(PyMemoryView_FromObject(theExporter.get())));
+  }
+
+  // A contiguous array of doubles given by Python (e.g., a NumPy array)
+  class DoubleArray { 
+  public:
+    DoubleArray(boost::python::object array, bool writable) { 
+      int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+      if ( PyObject_GetBuffer(array.ptr(),&theView,flags) < 0 ) 
+	boost::python::throw_error_already_set();
+      if ( !theView.format || std::string(theView.format) != "d" ) { 
+	PyBuffer_Release(&theView);
+	PyErr_SetString(PyExc_TypeError,"Expected a contiguous array of float64");
+	boost::python::throw_error_already_set();
+      }
+    }
+    ~DoubleArray() { PyBuffer_Release(&theView); }
+    inline unsigned size() const { return theView.len/sizeof(double); }
+    inline double* data() const { return static_cast<double*>(theView.buf); }
+  private:
+    Py_buffer theView;
+  };
+
+  class PythonTrackerGeometry { 
+
+  public:
+
+    PythonTrackerGeometry(PythonParameterSet& trackerMaterial,
+			  PythonParameterSet& layerPositions) : 
+      thePositions(new TrackerLayerPositions(layerPositions.pset())),
+      theGeometry(new TrackerInteractionGeometry(trackerMaterial.pset(),thePositions.get()))
+    { 
+      // The layer table of the geometry if it was built, otherwise our own
+      if ( !theGeometry->compactLayerTable() ) { 
+	std::vector<const TrackerLayer*> layers[2];
+	for ( unsigned side=0; side<2; ++side ) { 
+	  TrackerInteractionGeometry::Side theSide = static_cast<TrackerInteractionGeometry::Side>(side);
+	  for ( int i=0; i<theGeometry->nCylinders(theSide); ++i ) 
+	    layers[side].push_back(&theGeometry->layer(theSide,i));
+	}
+	theTable.reset(new TrackerCompactLayerTable(layers[0],layers[1]));
+      }
+    }
+
+    const TrackerCompactLayerTable& table() const { 
+      return theTable ? *theTable : *theGeometry->compactLayerTable();
+    }
+
+    unsigned nLayers(unsigned side) const { return table().nLayers(side); }
+
+    /// The columns of the layer table, by name. The buffers keep the Python
+    /// geometry self (hence the table) alive.
+    static boost::python::object column(boost::python::object self, 
+					const std::string& name, unsigned side) { 
+      if ( side > 1 ) { 
+	PyErr_SetString(PyExc_IndexError,"side must be 0 (positive z) or 1 (negative z)");
+	boost::python::throw_error_already_set();
+      }
+      const TrackerCompactLayerTable& t = 
+	boost::python::extract<const PythonTrackerGeometry&>(self)().table();
+      if ( name == "layerNumber" ) return buffer(t.layerNumbers(side),self);
+      if ( name == "forward" ) return buffer(t.forward(side),self);
+      if ( name == "position" ) return buffer(t.positions(side),self);
+      if ( name == "low" ) return buffer(t.lows(side),self);
+      if ( name == "high" ) return buffer(t.highs(side),self);
+      if ( name == "radLen" ) return buffer(t.radLens(side),self);
+      if ( name == "fudgeOffset" ) return buffer(t.fudgeOffsets(side),self);
+      if ( name == "fudgeMin" ) return buffer(t.fudgeMins(side),self);
+      if ( name == "fudgeMax" ) return buffer(t.fudgeMaxs(side),self);
+      if ( name == "fudgeFactor" ) return buffer(t.fudgeFactors(side),self);
+      PyErr_SetString(PyExc_KeyError,name.c_str());
+      boost::python::throw_error_already_set();
+      return boost::python::object();
+    }
+
+    /// The material budget of straight lines, result[i] for (eta[i], z0[i])
+    void materialBudget(boost::python::object eta, 
+			boost::python::object z0,
+			boost::python::object result) const { 
+      DoubleArray theEta(eta,false), theZ0(z0,false), theResult(result,true);
+      checkSizes(theEta,theZ0,theResult,theEta.size());
+      for ( unsigned i=0; i<theEta.size(); ++i ) 
+	theResult.data()[i] = theGeometry->materialBudget(theEta.data()[i],theZ0.data()[i]);
+    }
+
+    /// The path lengths of straight lines to the layers of their side,
+    /// result[i*nLayers+j] for (eta[i], z0[i]) and layer j of the side of 
+    /// eta[i] (NaN if not crossed, or beyond the layers of that side); 
+    /// nLayers is the larger of the two sides
+    void crossings(boost::python::object eta, 
+		   boost::python::object z0,
+		   boost::python::object result) const { 
+      DoubleArray theEta(eta,false), theZ0(z0,false), theResult(result,true);
+      unsigned nLayers = std::max(theGeometry->nCylinders(TrackerInteractionGeometry::PositiveZ),
+				  theGeometry->nCylinders(TrackerInteractionGeometry::NegativeZ));
+      checkSizes(theEta,theZ0,theResult,theEta.size()*nLayers);
+      double path, dim, angle;
+      for ( unsigned i=0; i<theEta.size(); ++i ) { 
+	TrackerInteractionGeometry::Side side = TrackerInteractionGeometry::side(theEta.data()[i]);
+	double sign = 1.-2.*side;
+	double theta = 2.*std::atan(std::exp(-sign*theEta.data()[i]));
+	double sinTheta = std::sin(theta);
+	double cosTheta = std::cos(theta);
+	unsigned nSide = theGeometry->nCylinders(side);
+	for ( unsigned j=0; j<nLayers; ++j ) { 
+	  bool crossed = j < nSide && 
+	    theGeometry->layer(side,j).straightCrossing(sign*theZ0.data()[i],sinTheta,cosTheta,path,dim,angle);
+	  theResult.data()[i*nLayers+j] = crossed ? path : NAN;
+	}
+      }
+    }
+
+  private:
+
+    static void checkSizes(const DoubleArray& eta, const DoubleArray& z0, 
+			   const DoubleArray& result, unsigned resultSize) { 
+      if ( z0.size() != eta.size() || result.size() != resultSize ) { 
+	PyErr_SetString(PyExc_ValueError,"Inconsistent array sizes");
+	boost::python::throw_error_already_set();
+      }
+    }
+
+  private:
+
+    boost::shared_ptr<TrackerLayerPositions> thePositions;
+    boost::shared_ptr<TrackerInteractionGeometry> theGeometry;
+    boost::shared_ptr<TrackerCompactLayerTable> theTable;
+
+  };
+
+  void translateException(const cms::Exception& e) { 
+    PyErr_SetString(PyExc_RuntimeError,e.what());
+  }
+
+}
+
+BOOST_PYTHON_MODULE(libFastSimulationTrackerSetupPython)
+{
+  boost::python::register_exception_translator<cms::Exception>(translateException);
+  registerColumnBuffer();
+
+  boost::python::class_<PythonTrackerGeometry, boost::noncopyable>
+    ("TrackerInteractionGeometry",
+     boost::python::init<PythonParameterSet&,PythonParameterSet&>())
+    .def("nLayers",&PythonTrackerGeometry::nLayers)
+    .def("column",&PythonTrackerGeometry::column)
+    .def("materialBudget",&PythonTrackerGeometry::materialBudget)
+    .def("crossings",&PythonTrackerGeometry::crossings)
+    ;
+}
@@ -0,0 +1,56 @@
+# NumPy access to the layer table of the interaction geometry, built from
+# the configuration with the layer positions of TrackerLayerPositions_cfi.py.
+#
+#   from FastSimulation.TrackerSetup.TrackerGeometryTable import TrackerGeometryTable
+#   table = TrackerGeometryTable()            # or TrackerGeometryTable(myMaterialPSet)
+#   table.column('radLen')                    # x/X0 of the positive-side layers
+#   table.materialBudget(eta, z0)             # one value per (eta, z0) pair
+#
+# The columns share the memory of the geometry (no copy), are read-only and
+# keep the geometry alive.
+# Disks have position = |z|, low/high = inner/outer radius; cylinders have
+# position = radius, low = half length. The fudge factors of layer i are
+# fudgeMin/fudgeMax/fudgeFactor[fudgeOffset[i]:fudgeOffset[i+1]].
+
+import numpy
+import libFWCorePythonParameterSet
+import libFastSimulationTrackerSetupPython
+
+from FastSimulation.TrackerSetup.TrackerMaterial_cfi import TrackerMaterialBlock
+from FastSimulation.TrackerSetup.TrackerLayerPositions_cfi import TrackerLayerPositionsBlock
+
+_dtypes = { 'layerNumber' : numpy.uint16, 'forward' : numpy.uint8, 'fudgeOffset' : numpy.uint16 }
+
+def _pset(cmsPSet):
+    pset = libFWCorePythonParameterSet.ParameterSet()
+    cmsPSet.insertContents(pset)
+    return pset
+
+class TrackerGeometryTable(object):
+
+    def __init__(self, trackerMaterial=TrackerMaterialBlock.TrackerMaterial,
+                 layerPositions=TrackerLayerPositionsBlock.LayerPositions):
+        self._geometry = libFastSimulationTrackerSetupPython.TrackerInteractionGeometry(
+            _pset(trackerMaterial), _pset(layerPositions))
+
+    def nLayers(self, side=0):
+        return self._geometry.nLayers(side)
+
+    def column(self, name, side=0):
+        return numpy.frombuffer(self._geometry.column(name, side),
+                                dtype=_dtypes.get(name, numpy.float32))
+
+    def materialBudget(self, eta, z0):
+        eta = numpy.ascontiguousarray(eta, dtype=numpy.float64)
+        z0 = numpy.ascontiguousarray(numpy.broadcast_to(z0, eta.shape), dtype=numpy.float64)
+        result = numpy.empty_like(eta)
+        self._geometry.materialBudget(eta, z0, result)
+        return result
+
+    def crossings(self, eta, z0):
+        eta = numpy.ascontiguousarray(eta, dtype=numpy.float64)
+        z0 = numpy.ascontiguousarray(numpy.broadcast_to(z0, eta.shape), dtype=numpy.float64)
+        # One row per line, over the layers of its side (NaN beyond them)
+        result = numpy.empty((eta.size, max(self.nLayers(0), self.nLayers(1))))
+        self._geometry.crossings(eta, z0, result)
+        return result
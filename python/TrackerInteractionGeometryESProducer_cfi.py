@@ -2,13 +2,31 @@ import FWCore.ParameterSet.Config as cms
 
 # With an ideal geometry (for the reconstruction)
 from FastSimulation.TrackerSetup.TrackerMaterial_cfi import *
+from FastSimulation.TrackerSetup.TrackerLayerPositions_cfi import *
 TrackerInteractionGeometryESProducer = cms.ESProducer("TrackerInteractionGeometryESProducer",
-    TrackerMaterialBlock
+    TrackerMaterialBlock,
+    TrackerLayerPositionsBlock,
+    # 'RecoGeometry' or 'Configuration' (ideal geometry only, refused with
+    # a trackerGeometryLabel). The configuration snapshot is a stopgap :
+    # checkLayerPositions builds the reco geometry once to verify it (within
+    # layerPositionsTolerance cm); switch it off only for timing studies
+    layerPositionsSource = cms.untracked.string('RecoGeometry'),
+    checkLayerPositions = cms.untracked.bool(True),
+    layerPositionsTolerance = cms.untracked.double(0.01),
+    # Build the geometry in a background thread from the start of the job
+    # (with the reco geometry, only the part that does not depend on the
+    # layer positions, while the reco geometry is built)
+    concurrentBuild = cms.untracked.bool(False)
 )
 
 # The same as above but with a misaligned tracker geometry (for the simulation)
+# (set TrackerMaterial.first_order_misalignment to also shift and tilt the
+# sensitive layers, beyond their radii and z positions)
 misalignedTrackerInteractionGeometry = cms.ESProducer("TrackerInteractionGeometryESProducer",
     TrackerMaterialBlock,
+    TrackerLayerPositionsBlock,
+    layerPositionsSource = cms.untracked.string('RecoGeometry'),
+    concurrentBuild = cms.untracked.bool(False),
     trackerGeometryLabel = cms.untracked.string('MisAligned'),
     appendToDataLabel = cms.string('MisAligned')
 )
@@ -0,0 +1,34 @@
+import FWCore.ParameterSet.Config as cms
+
+# Snapshot of the active layer positions of the reco geometry, used by the
+# hardcoded interaction geometry when layerPositionsSource = 'Configuration'
+# (the GeometricSearchTracker is then only built to check it). The negative
+# side is the mirror image of the positive side : the snapshot is refused for
+# the misaligned geometry. This is a stopgap, not read from the geometry or
+# alignment records : it must be regenerated when the geometry changes, and
+# is verified with checkLayerPositions (on by default) in
+# TrackerInteractionGeometryESProducer_cfi.py.
+TrackerLayerPositionsBlock = cms.PSet(
+    LayerPositions = cms.PSet(
+    # Barrel layers PXB1-3, TIB1-4, TOB1-6 : radius and full length
+    BarrelRadius = cms.vdouble(4.41058, 7.30732, 10.1726,
+                               25.6786, 34.0341, 41.9599, 49.8924,
+                               60.7671, 69.3966, 78.0686, 86.8618, 96.5557, 108.05),
+    BarrelLength = cms.vdouble(53.38, 53.38, 53.38,
+                               130.04, 131.999, 131.628, 132.78,
+                               216.576, 216.576, 216.576, 216.576, 216.576, 216.576),
+    # Forward layers PXD1-2, TID1-3, TEC1-9 (positive z) : radii and z
+    ForwardInnerRadius = cms.vdouble(5.42078, 5.42078,
+                                     23.14, 23.14, 23.14,
+                                     23.3749, 23.3749, 23.3749, 32.1263, 32.1263, 32.1263,
+                                     44.7432, 44.7432, 56.1781),
+    ForwardOuterRadius = cms.vdouble(16.0756, 16.0756,
+                                     50.4337, 50.4337, 50.4337,
+                                     99.1967, 99.1967, 99.1967, 99.1967, 99.1967, 99.1967,
+                                     99.1967, 99.1967, 99.1967),
+    ForwardZPosition = cms.vdouble(35.5, 48.5,
+                                   78.445, 90.445, 105.445,
+                                   131.892, 145.892, 159.892, 173.892, 187.892, 205.392,
+                                   224.121, 244.621, 266.121)
+    )
+)
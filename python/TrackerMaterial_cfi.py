@@ -6,6 +6,119 @@ TrackerMaterialBlock = cms.PSet(
 
     use_hardcoded_geometry = cms.bool(True),
 
+    # Merge adjacent dead-material layers of the same shape (disks at the
+    # same z, or cylinders at the same radius, within merge_tolerance in cm)
+    # into one effective layer with the same material budget
+    merge_dead_layers = cms.bool(False),
+    merge_tolerance = cms.double(0.01),
+
+    # Precompute the ordered list of layers crossed by straight lines
+    # (photons, neutral hadrons) on a grid of eta and vertex z (in cm),
+    # with the cumulative material : also used by the interaction profiles
+    # of lines from the beam line
+    neutral_templates = cms.untracked.bool(False),
+    neutral_templates_eta_bins = cms.untracked.uint32(250),
+    neutral_templates_eta_max = cms.untracked.double(5.0),
+    neutral_templates_z_bins = cms.untracked.uint32(30),
+    neutral_templates_z_max = cms.untracked.double(15.0),
+
+    # Build (phi,z) / (phi,r) grids of the modules of each sensitive layer,
+    # for a fast crossing-to-module lookup (hardcoded geometry only),
+    # filled in module_grids_threads threads
+    module_grids = cms.untracked.bool(False),
+    module_grids_phi_bins = cms.untracked.uint32(128),
+    module_grids_u_bins = cms.untracked.uint32(32),
+    module_grids_threads = cms.untracked.uint32(4),
+
+    # Time and memory of each construction phase, summarized in the log;
+    # with profiling_query_sampling = N, one material budget query in N is
+    # timed too (count, mean, max and a log2 histogram of the latencies).
+    # The phases are written as Chrome trace events (JSON) to 
+    # profiling_trace_file, if not empty, with the label of the producer
+    # appended (e.g., trace_MisAligned.json)
+    profiling = cms.untracked.bool(False),
+    profiling_query_sampling = cms.untracked.uint32(0),
+    profiling_trace_file = cms.untracked.string(''),
+
+    # Single-precision copy of the layer table for the straight-line and
+    # material kernels (compared to the double-precision layers by
+    # test/TrackerRandomLineStudy.cpp)
+    compact_table = cms.untracked.bool(False),
+
+    # Only keep the layers reaching into r < region_max_radius and 
+    # |z| < region_max_z (in cm, negative = no limit), for jobs that do not
+    # propagate particles beyond a given volume (e.g., the pixel detector)
+    region_max_radius = cms.double(-1.0),
+    region_max_z = cms.double(-1.0),
+
+    # (u, phi) maps of the factors on x/X0 of a layer (u = |z| for a 
+    # cylinder, r for a disk), replacing its fudge factor ranges : layer
+    # number, number of u and phi bins, u range (cm), and the factors of
+    # all maps one after the other (phi-major). Maps can also be read from
+    # material_map_file. With fudge_to_material_maps, the fudge factor 
+    # ranges of the other layers are converted to maps with fudge_map_u_bins
+    # bins (the single-precision table above keeps the ranges)
+    material_map_layer = cms.vuint32(),
+    material_map_u_bins = cms.vuint32(),
+    material_map_phi_bins = cms.vuint32(),
+    material_map_u_min = cms.vdouble(),
+    material_map_u_max = cms.vdouble(),
+    material_map_factors = cms.vdouble(),
+    material_map_file = cms.string(''),
+    fudge_to_material_maps = cms.bool(False),
+    fudge_map_u_bins = cms.uint32(64),
+
+    # Material budget of straight lines from the layer surfaces ('Surfaces')
+    # or from a (r,z) grid of voxel_r_bins x voxel_z_bins cells ('Voxels'),
+    # both timed and compared by test/TrackerRandomLineStudy.cpp
+    material_backend = cms.string('Surfaces'),
+    voxel_r_bins = cms.uint32(480),
+    voxel_z_bins = cms.uint32(1200),
+
+    # Intern the layer materials (x/X0 and fudge factors, or material map)
+    # into a palette of distinct materials, with a two-byte index per layer
+    # (always built with the sampling tables)
+    material_palette = cms.untracked.bool(False),
+
+    # Walker alias tables of the energy loss fluctuations (for a particle
+    # of mass sampling_tables_mass, in GeV) in each distinct layer material,
+    # binned in crossing angle correction (1 to sampling_tables_max_angle)
+    # and in log(energy), and of the energy sharing of photon conversions.
+    # The tables are built in sampling_tables_threads threads
+    sampling_tables = cms.untracked.bool(False),
+    sampling_tables_angle_bins = cms.untracked.uint32(8),
+    sampling_tables_max_angle = cms.untracked.double(10.0),
+    sampling_tables_energy_bins = cms.untracked.uint32(24),
+    sampling_tables_energy_min = cms.untracked.double(0.1),
+    sampling_tables_energy_max = cms.untracked.double(1000.0),
+    sampling_tables_x_bins = cms.untracked.uint32(256),
+    sampling_tables_threads = cms.untracked.uint32(4),
+    sampling_tables_mass = cms.untracked.double(0.13957),
+
+    # x/X0 and multiple scattering coefficient between all the pairs of
+    # sensitive layers, for straight lines from the nominal vertex, in
+    # layer_pair_tables_eta_bins bins of |eta| up to layer_pair_tables_eta_max
+    layer_pair_tables = cms.untracked.bool(False),
+    layer_pair_tables_eta_bins = cms.untracked.uint32(100),
+    layer_pair_tables_eta_max = cms.untracked.double(3.0),
+
+    # Shift and tilt the sensitive layers of the hardcoded geometry, to
+    # first order, as fitted to the module positions of the reco geometry
+    # (e.g., the misaligned one) against those of the ideal geometry. The
+    # cost of the misaligned layer walk is in test/TrackerRandomLineStudy.cpp
+    first_order_misalignment = cms.bool(False),
+
+    # Momenta above which multiple scattering (angle below
+    # effect_thresholds_ms_tolerance, in rad) and ionization energy loss 
+    # (below effect_thresholds_eloss_tolerance of the momentum) can be left
+    # out, per layer, fudge factor range and bin of crossing angle 
+    # correction (up to effect_thresholds_max_angle)
+    effect_thresholds = cms.untracked.bool(False),
+    effect_thresholds_ms_tolerance = cms.untracked.double(1.0e-5),
+    effect_thresholds_eloss_tolerance = cms.untracked.double(1.0e-4),
+    effect_thresholds_angle_bins = cms.untracked.uint32(8),
+    effect_thresholds_max_angle = cms.untracked.double(10.0),
+
     disk_thickness = cms.vdouble(0.058,0.058,0.04,0.04,0.055,0.05,0.05,0.05,0.05,0.05,0.05,0.05,0.05,0.05),
     disk_inner_radius = cms.vdouble(5.82585,5.82585,22.7005,22.7005,22.7005,23.3726,23.3726,23.3726,32.1214,32.1214,32.1214,39.2102,39.2102,50.4201),
     disk_outer_radius = cms.vdouble(14.5978,14.5978,50.4389,50.4389,50.4389,109.521,109.521,109.521,109.521,109.521,109.521,109.521,109.521,109.521),
@@ -15,6 +128,37 @@ TrackerMaterialBlock = cms.PSet(
     barrel_radius = cms.vdouble(4.41058,7.30732,10.1726,25.7514,34.0888,41.9601,49.8925,60.9234,69.309,78.0686,86.8618,96.5557,108.05),
     barrel_length = cms.vdouble(53.38,53.38,53.38,130.595,132.554,132.554,132.78,217.419,217.419,217.419,217.419,217.419,217.419),
 
+    # Sensitive (1) or dead (0) barrel and disk layers (empty = all
+    # sensitive). At most 100 layers can be sensitive.
+    barrel_sensitive = cms.vuint32(),
+    disk_sensitive = cms.vuint32(),
+
+    # Material of the negative-z side, if different (empty = same as above)
+    disk_thickness_negative = cms.vdouble(),
+    barrel_thickness_negative = cms.vdouble(),
+
+    # Tilted barrel rings : tilt of the modules towards the interaction
+    # point (rad) and |z| beyond which they are tilted, per barrel layer
+    # (empty = no tilt). The tilt changes the incidence, hence x/X0.
+    barrel_tilt = cms.vdouble(),
+    barrel_tilt_z_min = cms.vdouble(),
+
+    # Fudge factors of the flexible geometry : index of the barrel (disk)
+    # layer in the vectors above, min and max |z| (r), and factor on x/X0
+    # (if ranges of a layer overlap, the first one applies)
+    barrel_fudge_layer = cms.vuint32(),
+    barrel_fudge_min = cms.vdouble(),
+    barrel_fudge_max = cms.vdouble(),
+    barrel_fudge_factor = cms.vdouble(),
+    disk_fudge_layer = cms.vuint32(),
+    disk_fudge_min = cms.vdouble(),
+    disk_fudge_max = cms.vdouble(),
+    disk_fudge_factor = cms.vdouble(),
+
+    # Check that the flexible geometry layers are nested. Switch off for
+    # overlapping layers, which are then reached through the layer index
+    check_nesting = cms.untracked.bool(True),
+
     # version 0 = Tracker geometry used between CMSSW_1_2_0 and CMSSW_1_4_10. Works for CSA07; 
     # version 1 = Tuned to CMSSW_1_7_0 geometry
     # version 2 = Tuned to CMSSW_1_8_0 geometry
@@ -494,3 +638,54 @@ TrackerMaterialBlock = cms.PSet(
 )
     
     
+
+# The versioned tables of the hardcoded geometry, and the fudge factors.
+# The geometry uses the generated C++ tables (interface/TrackerMaterialTables.h,
+# see scripts/generateTrackerMaterialTables.py) when material_tables_digest
+# is theirs, and reads the tables below otherwise. A customisation of the
+# tables must call updateTrackerMaterialDigest() on its TrackerMaterial.
+TrackerMaterialTableNames = [
+    'BeamPipeThickness', 'PXBThickness', 'PXB1CablesThickness',
+    'PXB2CablesThickness', 'PXB3CablesThickness', 'PXBOutCables1Thickness',
+    'PXBOutCables2Thickness', 'PXDThickness', 'PXDOutCables1Thickness',
+    'PXDOutCables2Thickness', 'TIBLayer1Thickness', 'TIBLayer2Thickness',
+    'TIBLayer3Thickness', 'TIBLayer4Thickness', 'TIBOutCables1Thickness',
+    'TIBOutCables2Thickness', 'TIDLayer1Thickness', 'TIDLayer2Thickness',
+    'TIDLayer3Thickness', 'TIDOutsideThickness', 'TOBInsideThickness',
+    'TOBLayer1Thickness', 'TOBLayer2Thickness', 'TOBLayer3Thickness',
+    'TOBLayer4Thickness', 'TOBLayer5Thickness', 'TOBLayer6Thickness',
+    'TOBOutsideThickness', 'TECLayerThickness', 'BarrelCablesThickness',
+    'EndcapCables1Thickness', 'EndcapCables2Thickness', 'BeamPipeRadius',
+    'BeamPipeLength', 'PXB1CablesInnerRadius', 'PXB2CablesInnerRadius',
+    'PXB3CablesInnerRadius', 'PXBOutCables1InnerRadius',
+    'PXBOutCables1OuterRadius', 'PXBOutCables1ZPosition',
+    'PXBOutCables2InnerRadius', 'PXBOutCables2OuterRadius',
+    'PXBOutCables2ZPosition', 'PixelOutCablesRadius', 'PixelOutCablesLength',
+    'PixelOutCablesInnerRadius', 'PixelOutCablesOuterRadius',
+    'PixelOutCablesZPosition', 'TIBOutCables1InnerRadius',
+    'TIBOutCables1OuterRadius', 'TIBOutCables1ZPosition',
+    'TIBOutCables2InnerRadius', 'TIBOutCables2OuterRadius',
+    'TIBOutCables2ZPosition', 'TOBInCablesRadius', 'TOBInCablesLength',
+    'TIDOutCablesInnerRadius', 'TIDOutCablesZPosition',
+    'TOBOutCablesInnerRadius', 'TOBOutCablesOuterRadius',
+    'TOBOutCablesZPosition', 'TOBOutCablesRadius', 'TOBOutCablesLength',
+    'TECOutCables1InnerRadius', 'TECOutCables1OuterRadius',
+    'TECOutCables1ZPosition', 'TECOutCables2InnerRadius',
+    'TECOutCables2OuterRadius', 'TECOutCables2ZPosition',
+    ]
+TrackerMaterialFudgeNames = ['FudgeLayer', 'FudgeMin', 'FudgeMax', 'FudgeFactor']
+
+def trackerMaterialDigest(trackerMaterial):
+    # The md5 of name=<values as little-endian doubles>; for each table
+    import hashlib, struct
+    digest = hashlib.md5()
+    for name in TrackerMaterialTableNames + TrackerMaterialFudgeNames:
+        values = [float(x) for x in getattr(trackerMaterial,name).value()]
+        digest.update(name.encode() + b'=' + struct.pack('<%dd' % len(values), *values) + b';')
+    return digest.hexdigest()
+
+def updateTrackerMaterialDigest(trackerMaterial):
+    # The digest checked by the geometry (tracked : it is part of the PSet ID)
+    trackerMaterial.material_tables_digest = cms.string(trackerMaterialDigest(trackerMaterial))
+
+updateTrackerMaterialDigest(TrackerMaterialBlock.TrackerMaterial)
@@ -0,0 +1,58 @@
+#!/usr/bin/env python
+# Generate interface/TrackerMaterialTables.h from TrackerMaterial_cfi.py.
+# Run it from the package directory after any change to the hardcoded 
+# material tables :
+#   python scripts/generateTrackerMaterialTables.py > interface/TrackerMaterialTables.h
+# The configuration declares the digest of its tables (material_tables_digest,
+# see updateTrackerMaterialDigest()) : if the header is not regenerated, or 
+# the tables are modified by a customisation, the digests differ and the 
+# tables are read from the configuration, as before.
+
+from FastSimulation.TrackerSetup.TrackerMaterial_cfi import *
+
+material = TrackerMaterialBlock.TrackerMaterial
+
+def array(ctype, name, values, size):
+    items = ', '.join([repr(v) for v in values])
+    return '  static const %s %s[%s] = { %s };' % (ctype, name, size, items)
+
+nVersions = len(material.BeamPipeThickness.value())
+for name in TrackerMaterialTableNames:
+    if len(getattr(material,name).value()) != nVersions:
+        raise RuntimeError('%s does not have %d versions' % (name, nVersions))
+nFudges = len(material.FudgeLayer.value())
+for name in TrackerMaterialFudgeNames:
+    if len(getattr(material,name).value()) != nFudges:
+        raise RuntimeError('%s does not have %d entries' % (name, nFudges))
+
+print('#ifndef FastSimulation_TrackerSetup_TrackerMaterialTables_H')
+print('#define FastSimulation_TrackerSetup_TrackerMaterialTables_H')
+print('')
+print('// Generated by scripts/generateTrackerMaterialTables.py from')
+print('// python/TrackerMaterial_cfi.py : do not edit.')
+print('')
+print('namespace TrackerMaterialTables {')
+print('')
+print('  /// Digest of the tables, as computed by trackerMaterialDigest()')
+print('  static const char digest[] = "%s";' % trackerMaterialDigest(material))
+print('')
+print('  /// Number of material versions, and of fudge factors')
+print('  static const unsigned nVersions = %d;' % nVersions)
+print('  static const unsigned nFudges = %d;' % nFudges)
+print('')
+print('  /// Names of the tables, in digest order (the fudge factors last)')
+print('  static const unsigned nTables = %d;' % len(TrackerMaterialTableNames))
+print('  static const char* const tableNames[nTables] = { %s };' % 
+      ', '.join(['"%s"' % name for name in TrackerMaterialTableNames]))
+print('  static const char* const fudgeNames[4] = { %s };' % 
+      ', '.join(['"%s"' % name for name in TrackerMaterialFudgeNames]))
+print('')
+for name in TrackerMaterialTableNames:
+    print(array('double', name, [float(x) for x in getattr(material,name).value()], 'nVersions'))
+print('')
+print(array('unsigned', 'FudgeLayer', [int(x) for x in material.FudgeLayer.value()], 'nFudges'))
+for name in TrackerMaterialFudgeNames[1:]:
+    print(array('double', name, [float(x) for x in getattr(material,name).value()], 'nFudges'))
+print('')
+print('}')
+print('#endif')
@@ -0,0 +1,4 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerPositions.h"
+#include "FWCore/Utilities/interface/typelookup.h"
+
+TYPELOOKUP_DATA_REG(TrackerLayerPositions);
@@ -0,0 +1,52 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerAliasTable.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+void
+TrackerAliasTable::build(const std::vector<double>& weights, double xMin, double xMax) {
+
+  unsigned n = weights.size();
+  double sum = 0.;
+  for ( unsigned i=0; i<n; ++i ) sum += weights[i];
+  if ( !n || n > 65536 || sum <= 0. || xMax <= xMin )
+    throw cms::Exception("FastSimulation/TrackerAliasTable")
+      << "Cannot build an alias table from " << n << " bins of total weight "
+      << sum << " over [" << xMin << "," << xMax << "]";
+
+  theXMin = xMin;
+  theStep = (xMax-xMin)/n;
+  theProbability.resize(n);
+  theAlias.resize(n);
+
+  // Vose's method : bins below the mean weight are completed by an alias
+  // from bins above it
+  std::vector<double> scaled(n);
+  std::vector<unsigned> small, large;
+  for ( unsigned i=0; i<n; ++i ) {
+    scaled[i] = weights[i]*n/sum;
+    if ( scaled[i] < 1. ) small.push_back(i);
+    else large.push_back(i);
+  }
+  while ( !small.empty() && !large.empty() ) {
+    unsigned s = small.back();
+    small.pop_back();
+    unsigned l = large.back();
+    theProbability[s] = scaled[s];
+    theAlias[s] = l;
+    scaled[l] -= 1.-scaled[s];
+    if ( scaled[l] < 1. ) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // What remains is full, within rounding
+  for ( unsigned i=0; i<large.size(); ++i ) {
+    theProbability[large[i]] = 1.f;
+    theAlias[large[i]] = large[i];
+  }
+  for ( unsigned i=0; i<small.size(); ++i ) {
+    theProbability[small[i]] = 1.f;
+    theAlias[small[i]] = small[i];
+  }
+
+}
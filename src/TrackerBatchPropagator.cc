@@ -0,0 +1,161 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerBatchPropagator.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerInteractionGeometry.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerWorkerPool.h"
+
+#include <boost/bind.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace { 
+  // Order of the particles : side, then first layer
+  struct BatchKey { 
+    BatchKey(const std::vector<TrackerBatchPropagator::Particle>& particles) : 
+      theParticles(particles) {}
+    bool operator()(unsigned a, unsigned b) const { 
+      bool sideA = theParticles[a].eta < 0.f;
+      bool sideB = theParticles[b].eta < 0.f;
+      if ( sideA != sideB ) return sideA < sideB;
+      return theParticles[a].firstLayer < theParticles[b].firstLayer;
+    }
+    const std::vector<TrackerBatchPropagator::Particle>& theParticles;
+  };
+}
+
+TrackerBatchPropagator::TrackerBatchPropagator(const TrackerInteractionGeometry& geometry,
+					       unsigned batchSize) :
+  theGeometry(geometry),
+  theBatchSize(std::max(batchSize,1U)),
+  theNextBatch(0)
+{
+  resetCounters();
+}
+
+void
+TrackerBatchPropagator::resetCounters() { 
+  for ( unsigned side=0; side<2; ++side ) { 
+    unsigned nLayers = theGeometry.nCylinders(static_cast<TrackerInteractionGeometry::Side>(side));
+    theTested[side].assign(nLayers,0);
+    theCrossed[side].assign(nLayers,0);
+    theBatchesAtLayer[side].assign(nLayers,0);
+  }
+}
+
+double
+TrackerBatchPropagator::occupancy(unsigned side, unsigned i) const { 
+  return theBatchesAtLayer[side][i] ? 
+    static_cast<double>(theCrossed[side][i])/theBatchesAtLayer[side][i] : 0.;
+}
+
+void
+TrackerBatchPropagator::propagate(const std::vector<Particle>& particles,
+				  std::vector<Crossing>& crossings,
+				  unsigned nThreads) { 
+
+  // Group the particles by side and first layer, and cut the groups 
+  // into batches
+  theOrder.resize(particles.size());
+  for ( unsigned i=0; i<particles.size(); ++i ) theOrder[i] = i;
+  std::stable_sort(theOrder.begin(),theOrder.end(),BatchKey(particles));
+
+  theBatches.clear();
+  for ( unsigned i=0; i<theOrder.size(); ) { 
+    const Particle& particle = particles[theOrder[i]];
+    Batch batch;
+    batch.side = particle.eta < 0.f;
+    batch.firstLayer = particle.firstLayer;
+    batch.begin = i;
+    while ( i<theOrder.size() && i-batch.begin<theBatchSize &&
+	    (particles[theOrder[i]].eta < 0.f) == static_cast<bool>(batch.side) && 
+	    particles[theOrder[i]].firstLayer == batch.firstLayer ) ++i;
+    batch.end = i;
+    theBatches.push_back(batch);
+    for ( unsigned iLayer=batch.firstLayer; iLayer<theBatchesAtLayer[batch.side].size(); ++iLayer ) 
+      ++theBatchesAtLayer[batch.side][iLayer];
+  }
+
+  // Propagate the batches, in this thread or in a few worker threads
+  theBatchCrossings.resize(theBatches.size());
+  theNextBatch = 0;
+  TrackerWorkerPool pool(nThreads);
+  pool.run(boost::bind(&TrackerBatchPropagator::work,this,&particles));
+
+  crossings.clear();
+  for ( unsigned iBatch=0; iBatch<theBatches.size(); ++iBatch ) 
+    crossings.insert(crossings.end(),theBatchCrossings[iBatch].begin(),theBatchCrossings[iBatch].end());
+
+}
+
+void
+TrackerBatchPropagator::work(const std::vector<Particle>* particles) { 
+
+  // Counters of this thread, added to the totals at the end
+  std::vector<unsigned long> tested[2];
+  std::vector<unsigned long> crossed[2];
+  for ( unsigned side=0; side<2; ++side ) { 
+    tested[side].assign(theTested[side].size(),0);
+    crossed[side].assign(theCrossed[side].size(),0);
+  }
+
+  while ( true ) { 
+    unsigned iBatch;
+    { 
+      boost::mutex::scoped_lock lock(theMutex);
+      if ( theNextBatch == theBatches.size() ) break;
+      iBatch = theNextBatch++;
+    }
+    propagate(theBatches[iBatch],*particles,theBatchCrossings[iBatch],tested,crossed);
+  }
+
+  boost::mutex::scoped_lock lock(theMutex);
+  for ( unsigned side=0; side<2; ++side ) { 
+    for ( unsigned i=0; i<tested[side].size(); ++i ) { 
+      theTested[side][i] += tested[side][i];
+      theCrossed[side][i] += crossed[side][i];
+    }
+  }
+
+}
+
+void
+TrackerBatchPropagator::propagate(const Batch& batch,
+				  const std::vector<Particle>& particles,
+				  std::vector<Crossing>& crossings,
+				  std::vector<unsigned long>* tested,
+				  std::vector<unsigned long>* crossed) const { 
+
+  crossings.clear();
+  unsigned nParticles = batch.end-batch.begin;
+
+  // The lines of the batch, in coordinates folded to their side
+  double sign = batch.side ? -1. : 1.;
+  std::vector<double> z0(nParticles), sinTheta(nParticles), cosTheta(nParticles);
+  for ( unsigned i=0; i<nParticles; ++i ) { 
+    const Particle& particle = particles[theOrder[batch.begin+i]];
+    double theta = 2.*std::atan(std::exp(-sign*particle.eta));
+    z0[i] = sign*particle.z0;
+    sinTheta[i] = std::sin(theta);
+    cosTheta[i] = std::cos(theta);
+  }
+
+  // The whole batch, one layer at a time
+  TrackerInteractionGeometry::Side side = static_cast<TrackerInteractionGeometry::Side>(batch.side);
+  unsigned nLayers = theGeometry.nCylinders(side);
+  double path, dim, angle;
+  for ( unsigned iLayer=batch.firstLayer; iLayer<nLayers; ++iLayer ) { 
+    const TrackerLayer& layer = theGeometry.layer(side,iLayer);
+    double radLen = layer.radLen();
+    tested[batch.side][iLayer] += nParticles;
+    for ( unsigned i=0; i<nParticles; ++i ) { 
+      if ( !layer.straightCrossing(z0[i],sinTheta[i],cosTheta[i],path,dim,angle) ) continue;
+      Crossing crossing;
+      crossing.particle = theOrder[batch.begin+i];
+      crossing.layer = iLayer;
+      crossing.path = path;
+      crossing.radLen = radLen * layer.fudgeFactorAt(dim) * angle;
+      crossings.push_back(crossing);
+      ++crossed[batch.side][iLayer];
+    }
+  }
+
+}
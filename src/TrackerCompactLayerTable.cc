@@ -0,0 +1,71 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerCompactLayerTable.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayer.h"
+
+#include <cmath>
+
+TrackerCompactLayerTable::TrackerCompactLayerTable(const std::vector<const TrackerLayer*>& positiveLayers,
+						   const std::vector<const TrackerLayer*>& negativeLayers)
+{
+
+  const std::vector<const TrackerLayer*>* layers[2] = { &positiveLayers, &negativeLayers };
+  for ( unsigned side=0; side<2; ++side ) { 
+    theFudgeOffsets[side].push_back(0);
+    for ( unsigned iLayer=0; iLayer<layers[side]->size(); ++iLayer ) { 
+      const TrackerLayer& layer = *(*layers[side])[iLayer];
+      theLayerNumber[side].push_back(layer.layerNumber());
+      theForward[side].push_back(layer.forward());
+      if ( layer.forward() ) { 
+	thePosition[side].push_back(std::abs(layer.diskZPosition()));
+	theLow[side].push_back(layer.diskInnerRadius());
+	theHigh[side].push_back(layer.diskOuterRadius());
+      } else { 
+	thePosition[side].push_back(layer.cylinderRadius());
+	theLow[side].push_back(layer.cylinderHalfLength());
+	theHigh[side].push_back(layer.tilt() != 0. ? layer.tiltZMin() : 1E9);
+      }
+      theCosTilt[side].push_back(std::cos(layer.tilt()));
+      theSinTilt[side].push_back(std::sin(layer.tilt()));
+      theRadLen[side].push_back(layer.radLen());
+      for ( unsigned iFudge=0; iFudge<layer.fudgeNumber(); ++iFudge ) { 
+	theFudgeMin[side].push_back(layer.fudgeMin(iFudge));
+	theFudgeMax[side].push_back(layer.fudgeMax(iFudge));
+	theFudgeFactor[side].push_back(layer.fudgeFactor(iFudge));
+      }
+      theFudgeOffsets[side].push_back(theFudgeMin[side].size());
+    }
+  }
+
+}
+
+float
+TrackerCompactLayerTable::materialBudget(float eta, float z0) const { 
+  // Fold to the side of the direction : z -> |z|
+  unsigned side = eta < 0.f;
+  if ( side ) { 
+    eta = -eta;
+    z0 = -z0;
+  }
+  float theta = 2.f*std::atan(std::exp(-eta));
+  float sinTheta = std::sin(theta);
+  float cosTheta = std::cos(theta);
+  float radLen = 0.f;
+  for ( unsigned iLayer=0; iLayer<nLayers(side); ++iLayer ) 
+    radLen += straightRadLen(side,iLayer,z0,sinTheta,cosTheta);
+  return radLen;
+}
+
+unsigned
+TrackerCompactLayerTable::size() const { 
+  unsigned bytes = 0;
+  for ( unsigned side=0; side<2; ++side ) { 
+    bytes += theLayerNumber[side].size() * sizeof(unsigned short);
+    bytes += theForward[side].size() * sizeof(unsigned char);
+    bytes += (thePosition[side].size() + theLow[side].size() + 
+	      theHigh[side].size() + theRadLen[side].size() + 
+	      theCosTilt[side].size() + theSinTilt[side].size()) * sizeof(float);
+    bytes += theFudgeOffsets[side].size() * sizeof(unsigned short);
+    bytes += (theFudgeMin[side].size() + theFudgeMax[side].size() + 
+	      theFudgeFactor[side].size()) * sizeof(float);
+  }
+  return bytes;
+}
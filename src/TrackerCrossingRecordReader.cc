@@ -0,0 +1,84 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerCrossingRecordReader.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace { 
+  // The next column of a block, and the position after it
+  template <class T> 
+  const T* column(const char*& cursor, unsigned n) { 
+    const T* result = reinterpret_cast<const T*>(cursor);
+    cursor += n*sizeof(T);
+    return result;
+  }
+}
+
+TrackerCrossingRecordReader::TrackerCrossingRecordReader(const std::string& fileName) :
+  theData(0),
+  theSize(0)
+{
+
+  int fd = open(fileName.c_str(),O_RDONLY);
+  if ( fd < 0 ) 
+    throw cms::Exception("FastSimulation/TrackerCrossingRecordReader") 
+      << "Cannot open " << fileName;
+  struct stat info;
+  if ( fstat(fd,&info) < 0 || info.st_size < 8 ) { 
+    close(fd);
+    throw cms::Exception("FastSimulation/TrackerCrossingRecordReader") 
+      << fileName << " is not a crossing record file";
+  }
+  theSize = info.st_size;
+  theData = mmap(0,theSize,PROT_READ,MAP_PRIVATE,fd,0);
+  close(fd);
+  if ( theData == MAP_FAILED ) { 
+    theData = 0;
+    throw cms::Exception("FastSimulation/TrackerCrossingRecordReader") 
+      << "Cannot map " << fileName;
+  }
+
+  const char* cursor = static_cast<const char*>(theData);
+  const char* end = cursor+theSize;
+  if ( std::memcmp(cursor,"TKXREC01",8) ) { 
+    munmap(theData,theSize);
+    throw cms::Exception("FastSimulation/TrackerCrossingRecordReader") 
+      << fileName << " is not a crossing record file";
+  }
+  cursor += 8;
+
+  // Bytes per row : event, five floats, layer, side and fudge bin
+  const std::size_t rowSize = sizeof(unsigned)+sizeof(unsigned short)+2+5*sizeof(float);
+  while ( cursor+sizeof(unsigned) <= end ) { 
+    Block block;
+    std::memcpy(&block.size,cursor,sizeof(unsigned));
+    cursor += sizeof(unsigned);
+    if ( cursor+block.size*rowSize > end ) break;
+    block.event = column<unsigned>(cursor,block.size);
+    block.r = column<float>(cursor,block.size);
+    block.z = column<float>(cursor,block.size);
+    block.phi = column<float>(cursor,block.size);
+    block.path = column<float>(cursor,block.size);
+    block.radLen = column<float>(cursor,block.size);
+    block.layer = column<unsigned short>(cursor,block.size);
+    block.side = column<unsigned char>(cursor,block.size);
+    block.fudgeBin = column<signed char>(cursor,block.size);
+    theBlocks.push_back(block);
+  }
+
+}
+
+TrackerCrossingRecordReader::~TrackerCrossingRecordReader() { 
+  if ( theData ) munmap(theData,theSize);
+}
+
+unsigned long
+TrackerCrossingRecordReader::nCrossings() const { 
+  unsigned long n = 0;
+  for ( unsigned i=0; i<theBlocks.size(); ++i ) n += theBlocks[i].size;
+  return n;
+}
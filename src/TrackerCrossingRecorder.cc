@@ -0,0 +1,112 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerCrossingRecorder.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayer.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <cmath>
+
+namespace { 
+  template <class T> 
+  void writeColumn(std::FILE* file, const std::vector<T>& column) { 
+    if ( !column.empty() ) std::fwrite(&column[0],sizeof(T),column.size(),file);
+  }
+}
+
+void
+TrackerCrossingRecorder::Block::clear() { 
+  event.clear();
+  layer.clear();
+  side.clear();
+  fudgeBin.clear();
+  r.clear();
+  z.clear();
+  phi.clear();
+  path.clear();
+  radLen.clear();
+}
+
+TrackerCrossingRecorder::TrackerCrossingRecorder(const std::string& fileName, unsigned blockSize) :
+  theFile(std::fopen(fileName.c_str(),"wb")),
+  theBlockSize(blockSize ? blockSize : 1),
+  theEvent(0),
+  theNCrossings(0),
+  theFilling(&theBlocks[0]),
+  theWriting(&theBlocks[1]),
+  theWritingFull(false),
+  theStop(false)
+{
+  if ( !theFile ) 
+    throw cms::Exception("FastSimulation/TrackerCrossingRecorder") 
+      << "Cannot open " << fileName << " for writing";
+  std::fwrite("TKXREC01",1,8,theFile);
+  theWriter.reset(new boost::thread(boost::bind(&TrackerCrossingRecorder::write,this)));
+}
+
+TrackerCrossingRecorder::~TrackerCrossingRecorder() { 
+  flush();
+  { 
+    boost::mutex::scoped_lock lock(theMutex);
+    theStop = true;
+  }
+  theCondition.notify_all();
+  theWriter->join();
+  std::fclose(theFile);
+}
+
+void
+TrackerCrossingRecorder::record(unsigned side, unsigned layerIndex, const TrackerLayer& layer,
+				const GlobalPoint& position, double path, double radLen) { 
+  double dim = layer.forward() ? position.perp() : std::abs(position.z());
+  theFilling->event.push_back(theEvent);
+  theFilling->layer.push_back(layerIndex);
+  theFilling->side.push_back(side);
+  theFilling->fudgeBin.push_back(layer.fudgeBinAt(dim));
+  theFilling->r.push_back(position.perp());
+  theFilling->z.push_back(position.z());
+  theFilling->phi.push_back(position.phi());
+  theFilling->path.push_back(path);
+  theFilling->radLen.push_back(radLen);
+  ++theNCrossings;
+  if ( theFilling->size() >= theBlockSize ) flush();
+}
+
+void
+TrackerCrossingRecorder::flush() { 
+  if ( !theFilling->size() ) return;
+  boost::mutex::scoped_lock lock(theMutex);
+  // Wait for the writer to be done with the previous block
+  while ( theWritingFull ) theCondition.wait(lock);
+  std::swap(theFilling,theWriting);
+  theWritingFull = true;
+  theCondition.notify_all();
+}
+
+void
+TrackerCrossingRecorder::write() { 
+  while ( true ) { 
+    boost::mutex::scoped_lock lock(theMutex);
+    while ( !theWritingFull && !theStop ) theCondition.wait(lock);
+    if ( !theWritingFull ) return;
+    Block* block = theWriting;
+    // The block is not touched by the event loop until theWritingFull is reset
+    lock.unlock();
+    unsigned n = block->size();
+    std::fwrite(&n,sizeof(unsigned),1,theFile);
+    writeColumn(theFile,block->event);
+    writeColumn(theFile,block->r);
+    writeColumn(theFile,block->z);
+    writeColumn(theFile,block->phi);
+    writeColumn(theFile,block->path);
+    writeColumn(theFile,block->radLen);
+    writeColumn(theFile,block->layer);
+    writeColumn(theFile,block->side);
+    writeColumn(theFile,block->fudgeBin);
+    block->clear();
+    lock.lock();
+    theWritingFull = false;
+    theCondition.notify_all();
+  }
+}
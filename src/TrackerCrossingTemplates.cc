@@ -0,0 +1,127 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerCrossingTemplates.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  struct ShorterPath {
+    bool operator()(const TrackerCrossingTemplates::Crossing& a,
+		    const TrackerCrossingTemplates::Crossing& b) const {
+      return a.path < b.path;
+    }
+  };
+}
+
+TrackerCrossingTemplates::TrackerCrossingTemplates(const std::vector<const TrackerLayer*>& positiveLayers,
+						   const std::vector<const TrackerLayer*>& negativeLayers,
+						   unsigned nEta, double etaMax,
+						   unsigned nZ, double zMax) :
+  theNEta(nEta),
+  theEtaMax(etaMax),
+  theEtaStep(etaMax/nEta),
+  theNZ(nZ),
+  theZMax(zMax),
+  theZStep(2.*zMax/nZ)
+{
+
+  theLayers[0] = positiveLayers;
+  theLayers[1] = negativeLayers;
+  for ( unsigned side=0; side<2; ++side ) 
+    for ( unsigned iLayer=0; iLayer<theLayers[side].size(); ++iLayer ) 
+      theRadLen[side].push_back(theLayers[side][iLayer]->radLen());
+
+  std::vector<Crossing> result;
+  for ( unsigned side=0; side<2; ++side ) {
+
+    // All layers are candidates when the templates are built
+    std::vector<unsigned short> allLayers(theLayers[side].size());
+    for ( unsigned iLayer=0; iLayer<theLayers[side].size(); ++iLayer )
+      allLayers[iLayer] = iLayer;
+
+    theOffsets[side].reserve((theNEta+1)*(theNZ+1)+1);
+    theOffsets[side].push_back(0);
+    for ( unsigned iEta=0; iEta<=theNEta; ++iEta ) {
+      for ( unsigned iZ=0; iZ<=theNZ; ++iZ ) {
+	fill(side,iEta*theEtaStep,-theZMax+iZ*theZStep,allLayers,result);
+	theCrossings[side].insert(theCrossings[side].end(),result.begin(),result.end());
+	theOffsets[side].push_back(theCrossings[side].size());
+      }
+    }
+
+  }
+
+}
+
+bool
+TrackerCrossingTemplates::covers(double eta, double z0) const {
+  fold(eta,z0);
+  return eta <= theEtaMax && std::abs(z0) <= theZMax;
+}
+
+TrackerCrossingTemplates::CrossingRange
+TrackerCrossingTemplates::crossings(double eta, double z0) const {
+  unsigned side = fold(eta,z0);
+  int iEta = static_cast<int>(eta/theEtaStep+0.5);
+  int iZ = static_cast<int>((z0+theZMax)/theZStep+0.5);
+  iEta = std::max(0,std::min<int>(iEta,theNEta));
+  iZ = std::max(0,std::min<int>(iZ,theNZ));
+  unsigned iNode = node(iEta,iZ);
+  return CrossingRange(theCrossings[side].begin()+theOffsets[side][iNode],
+		       theCrossings[side].begin()+theOffsets[side][iNode+1]);
+}
+
+void
+TrackerCrossingTemplates::refinedCrossings(double eta, double z0,
+					   std::vector<Crossing>& result) const {
+  unsigned side = fold(eta,z0);
+  int iEta = static_cast<int>(eta/theEtaStep);
+  int iZ = static_cast<int>((z0+theZMax)/theZStep);
+  iEta = std::max(0,std::min<int>(iEta,theNEta-1));
+  iZ = std::max(0,std::min<int>(iZ,theNZ-1));
+
+  // The candidate layers : those crossed at any of the four surrounding nodes
+  std::vector<unsigned short> candidates;
+  for ( unsigned jEta=iEta; jEta<=static_cast<unsigned>(iEta+1); ++jEta ) {
+    for ( unsigned jZ=iZ; jZ<=static_cast<unsigned>(iZ+1); ++jZ ) {
+      unsigned iNode = node(jEta,jZ);
+      for ( unsigned i=theOffsets[side][iNode]; i<theOffsets[side][iNode+1]; ++i )
+	candidates.push_back(theCrossings[side][i].layer);
+    }
+  }
+  std::sort(candidates.begin(),candidates.end());
+  candidates.erase(std::unique(candidates.begin(),candidates.end()),candidates.end());
+
+  fill(side,eta,z0,candidates,result);
+}
+
+void
+TrackerCrossingTemplates::fill(unsigned side, double eta, double z0,
+			       const std::vector<unsigned short>& candidates,
+			       std::vector<Crossing>& result) const {
+  result.clear();
+  double theta = 2.*std::atan(std::exp(-eta));
+  double sinTheta = std::sin(theta);
+  double cosTheta = std::cos(theta);
+  double path, dim, angle;
+  for ( unsigned i=0; i<candidates.size(); ++i ) {
+    const TrackerLayer& layer = *theLayers[side][candidates[i]];
+    if ( !layer.straightCrossing(z0,sinTheta,cosTheta,path,dim,angle) )
+      continue;
+    Crossing crossing;
+    crossing.layer = candidates[i];
+    crossing.path = path;
+    crossing.angle = angle;
+    crossing.dim = dim;
+    crossing.radLen = theRadLen[side][candidates[i]] * layer.fudgeFactorAt(dim) * angle;
+    result.push_back(crossing);
+  }
+  std::stable_sort(result.begin(),result.end(),ShorterPath());
+
+  // The cumulative material, in path order
+  float radLen = 0.f;
+  for ( unsigned i=0; i<result.size(); ++i ) {
+    result[i].radLenBefore = radLen;
+    radLen += result[i].radLen;
+  }
+}
@@ -0,0 +1,108 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerEffectThresholds.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerMaterialMap.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  // Mean ionization loss per X0 of silicon at minimum ionization (GeV)
+  const double ionizationPerRadLen = 1.664E-3 * 21.82;
+
+  // The largest factor on x/X0 of a material map
+  double maxFactor(const TrackerLayerMaterialMap& map) {
+    return *std::max_element(map.values().begin(),map.values().end());
+  }
+}
+
+TrackerEffectThresholds::TrackerEffectThresholds(const TrackerInteractionGeometry& geometry,
+						 double msTolerance, double energyLossTolerance,
+						 unsigned nAngle, double maxAngle) :
+  theGeometry(&geometry),
+  theNAngle(nAngle),
+  theMaxAngle(maxAngle),
+  theInvAngleStep(nAngle/(maxAngle-1.))
+{
+
+  for ( unsigned side=0; side<2; ++side ) {
+    TrackerInteractionGeometry::Side theSide = static_cast<TrackerInteractionGeometry::Side>(side);
+    theOffsets[side].push_back(0);
+    for ( int iLayer=0; iLayer<geometry.nCylinders(theSide); ++iLayer ) {
+      const TrackerLayer& layer = geometry.layer(theSide,iLayer);
+
+      // The factors on x/X0 : none, then each fudge range (the first one
+      // containing a dimension applies), or the largest of a map
+      std::vector<double> factors(1,1.);
+      if ( layer.materialMap() ) {
+	factors[0] = std::max(1.,maxFactor(*layer.materialMap()));
+      } else {
+	for ( unsigned iFudge=0; iFudge<layer.fudgeNumber(); ++iFudge )
+	  factors.push_back(layer.fudgeFactor(iFudge));
+      }
+
+      float layerThreshold[NEffects] = { 0.f, 0.f };
+      float layerMaxRadLen = 0.f;
+      for ( unsigned iBin=0; iBin<factors.size(); ++iBin ) {
+	for ( unsigned iAngle=0; iAngle<theNAngle; ++iAngle ) {
+	  double angle = 1. + (iAngle+1)/theInvAngleStep;
+	  double radLen = layer.radLen() * factors[iBin] * angle;
+	  layerMaxRadLen = std::max(layerMaxRadLen,static_cast<float>(radLen));
+	  float thresholds[NEffects];
+	  thresholds[MultipleScattering] = radLen > 0. ?
+	    std::max(0.,0.0136*std::sqrt(radLen)*(1.+0.038*std::log(radLen))/msTolerance) : 0.;
+	  thresholds[EnergyLoss] = ionizationPerRadLen*radLen/energyLossTolerance;
+	  for ( unsigned effect=0; effect<NEffects; ++effect ) {
+	    theThresholds[side].push_back(thresholds[effect]);
+	    layerThreshold[effect] = std::max(layerThreshold[effect],thresholds[effect]);
+	  }
+	}
+      }
+      theOffsets[side].push_back(theOffsets[side].back()+factors.size());
+      theLayerThresholds[side].insert(theLayerThresholds[side].end(),
+				      layerThreshold,layerThreshold+NEffects);
+      theLayerMaxRadLen[side].push_back(layerMaxRadLen);
+    }
+  }
+
+}
+
+unsigned
+TrackerEffectThresholds::bin(unsigned side, unsigned i, double dim) const {
+  const TrackerLayer& layer = theGeometry->layer(static_cast<TrackerInteractionGeometry::Side>(side),i);
+  if ( layer.materialMap() ) return theOffsets[side][i];
+  return theOffsets[side][i] + layer.fudgeBinAt(dim) + 1;
+}
+
+float
+TrackerEffectThresholds::threshold(Effect effect, unsigned side, unsigned i,
+				   double dim, double angle) const {
+  // Beyond the largest angle correction, the effect is always computed
+  if ( angle > theMaxAngle ) return 1E30;
+  unsigned iAngle = std::min(static_cast<unsigned>((angle-1.)*theInvAngleStep),theNAngle-1);
+  return theThresholds[side][(bin(side,i,dim)*theNAngle+iAngle)*NEffects+effect];
+}
+
+void
+TrackerEffectThresholds::filter(unsigned side, double p,
+				const std::vector<TrackerLayerStepper::Crossing>& crossings,
+				std::vector<unsigned char>& needed) const {
+
+  needed.resize(crossings.size());
+  for ( unsigned i=0; i<crossings.size(); ++i ) {
+    const TrackerLayerStepper::Crossing& crossing = crossings[i];
+    unsigned char mask = 0;
+    for ( unsigned effect=0; effect<NEffects; ++effect ) {
+      // Most crossings of energetic particles stop at the layer threshold
+      if ( p > layerThreshold(static_cast<Effect>(effect),side,crossing.layer) && 
+	   crossing.radLen <= theLayerMaxRadLen[side][crossing.layer] ) continue;
+      const TrackerLayer& layer =
+	theGeometry->layer(static_cast<TrackerInteractionGeometry::Side>(side),crossing.layer);
+      double dim = layer.forward() ? crossing.position.perp() : std::abs(crossing.position.z());
+      double angle = layer.radLen() > 0. ?
+	crossing.radLen/(layer.radLen()*layer.fudgeFactorAt(dim,crossing.position.phi())) : 1.;
+      if ( p <= threshold(static_cast<Effect>(effect),side,crossing.layer,dim,angle) )
+	mask |= 1 << effect;
+    }
+    needed[i] = mask;
+  }
+
+}
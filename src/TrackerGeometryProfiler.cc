@@ -0,0 +1,191 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerGeometryProfiler.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <malloc.h>
+#include <sys/time.h>
+
+namespace { 
+  double microseconds() { 
+    timeval tv;
+    gettimeofday(&tv,0);
+    return tv.tv_sec*1E6 + tv.tv_usec;
+  }
+}
+
+TrackerGeometryProfiler::TrackerGeometryProfiler(unsigned querySampling, const std::string& traceFile) :
+  theOrigin(microseconds()),
+  theQuerySampling(querySampling),
+  theNQueries(0),
+  theTraceFile(traceFile)
+{}
+
+TrackerGeometryProfiler::~TrackerGeometryProfiler() { 
+
+  for ( unsigned i=0; i<theQueries.size(); ++i ) { 
+    const QueryStatistics& query = theQueries[i];
+    edm::LogInfo("TrackerInteractionGeometry") 
+      << "Interaction geometry " << query.name << " queries : " << query.count 
+      << " sampled, mean latency " << query.sum/query.count << " us, max " 
+      << query.max << " us";
+  }
+
+  if ( !theTraceFile.empty() ) writeTrace();
+
+}
+
+void
+TrackerGeometryProfiler::summarizeConstruction() const { 
+  edm::LogInfo log("TrackerInteractionGeometry");
+  log << "Interaction geometry construction :";
+  for ( unsigned i=0; i<theRecords.size(); ++i ) { 
+    const Record& record = theRecords[i];
+    log << "\n  " << std::string(2*record.depth,' ') << record.name << " : " 
+	<< record.duration/1000. << " ms, " << record.allocated/1024 << " kB";
+  }
+}
+
+TrackerGeometryProfiler*
+TrackerGeometryProfiler::create(const edm::ParameterSet& trackerMaterial) { 
+  if ( !trackerMaterial.getUntrackedParameter<bool>("profiling",false) ) return 0;
+  return new TrackerGeometryProfiler(trackerMaterial.getUntrackedParameter<unsigned>("profiling_query_sampling",0),
+				     trackerMaterial.getUntrackedParameter<std::string>("profiling_trace_file",""));
+}
+
+std::string
+TrackerGeometryProfiler::traceFile(const std::string& traceFile, const std::string& label) { 
+  if ( traceFile.empty() || label.empty() ) return traceFile;
+  std::string::size_type dot = traceFile.rfind('.');
+  std::string::size_type slash = traceFile.rfind('/');
+  if ( dot == std::string::npos || ( slash != std::string::npos && dot < slash ) ) 
+    return traceFile + "_" + label;
+  return traceFile.substr(0,dot) + "_" + label + traceFile.substr(dot);
+}
+
+double
+TrackerGeometryProfiler::now() const { 
+  return microseconds()-theOrigin;
+}
+
+long
+TrackerGeometryProfiler::allocatedMemory() { 
+  struct mallinfo info = mallinfo();
+  return static_cast<long>(static_cast<unsigned>(info.uordblks)) + 
+    static_cast<long>(static_cast<unsigned>(info.hblkhd));
+}
+
+void
+TrackerGeometryProfiler::begin(const char* name) { 
+  Record record;
+  record.name = name;
+  record.start = now();
+  record.duration = 0.;
+  record.allocated = allocatedMemory();
+  record.depth = theOpen.size();
+  theOpen.push_back(theRecords.size());
+  theRecords.push_back(record);
+}
+
+void
+TrackerGeometryProfiler::end() { 
+  if ( theOpen.empty() ) return;
+  Record& record = theRecords[theOpen.back()];
+  theOpen.pop_back();
+  record.duration = now()-record.start;
+  record.allocated = allocatedMemory()-record.allocated;
+}
+
+bool
+TrackerGeometryProfiler::sampleQuery(double& start) { 
+  if ( !theQuerySampling ) return false;
+  boost::mutex::scoped_lock lock(theMutex);
+  if ( theNQueries++ % theQuerySampling ) return false;
+  start = now();
+  return true;
+}
+
+void
+TrackerGeometryProfiler::endQuery(const char* name, double start) { 
+
+  double duration = now()-start;
+  unsigned bin = 0;
+  for ( double limit=1.; bin<nQueryBins-1 && duration >= limit; limit*=2. ) ++bin;
+
+  // A few query names : a linear search
+  boost::mutex::scoped_lock lock(theMutex);
+  unsigned iQuery = 0;
+  while ( iQuery < theQueries.size() && 
+	  theQueries[iQuery].name != name && std::strcmp(theQueries[iQuery].name,name) ) ++iQuery;
+  if ( iQuery == theQueries.size() ) { 
+    QueryStatistics query;
+    query.name = name;
+    query.count = 0;
+    query.sum = 0.;
+    query.max = 0.;
+    std::fill(query.histogram,query.histogram+nQueryBins,0UL);
+    theQueries.push_back(query);
+  }
+  QueryStatistics& query = theQueries[iQuery];
+  ++query.count;
+  query.sum += duration;
+  if ( duration > query.max ) query.max = duration;
+  ++query.histogram[bin];
+
+}
+
+void
+TrackerGeometryProfiler::add(const TrackerGeometryProfiler& other) { 
+
+  // The earlier origin of the two, for positive times
+  double shift = other.theOrigin-theOrigin;
+  if ( shift < 0. ) { 
+    for ( unsigned i=0; i<theRecords.size(); ++i ) theRecords[i].start -= shift;
+    theOrigin = other.theOrigin;
+    shift = 0.;
+  }
+  for ( unsigned i=0; i<other.theRecords.size(); ++i ) { 
+    Record record = other.theRecords[i];
+    record.start += shift;
+    theRecords.push_back(record);
+  }
+
+}
+
+void
+TrackerGeometryProfiler::writeTrace() const { 
+
+  std::ofstream trace(theTraceFile.c_str());
+  if ( !trace ) { 
+    edm::LogWarning("TrackerInteractionGeometry") 
+      << "Cannot write the profile to " << theTraceFile;
+    return;
+  }
+
+  // Complete events ("X") for the construction phases, with the memory 
+  // change as an argument; the query statistics as trace metadata
+  trace << "{\"traceEvents\":[";
+  for ( unsigned i=0; i<theRecords.size(); ++i ) { 
+    const Record& record = theRecords[i];
+    if ( i ) trace << ",";
+    trace << "\n{\"name\":\"" << record.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+	  << "\"ts\":" << record.start << ",\"dur\":" << record.duration << ","
+	  << "\"args\":{\"allocated_bytes\":" << record.allocated << "}}";
+  }
+  trace << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{";
+  for ( unsigned i=0; i<theQueries.size(); ++i ) { 
+    const QueryStatistics& query = theQueries[i];
+    if ( i ) trace << ",";
+    trace << "\n\"" << query.name << "\":{\"count\":" << query.count 
+	  << ",\"total_us\":" << query.sum << ",\"max_us\":" << query.max 
+	  << ",\"histogram_log2_us\":[";
+    for ( unsigned bin=0; bin<nQueryBins; ++bin ) 
+      trace << (bin ? "," : "") << query.histogram[bin];
+    trace << "]}";
+  }
+  trace << "\n}}\n";
+
+}
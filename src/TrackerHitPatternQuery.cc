@@ -0,0 +1,111 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerHitPatternQuery.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerInteractionGeometry.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cmath>
+
+TrackerHitPatternQuery::TrackerHitPatternQuery(const TrackerInteractionGeometry& geometry) {
+
+  for ( unsigned side=0; side<2; ++side ) {
+    TrackerInteractionGeometry::Side theSide = static_cast<TrackerInteractionGeometry::Side>(side);
+    Layers& layers = theLayers[side];
+    for ( int iLayer=0; iLayer<geometry.nCylinders(theSide); ++iLayer ) {
+      const TrackerLayer& layer = geometry.layer(theSide,iLayer);
+      if ( layer.forward() ) {
+	layers.diskZ.push_back(std::abs(layer.diskZPosition()));
+	layers.diskInnerRadius.push_back(layer.diskInnerRadius());
+	layers.diskOuterRadius.push_back(layer.diskOuterRadius());
+	layers.diskBit.push_back(bit(layer.layerNumber()));
+      } else {
+	layers.cylinderRadius.push_back(layer.cylinderRadius());
+	layers.cylinderHalfLength.push_back(layer.cylinderHalfLength());
+	layers.cylinderBit.push_back(bit(layer.layerNumber()));
+      }
+    }
+  }
+
+}
+
+TrackerHitPatternQuery::HitPattern
+TrackerHitPatternQuery::hitPattern(const Helix& helix) const {
+
+  HitPattern pattern;
+  pattern.sensitive = 0;
+  pattern.dead = 0;
+
+  // The side of the direction, and z folded to it
+  TrackerInteractionGeometry::Side theSide = TrackerInteractionGeometry::side(
+    helix.dzdphi != 0.f ? helix.dzdphi : helix.z0);
+  double sign = 1.-2.*theSide;
+  double zf0 = sign*helix.z0;
+  double dzf = sign*helix.dzdphi;
+  const Layers& layers = theLayers[theSide];
+
+  // The transverse circle : distance of its center to the beam line, and
+  // the turning angle of its point farthest from the beam line (half a
+  // turn if it is centered on the beam line)
+  double R = helix.radius;
+  double d = std::sqrt(helix.xc*helix.xc+helix.yc*helix.yc);
+  double phiC = std::atan2(helix.yc,helix.xc);
+  double aMax = M_PI;
+  if ( d > 1E-6*R ) {
+    aMax = std::fmod(helix.q*(phiC-helix.phi0),2.*M_PI);
+    if ( aMax < 0. ) aMax += 2.*M_PI;
+  }
+
+  // Cylinders : the radius r is reached at the angle b before aMax, with
+  // r^2 = d^2 + R^2 + 2 R d cos(b)
+  if ( d > 1E-6*R ) {
+    for ( unsigned i=0; i<layers.cylinderRadius.size(); ++i ) {
+      double r = layers.cylinderRadius[i];
+      double k = (r*r-d*d-R*R)/(2.*R*d);
+      if ( k > 1. || k < -1. ) continue;
+      double a = aMax - std::acos(k);
+      if ( a < 0. ) continue;
+      if ( std::abs(zf0+a*dzf) > layers.cylinderHalfLength[i] ) continue;
+      set(pattern,layers.cylinderBit[i]);
+    }
+  }
+
+  // Disks : z is reached at the angle a, which must come before aMax
+  if ( dzf > 0. ) {
+    for ( unsigned i=0; i<layers.diskZ.size(); ++i ) {
+      double a = (layers.diskZ[i]-zf0)/dzf;
+      if ( a < 0. || a > aMax ) continue;
+      double r2 = d*d + R*R + 2.*R*d*std::cos(helix.phi0+helix.q*a-phiC);
+      double rIn = layers.diskInnerRadius[i];
+      double rOut = layers.diskOuterRadius[i];
+      if ( r2 < rIn*rIn || r2 > rOut*rOut ) continue;
+      set(pattern,layers.diskBit[i]);
+    }
+  }
+
+  return pattern;
+
+}
+
+void
+TrackerHitPatternQuery::hitPatterns(const std::vector<Helix>& helices,
+				    std::vector<HitPattern>& patterns) const {
+  patterns.resize(helices.size());
+  for ( unsigned i=0; i<helices.size(); ++i )
+    patterns[i] = hitPattern(helices[i]);
+}
+
+unsigned
+TrackerHitPatternQuery::count(const HitPattern& pattern) {
+  unsigned n = 0;
+  for ( unsigned long long bits=pattern.sensitive; bits; bits &= bits-1 ) ++n;
+  for ( unsigned long long bits=pattern.dead; bits; bits &= bits-1 ) ++n;
+  return n;
+}
+
+unsigned short
+TrackerHitPatternQuery::bit(unsigned layerNumber) {
+  if ( layerNumber < 64 ) return layerNumber;
+  if ( layerNumber >= 100 && layerNumber < 164 ) return 64+layerNumber-100;
+  throw cms::Exception("FastSimulation/TrackerHitPatternQuery")
+    << "Layer number " << layerNumber << " has no bit in the hit patterns "
+    << "(sensitive layers 0 to 63, dead material 100 to 163)";
+}
@@ -1,6 +1,7 @@
 //Framework Headers
 #include "FWCore/Utilities/interface/Exception.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
 
 //CMSSW Headers
 #include "DataFormats/GeometrySurface/interface/Surface.h"
@@ -16,23 +17,187 @@
 
 //FAMOS Headers
 #include "FastSimulation/TrackerSetup/interface/TrackerInteractionGeometry.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerModuleGrid.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerMaterialMap.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerMaterialVoxelGrid.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerMaterialSamplingTables.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerPairTables.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerEffectThresholds.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerIndex.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerPositions.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerMaterialTables.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerCompactLayerTable.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerGeometryProfiler.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerWorkerPool.h"
 
 #include<iostream>
+#include<algorithm>
+#include<cmath>
+#include<cstddef>
+#include<map>
+#include<sstream>
+
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace { 
+  template <class T, std::size_t N>
+  void assign(std::vector<T>& vec, const T (&table)[N]) { vec.assign(table,table+N); }
+
+  // The module grids to fill, taken one at a time by the worker threads
+  struct ModuleGridJobs { 
+    ModuleGridJobs(unsigned nPhi, unsigned nU) : nPhi(nPhi), nU(nU), next(0) {}
+    void add(TrackerLayer* layer, const GeometricSearchDet* detLayer) { 
+      layers.push_back(layer);
+      detLayers.push_back(detLayer);
+      grids.push_back(0);
+    }
+    void work() { 
+      while ( true ) { 
+	unsigned iJob;
+	{ 
+	  boost::mutex::scoped_lock lock(mutex);
+	  if ( next == layers.size() ) break;
+	  iJob = next++;
+	}
+	grids[iJob] = new TrackerLayerModuleGrid(detLayers[iJob]->basicComponents(),
+						 layers[iJob]->forward(),nPhi,nU);
+      }
+    }
+    unsigned nPhi, nU;
+    std::vector<TrackerLayer*> layers;
+    std::vector<const GeometricSearchDet*> detLayers;
+    std::vector<TrackerLayerModuleGrid*> grids;
+    unsigned next;
+    boost::mutex mutex;
+  };
+}
 
 TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet& trackerMaterial,
 						       const GeometricSearchTracker* theGeomSearchTracker)
 {
 
+  _theProfiler = TrackerGeometryProfiler::create(trackerMaterial);
+  clearFixedDeadMaterial();
+
+  // Take the active layer positions from the Tracker Reco Geometry
+  if ( theGeomSearchTracker ) { 
+    if ( _theProfiler ) _theProfiler->begin("active layer extraction");
+    TrackerLayerPositions thePositions(*theGeomSearchTracker);
+    if ( _theProfiler ) _theProfiler->end();
+    initialize(trackerMaterial,&thePositions);
+  } else { 
+    initialize(trackerMaterial,0);
+  }
+
+  // Module lookup grids of the sensitive layers
+  if ( use_hardcoded && theGeomSearchTracker && 
+       trackerMaterial.getUntrackedParameter<bool>("module_grids",false) ) { 
+    TrackerGeometryProfiler::Scope scope(_theProfiler,"module grids");
+    buildModuleGrids(theGeomSearchTracker,
+		     trackerMaterial.getUntrackedParameter<unsigned>("module_grids_phi_bins",128),
+		     trackerMaterial.getUntrackedParameter<unsigned>("module_grids_u_bins",32),
+		     trackerMaterial.getUntrackedParameter<unsigned>("module_grids_threads",4));
+  }
+
+  if ( _theProfiler ) _theProfiler->summarizeConstruction();
+
+}
+
+TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet& trackerMaterial,
+						       const TrackerLayerPositions* thePositions)
+{
+  _theProfiler = TrackerGeometryProfiler::create(trackerMaterial);
+  clearFixedDeadMaterial();
+  initialize(trackerMaterial,thePositions);
+  if ( _theProfiler ) _theProfiler->summarizeConstruction();
+}
+
+TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet& trackerMaterial)
+{
+  _theProfiler = TrackerGeometryProfiler::create(trackerMaterial);
+  clearFixedDeadMaterial();
+  // Nothing else is built until build() is called
+  _theNeutralTemplates = 0;
+  _theCompactTable = 0;
+  _theEnergyLossTables = 0;
+  _theEnergyLossDensity = 0;
+  _theLayerPairTables = 0;
+  _theEffectThresholds = 0;
+  _theConversionTables = 0;
+  _theVoxelGrid[PositiveZ] = 0;
+  _theVoxelGrid[NegativeZ] = 0;
+  _theLayerIndex[PositiveZ] = 0;
+  _theLayerIndex[NegativeZ] = 0;
+  if ( trackerMaterial.getParameter<bool>("use_hardcoded_geometry") ) 
+    prepareDeadMaterial(trackerMaterial);
+}
+
+void
+TrackerInteractionGeometry::build(const edm::ParameterSet& trackerMaterial,
+				  const TrackerLayerPositions* thePositions)
+{
+  initialize(trackerMaterial,thePositions);
+  if ( _theProfiler ) _theProfiler->summarizeConstruction();
+}
+
+void
+TrackerInteractionGeometry::clearFixedDeadMaterial()
+{
+  _deadMaterialReady = false;
+  for ( unsigned i=0; i<16; ++i ) { 
+    _theFixedCylinders[i] = 0;
+    _theFixedDisks[i] = 0;
+  }
+}
+
+void
+TrackerInteractionGeometry::initialize(const edm::ParameterSet& trackerMaterial,
+				       const TrackerLayerPositions* thePositions)
+{
+
+  _theSides[PositiveZ] = &_theCylinders;
+  _theSides[NegativeZ] = &_theNegativeCylinders;
+  _theSideLayers[PositiveZ] = &_theLayers;
+  _theSideLayers[NegativeZ] = &_theNegativeLayers;
+  _theLayerIndex[PositiveZ] = 0;
+  _theLayerIndex[NegativeZ] = 0;
+  _theMisalignmentMargin = 0.;
+
+  // The optional tables and grids, built at the end. materialBudget is 
+  // called before (dead layer merging) : it must use the surfaces until 
+  // then.
+  _theEnergyLossTables = 0;
+  _theEnergyLossDensity = 0;
+  _theConversionTables = 0;
+  _theCompactTable = 0;
+  _theLayerPairTables = 0;
+  _theNeutralTemplates = 0;
+  _theEffectThresholds = 0;
+  _theVoxelGrid[PositiveZ] = 0;
+  _theVoxelGrid[NegativeZ] = 0;
+  _useVoxels = false;
+
+  // Only the layers reaching into a region are built, for jobs that do 
+  // not propagate beyond it (e.g., the pixel volume). Negative values 
+  // mean no limit.
+  _theRegionMaxRadius = trackerMaterial.getParameter<double>("region_max_radius");
+  _theRegionMaxZ = trackerMaterial.getParameter<double>("region_max_z");
+  bool restricted = _theRegionMaxRadius > 0. || _theRegionMaxZ > 0.;
+  if ( _theRegionMaxRadius <= 0. ) _theRegionMaxRadius = 1E9;
+  if ( _theRegionMaxZ <= 0. ) _theRegionMaxZ = 1E9;
+
   use_hardcoded = trackerMaterial.getParameter<bool >("use_hardcoded_geometry"); 
 
   if(!use_hardcoded){
+    if ( _theProfiler ) _theProfiler->begin("parameter fetch");
     std::vector<double> disk_thickness = trackerMaterial.getParameter<std::vector<double> >("disk_thickness");
     std::vector<double> disk_inner_radius = trackerMaterial.getParameter<std::vector<double> >("disk_inner_radius");
     std::vector<double> disk_outer_radius = trackerMaterial.getParameter<std::vector<double> >("disk_outer_radius");
     std::vector<double> disk_z = trackerMaterial.getParameter<std::vector<double> >("disk_z");
     
     assert(disk_inner_radius.size() == disk_outer_radius.size() && disk_inner_radius.size() == disk_z.size() && disk_inner_radius.size() ==  disk_thickness.size());
-    std::cout << "number of disk layers = " << disk_z.size() << std::endl;
+    edm::LogInfo("TrackerInteractionGeometry") << "Number of disk layers = " << disk_z.size();
     
     const Surface::RotationType theRotation2(1.,0.,0.,0.,1.,0.,0.,0.,1.);
         
@@ -41,8 +206,68 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     std::vector<double> barrel_length = trackerMaterial.getParameter<std::vector<double> >("barrel_length");
     
     assert(barrel_length.size() == barrel_radius.size() && barrel_length.size() ==  barrel_thickness.size());
-    std::cout << "number of barrel layers = " << barrel_length.size() << std::endl;
-    
+    edm::LogInfo("TrackerInteractionGeometry") << "Number of barrel layers = " << barrel_length.size();
+
+    // The material of the negative side, if different from the positive side
+    std::vector<double> disk_thickness_negative = disk_thickness;
+    if ( trackerMaterial.existsAs<std::vector<double> >("disk_thickness_negative") &&
+	 !trackerMaterial.getParameter<std::vector<double> >("disk_thickness_negative").empty() )
+      disk_thickness_negative = trackerMaterial.getParameter<std::vector<double> >("disk_thickness_negative");
+    std::vector<double> barrel_thickness_negative = barrel_thickness;
+    if ( trackerMaterial.existsAs<std::vector<double> >("barrel_thickness_negative") &&
+	 !trackerMaterial.getParameter<std::vector<double> >("barrel_thickness_negative").empty() )
+      barrel_thickness_negative = trackerMaterial.getParameter<std::vector<double> >("barrel_thickness_negative");
+    assert(disk_thickness_negative.size() == disk_thickness.size() && barrel_thickness_negative.size() == barrel_thickness.size());
+
+    // Barrel layers with modules tilted towards the interaction point
+    // beyond some |z| (empty : no tilt)
+    std::vector<double> barrel_tilt(barrel_length.size(),0.);
+    std::vector<double> barrel_tilt_z_min(barrel_length.size(),0.);
+    if ( trackerMaterial.existsAs<std::vector<double> >("barrel_tilt") &&
+	 !trackerMaterial.getParameter<std::vector<double> >("barrel_tilt").empty() ) { 
+      barrel_tilt = trackerMaterial.getParameter<std::vector<double> >("barrel_tilt");
+      barrel_tilt_z_min = trackerMaterial.getParameter<std::vector<double> >("barrel_tilt_z_min");
+    }
+    assert(barrel_tilt.size() == barrel_length.size() && barrel_tilt_z_min.size() == barrel_length.size());
+    if ( _theProfiler ) _theProfiler->end();
+
+    // Fudge factors for layer inhomogeneities, per barrel and per disk layer
+    if ( _theProfiler ) _theProfiler->begin("fudge grouping");
+    std::vector< std::vector<double> > barrelFudgeMin(barrel_length.size());
+    std::vector< std::vector<double> > barrelFudgeMax(barrel_length.size());
+    std::vector< std::vector<double> > barrelFudgeFactor(barrel_length.size());
+    flexibleFudgeFactors(trackerMaterial,"barrel",barrelFudgeMin,barrelFudgeMax,barrelFudgeFactor);
+    std::vector< std::vector<double> > diskFudgeMin(disk_z.size());
+    std::vector< std::vector<double> > diskFudgeMax(disk_z.size());
+    std::vector< std::vector<double> > diskFudgeFactor(disk_z.size());
+    flexibleFudgeFactors(trackerMaterial,"disk",diskFudgeMin,diskFudgeMax,diskFudgeFactor);
+    if ( _theProfiler ) _theProfiler->end();
+    if ( _theProfiler ) _theProfiler->begin("surface creation");
+    
+    // Sensitive (1) or dead (0) barrel and disk layers (empty : all 
+    // sensitive). Sensitive layers are numbered from 0 in the order of
+    // the nest, dead ones from 100, as in the hardcoded geometry.
+    std::vector<unsigned> barrel_sensitive(barrel_length.size(),1);
+    std::vector<unsigned> disk_sensitive(disk_z.size(),1);
+    if ( trackerMaterial.existsAs<std::vector<unsigned> >("barrel_sensitive") &&
+	 !trackerMaterial.getParameter<std::vector<unsigned> >("barrel_sensitive").empty() ) 
+      barrel_sensitive = trackerMaterial.getParameter<std::vector<unsigned> >("barrel_sensitive");
+    if ( trackerMaterial.existsAs<std::vector<unsigned> >("disk_sensitive") &&
+	 !trackerMaterial.getParameter<std::vector<unsigned> >("disk_sensitive").empty() ) 
+      disk_sensitive = trackerMaterial.getParameter<std::vector<unsigned> >("disk_sensitive");
+    if ( barrel_sensitive.size() != barrel_length.size() || disk_sensitive.size() != disk_z.size() ) 
+      throw cms::Exception("FastSimulation/TrackerInteractionGeometry") 
+	<< "barrel_sensitive and disk_sensitive must have one entry per barrel and disk layer";
+    unsigned nSensitive = 0;
+    for ( unsigned i=0; i<barrel_sensitive.size(); ++i ) if ( barrel_sensitive[i] ) ++nSensitive;
+    for ( unsigned j=0; j<disk_sensitive.size(); ++j ) if ( disk_sensitive[j] ) ++nSensitive;
+    if ( nSensitive > 100 ) 
+      throw cms::Exception("FastSimulation/TrackerInteractionGeometry") 
+	<< "The flexible geometry has " << nSensitive << " sensitive layers : at most 100 can be numbered"
+	<< " apart from the dead material (from 100 on). Flag some of them dead with barrel_sensitive or disk_sensitive.";
+    unsigned sensitiveNr = 0;
+    unsigned deadNr = 100;
+
     const Surface::PositionType thePosition(0.,0.,0.);
     const Surface::RotationType theRotation(1.,0.,0.,0.,1.,0.,0.,0.,1.);
     
@@ -63,18 +288,29 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
 	assert(0);
       
       if(add_disk){
-	_mediumProperties.push_back(new MediumProperties(disk_thickness[j],0.0001));  
 	
+	// Numbered even if not built, so that numbers do not depend on the region
+	unsigned layerNr = disk_sensitive[j] ? sensitiveNr++ : deadNr++;
+
+	// Outside the region : not built at all
+	if ( !reachesRegion(true,disk_inner_radius[j],disk_z[j]) ) { 
+	  j++;
+	  continue;
+	}
+
 	const SimpleDiskBounds diskBounds(disk_inner_radius[j],disk_outer_radius[j],-0.0150,+0.0150);
 	const Surface::PositionType positionType(0.,0.,disk_z[j]);
 	
-	unsigned layerNr = i+j;
 	BoundDisk* theDisk = new BoundDisk(positionType,theRotation2,diskBounds);
-	theDisk->setMediumProperties(*_mediumProperties[_mediumProperties.size() -1 ]);
+	theDisk->setMediumProperties(*medium(disk_thickness[j]));
+	TrackerLayer theLayer(theDisk,true,layerNr,
+			      diskFudgeMin[j],diskFudgeMax[j],diskFudgeFactor[j]);
+	theLayer.setSensitive(disk_sensitive[j]);
+	if ( disk_thickness_negative[j] > 0. ) 
+	  _theNegativeCylinders.push_back(negativeLayer(theLayer,disk_thickness_negative[j],-disk_z[j],
+							disk_inner_radius[j],disk_outer_radius[j]));
 	if ( theDisk->mediumProperties().radLen() > 0. ) 
-	  _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
-					       std::vector<double>(),std::vector<double>(),
-					       std::vector<double>()));
+	  _theCylinders.push_back(theLayer);
 	else
 	  delete theDisk;
 	
@@ -86,17 +322,26 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
 	  
 	  // Create the nest of cylinders
 	  
+	  unsigned layerNr = barrel_sensitive[i] ? sensitiveNr++ : deadNr++;
+
+	  if ( !reachesRegion(false,barrel_radius[i],0.) ) { 
+	    i++;
+	    continue;
+	  }
+
 	  const SimpleCylinderBounds  cylBounds(  barrel_radius[i]-0.0150, barrel_radius[i]+0.0150, -barrel_length[i]/2, +barrel_length[i]/2);
 	  
-	  _mediumProperties.push_back(new MediumProperties(barrel_thickness[i],0.0001));  
 	  
-	  unsigned layerNr = i+j;
 	  BoundCylinder* theCylinder = new BoundCylinder(thePosition,theRotation,cylBounds);
-	  theCylinder->setMediumProperties(*_mediumProperties[_mediumProperties.size() -1 ]);
+	  theCylinder->setMediumProperties(*medium(barrel_thickness[i]));
+	  TrackerLayer theLayer(theCylinder,false,layerNr,
+				barrelFudgeMin[i],barrelFudgeMax[i],barrelFudgeFactor[i]);
+	  theLayer.setSensitive(barrel_sensitive[i]);
+	  theLayer.setTilt(barrel_tilt[i],barrel_tilt_z_min[i]);
+	  if ( barrel_thickness_negative[i] > 0. ) 
+	    _theNegativeCylinders.push_back(negativeLayer(theLayer,barrel_thickness_negative[i],0.,0.,0.));
 	  if ( theCylinder->mediumProperties().radLen() > 0. ) 
-	    _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
-						 std::vector<double>(),std::vector<double>(),
-						 std::vector<double>()));
+	    _theCylinders.push_back(theLayer);
 
 	  else
 	    delete theCylinder;
@@ -104,6 +349,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
 	  i++;
 	}
     }
+    if ( _theProfiler ) _theProfiler->end();
   }
   else {
     // Fraction of radiation length : had oc values to account 
@@ -113,189 +359,21 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     //        in terms or radiation length.
     
     
-    // Thickness of all layers
-    // Version of the material description
-    version = trackerMaterial.getParameter<unsigned int>("TrackerMaterialVersion");
-    // Beam Pipe
-    beamPipeThickness = trackerMaterial.getParameter<std::vector<double> >("BeamPipeThickness");
-    // Pixel Barrel Layers 1-3
-    pxbThickness = trackerMaterial.getParameter<std::vector<double> >("PXBThickness");
-    // Pixel Barrel services at the end of layers 1-3
-    pxb1CablesThickness = trackerMaterial.getParameter<std::vector<double> >("PXB1CablesThickness");
-    pxb2CablesThickness = trackerMaterial.getParameter<std::vector<double> >("PXB2CablesThickness");
-    pxb3CablesThickness = trackerMaterial.getParameter<std::vector<double> >("PXB3CablesThickness");
-    // Pixel Barrel outside cables
-    pxbOutCables1Thickness = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables1Thickness");
-    pxbOutCables2Thickness = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables2Thickness");
-    // Pixel Disks 1-2
-    pxdThickness = trackerMaterial.getParameter<std::vector<double> >("PXDThickness");
-    // Pixel Endcap outside cables
-    pxdOutCables1Thickness = trackerMaterial.getParameter<std::vector<double> >("PXDOutCables1Thickness");
-    pxdOutCables2Thickness = trackerMaterial.getParameter<std::vector<double> >("PXDOutCables2Thickness");
-    // Tracker Inner barrel layers 1-4
-    tibLayer1Thickness = trackerMaterial.getParameter<std::vector<double> >("TIBLayer1Thickness");
-    tibLayer2Thickness = trackerMaterial.getParameter<std::vector<double> >("TIBLayer2Thickness");
-    tibLayer3Thickness = trackerMaterial.getParameter<std::vector<double> >("TIBLayer3Thickness");
-    tibLayer4Thickness = trackerMaterial.getParameter<std::vector<double> >("TIBLayer4Thickness");
-    // TIB outside services (endcap)
-    tibOutCables1Thickness = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables1Thickness");
-    tibOutCables2Thickness = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables2Thickness");
-    // Tracker Inner disks layers 1-3
-    tidLayer1Thickness = trackerMaterial.getParameter<std::vector<double> >("TIDLayer1Thickness");
-    tidLayer2Thickness = trackerMaterial.getParameter<std::vector<double> >("TIDLayer2Thickness");
-    tidLayer3Thickness = trackerMaterial.getParameter<std::vector<double> >("TIDLayer3Thickness");
-    // TID outside wall (endcap)
-    tidOutsideThickness = trackerMaterial.getParameter<std::vector<double> >("TIDOutsideThickness");
-    // TOB inside wall (barrel)
-    tobInsideThickness = trackerMaterial.getParameter<std::vector<double> >("TOBInsideThickness");
-    // Tracker Outer barrel layers 1-6
-    tobLayer1Thickness = trackerMaterial.getParameter<std::vector<double> >("TOBLayer1Thickness");
-    tobLayer2Thickness = trackerMaterial.getParameter<std::vector<double> >("TOBLayer2Thickness");
-    tobLayer3Thickness = trackerMaterial.getParameter<std::vector<double> >("TOBLayer3Thickness");
-    tobLayer4Thickness = trackerMaterial.getParameter<std::vector<double> >("TOBLayer4Thickness");
-    tobLayer5Thickness = trackerMaterial.getParameter<std::vector<double> >("TOBLayer5Thickness");
-    tobLayer6Thickness = trackerMaterial.getParameter<std::vector<double> >("TOBLayer6Thickness");
-    // TOB services (endcap)
-    tobOutsideThickness = trackerMaterial.getParameter<std::vector<double> >("TOBOutsideThickness");
-    // Tracker EndCap disks layers 1-9
-    tecLayerThickness = trackerMaterial.getParameter<std::vector<double> >("TECLayerThickness");
-    // TOB outside wall (barrel)
-    barrelCablesThickness = trackerMaterial.getParameter<std::vector<double> >("BarrelCablesThickness");
-    // TEC outside wall (endcap)
-    endcapCables1Thickness = trackerMaterial.getParameter<std::vector<double> >("EndcapCables1Thickness");
-    endcapCables2Thickness = trackerMaterial.getParameter<std::vector<double> >("EndcapCables2Thickness");
-    
-    // Position of dead material layers (cables, services, etc.)
-    // Beam pipe
-    beamPipeRadius = trackerMaterial.getParameter<std::vector<double> >("BeamPipeRadius");
-    beamPipeLength = trackerMaterial.getParameter<std::vector<double> >("BeamPipeLength");
-    // Cables and Services at the end of PIXB1,2,3 ("disk")
-    pxb1CablesInnerRadius = trackerMaterial.getParameter<std::vector<double> >("PXB1CablesInnerRadius");
-    pxb2CablesInnerRadius = trackerMaterial.getParameter<std::vector<double> >("PXB2CablesInnerRadius");
-    pxb3CablesInnerRadius = trackerMaterial.getParameter<std::vector<double> >("PXB3CablesInnerRadius");
-    // Pixel Barrel Outside walls and cables
-    pxbOutCables1InnerRadius = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables1InnerRadius");
-    pxbOutCables1OuterRadius = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables1OuterRadius");
-    pxbOutCables1ZPosition = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables1ZPosition");
-    pxbOutCables2InnerRadius = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables2InnerRadius");
-    pxbOutCables2OuterRadius = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables2OuterRadius");
-    pxbOutCables2ZPosition = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables2ZPosition");
-    // Pixel Outside walls and cables (barrel and endcaps)
-    pixelOutCablesRadius = trackerMaterial.getParameter<std::vector<double> >("PixelOutCablesRadius");
-    pixelOutCablesLength = trackerMaterial.getParameter<std::vector<double> >("PixelOutCablesLength");
-    pixelOutCablesInnerRadius = trackerMaterial.getParameter<std::vector<double> >("PixelOutCablesInnerRadius");
-    pixelOutCablesOuterRadius = trackerMaterial.getParameter<std::vector<double> >("PixelOutCablesOuterRadius");
-    pixelOutCablesZPosition = trackerMaterial.getParameter<std::vector<double> >("PixelOutCablesZPosition");
-    // Tracker Inner Barrel Outside Cables and walls (endcap) 
-    tibOutCables1InnerRadius = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables1InnerRadius");
-    tibOutCables1OuterRadius = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables1OuterRadius");
-    tibOutCables1ZPosition = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables1ZPosition");
-    tibOutCables2InnerRadius = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables2InnerRadius");
-    tibOutCables2OuterRadius = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables2OuterRadius");
-    tibOutCables2ZPosition = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables2ZPosition");
-    // Tracker outer barrel Inside wall (barrel)
-    tobInCablesRadius = trackerMaterial.getParameter<std::vector<double> >("TOBInCablesRadius");
-    tobInCablesLength = trackerMaterial.getParameter<std::vector<double> >("TOBInCablesLength");
-    // Tracker Inner Disks Outside Cables and walls
-    tidOutCablesInnerRadius = trackerMaterial.getParameter<std::vector<double> >("TIDOutCablesInnerRadius");
-    tidOutCablesZPosition = trackerMaterial.getParameter<std::vector<double> >("TIDOutCablesZPosition");
-    // Tracker Outer Barrel Outside Cables and walls (barrel and endcaps)
-    tobOutCablesInnerRadius = trackerMaterial.getParameter<std::vector<double> >("TOBOutCablesInnerRadius");
-    tobOutCablesOuterRadius = trackerMaterial.getParameter<std::vector<double> >("TOBOutCablesOuterRadius");
-    tobOutCablesZPosition = trackerMaterial.getParameter<std::vector<double> >("TOBOutCablesZPosition");
-    tobOutCablesRadius = trackerMaterial.getParameter<std::vector<double> >("TOBOutCablesRadius");
-    tobOutCablesLength = trackerMaterial.getParameter<std::vector<double> >("TOBOutCablesLength");
-    // Tracker Endcaps Outside Cables and walls
-    tecOutCables1InnerRadius = trackerMaterial.getParameter<std::vector<double> >("TECOutCables1InnerRadius");
-    tecOutCables1OuterRadius = trackerMaterial.getParameter<std::vector<double> >("TECOutCables1OuterRadius");
-    tecOutCables1ZPosition = trackerMaterial.getParameter<std::vector<double> >("TECOutCables1ZPosition");
-    tecOutCables2InnerRadius = trackerMaterial.getParameter<std::vector<double> >("TECOutCables2InnerRadius");
-    tecOutCables2OuterRadius = trackerMaterial.getParameter<std::vector<double> >("TECOutCables2OuterRadius");
-    tecOutCables2ZPosition = trackerMaterial.getParameter<std::vector<double> >("TECOutCables2ZPosition");
-    
-    // Fudge factors for tracker layer material inhomogeneities
-    fudgeLayer = trackerMaterial.getParameter<std::vector<unsigned int> >("FudgeLayer");
-    fudgeMin = trackerMaterial.getParameter<std::vector<double> >("FudgeMin");
-    fudgeMax = trackerMaterial.getParameter<std::vector<double> >("FudgeMax");
-    fudgeFactor = trackerMaterial.getParameter<std::vector<double> >("FudgeFactor");
-    
-    // The previous std::vector must have the same size!
-    if ( fudgeLayer.size() != fudgeMin.size() ||  
-	 fudgeLayer.size() != fudgeMax.size() ||  
-	 fudgeLayer.size() != fudgeFactor.size() ) {
-      throw cms::Exception("FastSimulation/TrackerInteractionGeometry ") 
-	<< " WARNING with fudge factors !  You have " << fudgeLayer.size() 
-	<< " layers, but " 
-	<< fudgeMin.size() << " min values, "
-	<< fudgeMax.size() << " max values and "
-	<< fudgeFactor.size() << " fudge factor values!"
-	<< std::endl
-	<< "Please make enter the same number of inputs " 
-	<< "in FastSimulation/TrackerInteractionGeometry/data/TrackerMaterial.cfi"
-	<< std::endl;
-    }
-    
-    // The Beam pipe
-    _theMPBeamPipe = new MediumProperties(beamPipeThickness[version],0.0001);  
-    // The pixel barrel layers
-    _theMPPixelBarrel = new MediumProperties(pxbThickness[version],0.0001);  
-    // Pixel Barrel services at the end of layers 1-3
-    _theMPPixelOutside1 = new MediumProperties(pxb1CablesThickness[version],0.0001);  
-    _theMPPixelOutside2 = new MediumProperties(pxb2CablesThickness[version],0.0001);  
-    _theMPPixelOutside3 = new MediumProperties(pxb3CablesThickness[version],0.0001);  
-    // Pixel Barrel outside cables
-    _theMPPixelOutside4 = new MediumProperties(pxbOutCables1Thickness[version],0.0001);  
-    _theMPPixelOutside  = new MediumProperties(pxbOutCables2Thickness[version],0.0001);  
-    // The pixel endcap disks
-    _theMPPixelEndcap = new MediumProperties(pxdThickness[version],0.0001);  
-    // Pixel Endcap outside cables
-    _theMPPixelOutside5 = new MediumProperties(pxdOutCables1Thickness[version],0.0001);  
-    _theMPPixelOutside6 = new MediumProperties(pxdOutCables2Thickness[version],0.0001);  
-    // The tracker inner barrel layers 1-4
-    _theMPTIB1 = new MediumProperties(tibLayer1Thickness[version],0.0001);  
-    _theMPTIB2 = new MediumProperties(tibLayer2Thickness[version],0.0001);  
-    _theMPTIB3 = new MediumProperties(tibLayer3Thickness[version],0.0001);  
-    _theMPTIB4 = new MediumProperties(tibLayer4Thickness[version],0.0001);  
-    // TIB outside services (endcap)
-    _theMPTIBEOutside1 = new MediumProperties(tibOutCables1Thickness[version],0.0001);  
-    _theMPTIBEOutside2 = new MediumProperties(tibOutCables2Thickness[version],0.0001);  
-    // The tracker inner disks 1-3
-    _theMPInner1 = new MediumProperties(tidLayer1Thickness[version],0.0001);  
-    _theMPInner2 = new MediumProperties(tidLayer2Thickness[version],0.0001);  
-    _theMPInner3 = new MediumProperties(tidLayer3Thickness[version],0.0001);  
-    // TID outside wall (endcap)
-    _theMPTIDEOutside = new MediumProperties(tidOutsideThickness[version],0.0001);  
-    // TOB inside wall (barrel)
-    _theMPTOBBInside = new MediumProperties(tobInsideThickness[version],0.0001);  
-    // The tracker outer barrel layers 1-6
-    _theMPTOB1 = new MediumProperties(tobLayer1Thickness[version],0.0001);  
-    _theMPTOB2 = new MediumProperties(tobLayer2Thickness[version],0.0001);  
-    _theMPTOB3 = new MediumProperties(tobLayer3Thickness[version],0.0001);  
-    _theMPTOB4 = new MediumProperties(tobLayer4Thickness[version],0.0001);  
-    _theMPTOB5 = new MediumProperties(tobLayer5Thickness[version],0.0001);  
-    _theMPTOB6 = new MediumProperties(tobLayer6Thickness[version],0.0001);  
-    // TOB services (endcap)
-    _theMPTOBEOutside = new MediumProperties(tobOutsideThickness[version],0.0001);  
-    // The tracker endcap disks 1-9
-    _theMPEndcap = new MediumProperties(tecLayerThickness[version],0.0001);  
-    // TOB outside wall (barrel)
-    _theMPBarrelOutside = new MediumProperties(barrelCablesThickness[version],0.0001);  
-    // TEC outside wall (endcap)
-    _theMPEndcapOutside = new MediumProperties(endcapCables1Thickness[version],0.0001);  
-    _theMPEndcapOutside2 = new MediumProperties(endcapCables2Thickness[version],0.0001);  
-    
-    // Check that the Reco Tracker Geometry has been loaded
-    if ( !theGeomSearchTracker ) 
+    // The material tables, the media and the dead material that does not
+    // depend on the active layer positions, unless prepared beforehand
+    if ( !_deadMaterialReady ) prepareDeadMaterial(trackerMaterial);
+    _deadMaterialReady = false;
+    if ( _theProfiler ) _theProfiler->begin("surface creation");
+
+    // Check that the active layer positions have been loaded
+    if ( !thePositions ) 
       throw cms::Exception("FastSimulation/TrackerInteractionGeometry") 
-	<< "The pointer to the GeometricSearchTracker was not set"; 
-    
-    // The vector of Barrel Tracker Layers 
-    std::vector< BarrelDetLayer*> barrelLayers = 
-      theGeomSearchTracker->barrelLayers();
-    
-    // The vector of Forward Tracker Layers (positive z)
-    std::vector< ForwardDetLayer*>  posForwardLayers = 
-      theGeomSearchTracker->posForwardLayers();
+	<< "The pointer to the TrackerLayerPositions was not set"; 
+    if ( thePositions->nBarrelLayers() < 13 || thePositions->nForwardLayers() < 14 ) 
+      throw cms::Exception("FastSimulation/TrackerInteractionGeometry") 
+	<< "The hardcoded geometry needs 13 barrel layers and 14 forward layers, but "
+	<< thePositions->nBarrelLayers() << " barrel layers and " 
+	<< thePositions->nForwardLayers() << " forward layers were found";
     
     // Local pointers
     BoundCylinder* theCylinder;
@@ -304,16 +382,11 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     // Create the nest of cylinders
     const Surface::PositionType thePosition(0.,0.,0.);
     const Surface::RotationType theRotation(1.,0.,0.,0.,1.,0.,0.,0.,1.);
-    // Beam Pipe
-    //  const SimpleCylinderBounds  PIPE( 0.997,   1.003,  -300., 300.);
-    const SimpleCylinderBounds  PIPE( beamPipeRadius[version]-0.003, beamPipeRadius[version]+0.003,  
-				      -beamPipeLength[version],       beamPipeLength[version]);
-    
     // Take the active layer position from the Tracker Reco Geometry
     // Pixel barrel
-    std::vector< BarrelDetLayer*>::const_iterator bl = barrelLayers.begin();
-    double maxLength = (**bl).specificSurface().bounds().length()/2.+1.7;
-    double maxRadius = (**bl).specificSurface().radius()+0.01;
+    unsigned bl = 0;
+    double maxLength = thePositions->barrelLength(bl)/2.+1.7;
+    double maxRadius = thePositions->barrelRadius(bl)+0.01;
     // First pixel barrel layer: r=4.41058, l=53.38
     const SimpleCylinderBounds  PIXB1( maxRadius-0.005, maxRadius+0.005, -maxLength, +maxLength);
     // "Cables" 
@@ -322,8 +395,8 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     
     // Second pixel barrel layer: r=7.30732, l=53.38
     ++bl;
-    maxLength = std::max( (**bl).specificSurface().bounds().length()/2.+1.7, maxLength+0.000 );
-    maxRadius = (**bl).specificSurface().radius();
+    maxLength = std::max( thePositions->barrelLength(bl)/2.+1.7, maxLength+0.000 );
+    maxRadius = thePositions->barrelRadius(bl);
     const SimpleCylinderBounds  PIXB2( maxRadius-0.005, maxRadius+0.005, -maxLength, +maxLength);
     
     // "Cables"
@@ -332,137 +405,106 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     
     // More cables
     ++bl;
-    maxRadius = (**bl).specificSurface().radius();
+    maxRadius = thePositions->barrelRadius(bl);
     const SimpleDiskBounds PIXBOut3(pxb3CablesInnerRadius[version],maxRadius,-0.5,0.5);
     const Surface::PositionType PPIXBOut3(0.0,0.0,maxLength);
     
     // Third pixel barrel layer: r=10.1726, l=53.38
-    maxLength = std::max( (**bl).specificSurface().bounds().length()/2.+1.7, maxLength+0.000 );
+    maxLength = std::max( thePositions->barrelLength(bl)/2.+1.7, maxLength+0.000 );
     const SimpleCylinderBounds  PIXB3( maxRadius-0.005, maxRadius+0.005, -maxLength, +maxLength);
     
-    // Pixel Barrel Outside walls and cables
-    const SimpleDiskBounds PIXBOut4( pxbOutCables1InnerRadius[version],pxbOutCables1OuterRadius[version],-0.5,0.5);
-    const Surface::PositionType PPIXBOut4(0.0,0.0,pxbOutCables1ZPosition[version]);
-    
-    const SimpleDiskBounds PIXBOut(pxbOutCables2InnerRadius[version],pxbOutCables2OuterRadius[version],-0.5,0.5);
-    const Surface::PositionType PPIXBOut(0.0,0.0,pxbOutCables2ZPosition[version]);
-    
-    const SimpleCylinderBounds  PIXBOut5( pixelOutCablesRadius[version]-0.1, pixelOutCablesRadius[version]+0.1, 
-					  -pixelOutCablesLength[version],     pixelOutCablesLength[version]);
-    
-    const SimpleDiskBounds PIXBOut6(pixelOutCablesInnerRadius[version],pixelOutCablesOuterRadius[version],-0.5,0.5);
-    const Surface::PositionType PPIXBOut6(0.0,0.0,pixelOutCablesZPosition[version]);
-    
     
     // Tracker Inner Barrel : thin detectors (300 microns)
     // First TIB layer: r=25.6786, l=130.04
     ++bl;
-    maxRadius = (**bl).specificSurface().radius();
-    maxLength = (**bl).specificSurface().bounds().length()/2.;
+    maxRadius = thePositions->barrelRadius(bl);
+    maxLength = thePositions->barrelLength(bl)/2.;
     const SimpleCylinderBounds  TIB1( maxRadius-0.0150, maxRadius+0.0150, -maxLength, +maxLength);
     // Second TIB layer: r=34.0341, l=131.999
     ++bl;
-    maxRadius = (**bl).specificSurface().radius();
-    maxLength = std::max( (**bl).specificSurface().bounds().length()/2., maxLength+0.000 );
+    maxRadius = thePositions->barrelRadius(bl);
+    maxLength = std::max( thePositions->barrelLength(bl)/2., maxLength+0.000 );
     const SimpleCylinderBounds  TIB2( maxRadius-0.0150, maxRadius+0.0150, -maxLength, +maxLength);
     // Third TIB layer: r=41.9599, l=131.628  !!!! Needs to be larger than TIB2
     ++bl;
-    maxRadius = (**bl).specificSurface().radius();
-    maxLength = std::max( (**bl).specificSurface().bounds().length()/2., maxLength+0.000 );
+    maxRadius = thePositions->barrelRadius(bl);
+    maxLength = std::max( thePositions->barrelLength(bl)/2., maxLength+0.000 );
     const SimpleCylinderBounds  TIB3( maxRadius-0.0150, maxRadius+0.0150, -maxLength, +maxLength);
     // Fourth TIB layer: r=49.8924, l=132.78
     ++bl;
-    maxRadius = (**bl).specificSurface().radius();
-    maxLength = std::max( (**bl).specificSurface().bounds().length()/2., maxLength+0.000 );
+    maxRadius = thePositions->barrelRadius(bl);
+    maxLength = std::max( thePositions->barrelLength(bl)/2., maxLength+0.000 );
     const SimpleCylinderBounds  TIB4( maxRadius-0.0150, maxRadius+0.0150, -maxLength, +maxLength);
     
-    // Inner Barrel Cylinder & Ends : Cables and walls
-    const SimpleDiskBounds TIBEOut(tibOutCables1InnerRadius[version],tibOutCables1OuterRadius[version],-0.05,0.05);
-    const Surface::PositionType PTIBEOut(0.0,0.0,tibOutCables1ZPosition[version]);
-    
-    const SimpleDiskBounds TIBEOut2(tibOutCables2InnerRadius[version],tibOutCables2OuterRadius[version],-0.05,0.05);
-    const Surface::PositionType PTIBEOut2(0.0,0.0,tibOutCables2ZPosition[version]);
-    
-    // Inner Tracker / Outer Barrel Wall
-    const SimpleCylinderBounds  TOBCIn ( tobInCablesRadius[version]-0.5, tobInCablesRadius[version]+0.5,
-					 -tobInCablesLength[version],     tobInCablesLength[version]);
-    
     // First TOB layer: r=60.7671, l=216.576
     ++bl;
-    maxRadius = (**bl).specificSurface().radius();
-    maxLength = (**bl).specificSurface().bounds().length()/2.+0.0;
+    maxRadius = thePositions->barrelRadius(bl);
+    maxLength = thePositions->barrelLength(bl)/2.+0.0;
     const SimpleCylinderBounds  TOB1( maxRadius-0.0150, maxRadius+0.0150, -maxLength, +maxLength);
     // Second TOB layer: r=69.3966, l=216.576
     ++bl;
-    maxRadius = (**bl).specificSurface().radius();
-    maxLength = std::max( (**bl).specificSurface().bounds().length()/2.+0.0, maxLength+0.000 );
+    maxRadius = thePositions->barrelRadius(bl);
+    maxLength = std::max( thePositions->barrelLength(bl)/2.+0.0, maxLength+0.000 );
     const SimpleCylinderBounds  TOB2( maxRadius-0.0150, maxRadius+0.0150, -maxLength, +maxLength);
     // Third TOB layer: r=78.0686, l=216.576
     ++bl;
-    maxRadius = (**bl).specificSurface().radius();
-    maxLength = std::max( (**bl).specificSurface().bounds().length()/2.+0.0, maxLength+0.000 );
+    maxRadius = thePositions->barrelRadius(bl);
+    maxLength = std::max( thePositions->barrelLength(bl)/2.+0.0, maxLength+0.000 );
     const SimpleCylinderBounds  TOB3( maxRadius-0.0150, maxRadius+0.0150, -maxLength, +maxLength);
     // Fourth TOB layer: r=86.8618, l=216.576
     ++bl;
-    maxRadius = (**bl).specificSurface().radius();
-    maxLength = std::max( (**bl).specificSurface().bounds().length()/2.+0.0, maxLength+0.000 );
+    maxRadius = thePositions->barrelRadius(bl);
+    maxLength = std::max( thePositions->barrelLength(bl)/2.+0.0, maxLength+0.000 );
     const SimpleCylinderBounds  TOB4( maxRadius-0.0150, maxRadius+0.0150, -maxLength, +maxLength);
     // Fifth TOB layer: r=96.5557, l=216.576
     ++bl;
-    maxRadius = (**bl).specificSurface().radius();
-    maxLength = std::max( (**bl).specificSurface().bounds().length()/2.+0.0, maxLength+0.000 );
+    maxRadius = thePositions->barrelRadius(bl);
+    maxLength = std::max( thePositions->barrelLength(bl)/2.+0.0, maxLength+0.000 );
     const SimpleCylinderBounds  TOB5( maxRadius-0.0150, maxRadius+0.0150, -maxLength, +maxLength);
     // Sixth TOB layer: r=108.05, l=216.576
     ++bl;
-    maxRadius = (**bl).specificSurface().radius();
-    maxLength = std::max( (**bl).specificSurface().bounds().length()/2.+0.0, maxLength+0.000 );
+    maxRadius = thePositions->barrelRadius(bl);
+    maxLength = std::max( thePositions->barrelLength(bl)/2.+0.0, maxLength+0.000 );
     const SimpleCylinderBounds  TOB6( maxRadius-0.0150, maxRadius+0.0150, -maxLength, +maxLength);
     
-    const SimpleDiskBounds TOBEOut(tobOutCablesInnerRadius[version],tobOutCablesOuterRadius[version],-0.5,0.5);
-    const Surface::PositionType PTOBEOut(0.0,0.0,tobOutCablesZPosition[version]);
-    
     const Surface::RotationType theRotation2(1.,0.,0.,0.,1.,0.,0.,0.,1.);
     
-    // Outside : Barrel
-    const SimpleCylinderBounds  TBOut ( tobOutCablesRadius[version]-0.5, tobOutCablesRadius[version]+0.5,
-					-tobOutCablesLength[version],     tobOutCablesLength[version]);
-    
     // And now the disks...
-    std::vector< ForwardDetLayer*>::const_iterator fl = posForwardLayers.begin();
+    unsigned fl = 0;
     
     // Pixel disks 
     // First Pixel disk: Z pos 35.5 radii 5.42078, 16.0756
-    double innerRadius = (**fl).specificSurface().innerRadius()-1.0;
-    double outerRadius = (**fl).specificSurface().outerRadius()+2.0;
+    double innerRadius = thePositions->forwardInnerRadius(PositiveZ,fl)-1.0;
+    double outerRadius = thePositions->forwardOuterRadius(PositiveZ,fl)+2.0;
     const SimpleDiskBounds PIXD1(innerRadius, outerRadius,-0.0150,+0.0150);
-    const Surface::PositionType PPIXD1(0.0,0.0,(**fl).surface().position().z()); 
+    const Surface::PositionType PPIXD1(0.0,0.0,thePositions->forwardZ(PositiveZ,fl)); 
     // Second Pixel disk: Z pos 48.5 radii 5.42078, 16.0756
     ++fl;
-    innerRadius = (**fl).specificSurface().innerRadius()-1.0;
-    outerRadius = std::max( (**fl).specificSurface().outerRadius()+2.0, outerRadius+0.000 );
+    innerRadius = thePositions->forwardInnerRadius(PositiveZ,fl)-1.0;
+    outerRadius = std::max( thePositions->forwardOuterRadius(PositiveZ,fl)+2.0, outerRadius+0.000 );
     const SimpleDiskBounds PIXD2(innerRadius, outerRadius,-0.0150,+0.0150);
-    const Surface::PositionType PPIXD2(0.0,0.0,(**fl).surface().position().z()); 
+    const Surface::PositionType PPIXD2(0.0,0.0,thePositions->forwardZ(PositiveZ,fl)); 
     
     // Tracker Inner disks (add 3 cm for the outer radius to simulate cables, 
     // and remove 1cm to inner radius to allow for some extrapolation margin)
     // First TID : Z pos 78.445 radii 23.14, 50.4337
     ++fl;
-    innerRadius = (**fl).specificSurface().innerRadius()-0.5;
-    outerRadius = (**fl).specificSurface().outerRadius()+3.5;
+    innerRadius = thePositions->forwardInnerRadius(PositiveZ,fl)-0.5;
+    outerRadius = thePositions->forwardOuterRadius(PositiveZ,fl)+3.5;
     const SimpleDiskBounds TID1(innerRadius,outerRadius,-0.0150,+0.0150);
-    const Surface::PositionType PTID1(0.,0.,(**fl).surface().position().z()); 
+    const Surface::PositionType PTID1(0.,0.,thePositions->forwardZ(PositiveZ,fl)); 
     // Second TID : Z pos 90.445 radii 23.14, 50.4337
     ++fl;
-    innerRadius = (**fl).specificSurface().innerRadius()-0.5;
-    outerRadius = std::max( (**fl).specificSurface().outerRadius()+3.5, outerRadius+0.000);
+    innerRadius = thePositions->forwardInnerRadius(PositiveZ,fl)-0.5;
+    outerRadius = std::max( thePositions->forwardOuterRadius(PositiveZ,fl)+3.5, outerRadius+0.000);
     const SimpleDiskBounds TID2(innerRadius,outerRadius,-0.0150,+0.0150);
-    const Surface::PositionType PTID2(0.,0.,(**fl).surface().position().z()); 
+    const Surface::PositionType PTID2(0.,0.,thePositions->forwardZ(PositiveZ,fl)); 
     // Third TID : Z pos 105.445 radii 23.14, 50.4337
     ++fl;
-    innerRadius = (**fl).specificSurface().innerRadius()-0.5;
-    outerRadius = std::max( (**fl).specificSurface().outerRadius()+3.5, outerRadius+0.000);
+    innerRadius = thePositions->forwardInnerRadius(PositiveZ,fl)-0.5;
+    outerRadius = std::max( thePositions->forwardOuterRadius(PositiveZ,fl)+3.5, outerRadius+0.000);
     const SimpleDiskBounds TID3(innerRadius,outerRadius,-0.0150,+0.0150);
-    const Surface::PositionType PTID3(0.,0.,(**fl).surface().position().z()); 
+    const Surface::PositionType PTID3(0.,0.,thePositions->forwardZ(PositiveZ,fl)); 
     
     // TID Wall and cables
     const SimpleDiskBounds TIDEOut(tidOutCablesInnerRadius[version],outerRadius+1.0,-0.5,0.5);
@@ -474,65 +516,58 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     // remove other 2cm to inner radius to allow for some extrapolation margin
     // First TEC: Z pos 131.892 radii 23.3749, 99.1967
     ++fl;
-    innerRadius = (**fl).specificSurface().innerRadius()-1.5;
-    outerRadius = (**fl).specificSurface().outerRadius()+2.0;
+    innerRadius = thePositions->forwardInnerRadius(PositiveZ,fl)-1.5;
+    outerRadius = thePositions->forwardOuterRadius(PositiveZ,fl)+2.0;
     const SimpleDiskBounds TEC1(innerRadius,outerRadius,-0.0150,+0.0150);
-    const Surface::PositionType PTEC1(0.,0,(**fl).surface().position().z()); 
+    const Surface::PositionType PTEC1(0.,0,thePositions->forwardZ(PositiveZ,fl)); 
     // Second TEC: Z pos 145.892 radii 23.3749, 99.1967
     ++fl;
-    innerRadius = (**fl).specificSurface().innerRadius()-1.5;
-    outerRadius = std::max( (**fl).specificSurface().outerRadius()+2.0, outerRadius+0.000 );
+    innerRadius = thePositions->forwardInnerRadius(PositiveZ,fl)-1.5;
+    outerRadius = std::max( thePositions->forwardOuterRadius(PositiveZ,fl)+2.0, outerRadius+0.000 );
     const SimpleDiskBounds TEC2(innerRadius,outerRadius,-0.0150,+0.0150);
-    const Surface::PositionType PTEC2(0.,0.,(**fl).surface().position().z());
+    const Surface::PositionType PTEC2(0.,0.,thePositions->forwardZ(PositiveZ,fl));
     // Third TEC: Z pos 159.892 radii 23.3749, 99.1967
     ++fl;
-    innerRadius = (**fl).specificSurface().innerRadius()-1.5;
-    outerRadius = std::max( (**fl).specificSurface().outerRadius()+2.0, outerRadius+0.000 );
+    innerRadius = thePositions->forwardInnerRadius(PositiveZ,fl)-1.5;
+    outerRadius = std::max( thePositions->forwardOuterRadius(PositiveZ,fl)+2.0, outerRadius+0.000 );
     const SimpleDiskBounds TEC3(innerRadius,outerRadius,-0.0150,+0.0150);
-    const Surface::PositionType PTEC3(0.,0.,(**fl).surface().position().z());
+    const Surface::PositionType PTEC3(0.,0.,thePositions->forwardZ(PositiveZ,fl));
     // Fourth TEC: Z pos 173.892 radii 32.1263, 99.1967
     ++fl;
-    innerRadius = (**fl).specificSurface().innerRadius()-2.5;
-    outerRadius = std::max( (**fl).specificSurface().outerRadius()+2.0, outerRadius+0.000 );
+    innerRadius = thePositions->forwardInnerRadius(PositiveZ,fl)-2.5;
+    outerRadius = std::max( thePositions->forwardOuterRadius(PositiveZ,fl)+2.0, outerRadius+0.000 );
     const SimpleDiskBounds TEC4(innerRadius,outerRadius,-0.0150,+0.0150);
-    const Surface::PositionType PTEC4(0.,0.,(**fl).surface().position().z());
+    const Surface::PositionType PTEC4(0.,0.,thePositions->forwardZ(PositiveZ,fl));
     // Fifth TEC: Z pos 187.892 radii 32.1263, 99.1967
     ++fl;
-    innerRadius = (**fl).specificSurface().innerRadius()-2.5;
-    outerRadius = std::max( (**fl).specificSurface().outerRadius()+2.0, outerRadius+0.000 );
+    innerRadius = thePositions->forwardInnerRadius(PositiveZ,fl)-2.5;
+    outerRadius = std::max( thePositions->forwardOuterRadius(PositiveZ,fl)+2.0, outerRadius+0.000 );
     const SimpleDiskBounds TEC5(innerRadius,outerRadius,-0.0150,+0.0150);
-    const Surface::PositionType PTEC5(0.,0.,(**fl).surface().position().z());
+    const Surface::PositionType PTEC5(0.,0.,thePositions->forwardZ(PositiveZ,fl));
     // Sixth TEC: Z pos 205.392 radii 32.1263, 99.1967
     ++fl;
-    innerRadius = (**fl).specificSurface().innerRadius()-2.5;
-    outerRadius = std::max( (**fl).specificSurface().outerRadius()+2.0, outerRadius+0.000 );
+    innerRadius = thePositions->forwardInnerRadius(PositiveZ,fl)-2.5;
+    outerRadius = std::max( thePositions->forwardOuterRadius(PositiveZ,fl)+2.0, outerRadius+0.000 );
     const SimpleDiskBounds TEC6(innerRadius,outerRadius,-0.0150,+0.0150);
-    const Surface::PositionType PTEC6(0.,0.,(**fl).surface().position().z());
+    const Surface::PositionType PTEC6(0.,0.,thePositions->forwardZ(PositiveZ,fl));
     // Seventh TEC: Z pos 224.121 radii 44.7432, 99.1967
     ++fl;
-    innerRadius = (**fl).specificSurface().innerRadius()-9.5;
-    outerRadius = std::max( (**fl).specificSurface().outerRadius()+2.0, outerRadius+0.000 );
+    innerRadius = thePositions->forwardInnerRadius(PositiveZ,fl)-9.5;
+    outerRadius = std::max( thePositions->forwardOuterRadius(PositiveZ,fl)+2.0, outerRadius+0.000 );
     const SimpleDiskBounds TEC7(innerRadius,outerRadius,-0.0150,+0.0150);
-    const Surface::PositionType PTEC7(0.,0.,(**fl).surface().position().z());
+    const Surface::PositionType PTEC7(0.,0.,thePositions->forwardZ(PositiveZ,fl));
     // Eighth TEC: Z pos 244.621 radii 44.7432, 99.1967
     ++fl;
-    innerRadius = (**fl).specificSurface().innerRadius()-9.5;
-    outerRadius = std::max( (**fl).specificSurface().outerRadius()+2.0, outerRadius+0.000 );
+    innerRadius = thePositions->forwardInnerRadius(PositiveZ,fl)-9.5;
+    outerRadius = std::max( thePositions->forwardOuterRadius(PositiveZ,fl)+2.0, outerRadius+0.000 );
     const SimpleDiskBounds TEC8(innerRadius,outerRadius,-0.0150,+0.0150);
-    const Surface::PositionType PTEC8(0.,0.,(**fl).surface().position().z());
+    const Surface::PositionType PTEC8(0.,0.,thePositions->forwardZ(PositiveZ,fl));
     // Nineth TEC: Z pos 266.121 radii 56.1781, 99.1967
     ++fl;
-    innerRadius = (**fl).specificSurface().innerRadius()-20.5;
-    outerRadius = std::max( (**fl).specificSurface().outerRadius()+2.0, outerRadius+0.000 );
+    innerRadius = thePositions->forwardInnerRadius(PositiveZ,fl)-20.5;
+    outerRadius = std::max( thePositions->forwardOuterRadius(PositiveZ,fl)+2.0, outerRadius+0.000 );
     const SimpleDiskBounds TEC9(innerRadius,outerRadius,-0.0150,+0.0150);
-    const Surface::PositionType PTEC9(0.,0.,(**fl).surface().position().z());
-    
-    // Outside : Endcap
-    const SimpleDiskBounds TEOut(tecOutCables1InnerRadius[version],tecOutCables1OuterRadius[version],-0.5,0.5);
-    const Surface::PositionType PTEOut(0.0,0.0,tecOutCables1ZPosition[version]);
-    
-    const SimpleDiskBounds TEOut2(tecOutCables2InnerRadius[version],tecOutCables2OuterRadius[version],-0.5,0.5);
-    const Surface::PositionType PTEOut2(0.0,0.0,tecOutCables2ZPosition[version]);
+    const Surface::PositionType PTEC9(0.,0.,thePositions->forwardZ(PositiveZ,fl));
     
     // The ordering of disks and cylinders is essential here
     // (from inside to outside)
@@ -542,10 +577,9 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     // Beam Pipe
     
     unsigned layerNr = 100;
-    theCylinder = new BoundCylinder(thePosition,theRotation,PIPE);
-    theCylinder->setMediumProperties(*_theMPBeamPipe);
+    theCylinder = fixedCylinder(layerNr);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -557,7 +591,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theCylinder = new BoundCylinder(thePosition,theRotation,PIXB1);
     theCylinder->setMediumProperties(*_theMPPixelBarrel);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -567,7 +601,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PPIXBOut1,theRotation2,PIXBOut1);
     theDisk->setMediumProperties(*_theMPPixelOutside1);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
+      addLayer(TrackerLayer(theDisk,true,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -577,7 +611,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theCylinder = new BoundCylinder(thePosition,theRotation,PIXB2);
     theCylinder->setMediumProperties(*_theMPPixelBarrel);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -587,7 +621,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PPIXBOut2,theRotation2,PIXBOut2);
     theDisk->setMediumProperties(*_theMPPixelOutside2);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
+      addLayer(TrackerLayer(theDisk,true,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -597,7 +631,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PPIXBOut3,theRotation2,PIXBOut3);
     theDisk->setMediumProperties(*_theMPPixelOutside3);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
+      addLayer(TrackerLayer(theDisk,true,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -607,27 +641,25 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theCylinder = new BoundCylinder(thePosition,theRotation,PIXB3);
     theCylinder->setMediumProperties(*_theMPPixelBarrel);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
       delete theCylinder;
     
     layerNr = 104;
-    theDisk = new BoundDisk(PPIXBOut4,theRotation2,PIXBOut4);
-    theDisk->setMediumProperties(*_theMPPixelOutside4);
+    theDisk = fixedDisk(layerNr);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
+      addLayer(TrackerLayer(theDisk,true,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
       delete theDisk;
     
     layerNr = 105;
-    theDisk = new BoundDisk(PPIXBOut,theRotation2,PIXBOut);
-    theDisk->setMediumProperties(*_theMPPixelOutside);
+    theDisk = fixedDisk(layerNr);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
+      addLayer(TrackerLayer(theDisk,true,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -637,7 +669,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PPIXD1,theRotation2,PIXD1);
     theDisk->setMediumProperties(*_theMPPixelEndcap);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
+      addLayer(TrackerLayer(theDisk,true,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -647,27 +679,25 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PPIXD2,theRotation2,PIXD2);
     theDisk->setMediumProperties(*_theMPPixelEndcap);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
+      addLayer(TrackerLayer(theDisk,true,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
       delete theDisk;
     
     layerNr = 106;
-    theCylinder = new BoundCylinder(thePosition,theRotation,PIXBOut5);
-    theCylinder->setMediumProperties(*_theMPPixelOutside5);
+    theCylinder = fixedCylinder(layerNr);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
       delete theCylinder;
     
     layerNr = 107;
-    theDisk = new BoundDisk(PPIXBOut6,theRotation2,PIXBOut6);
-    theDisk->setMediumProperties(*_theMPPixelOutside6);
+    theDisk = fixedDisk(layerNr);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
+      addLayer(TrackerLayer(theDisk,true,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -679,7 +709,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theCylinder = new BoundCylinder(thePosition,theRotation,TIB1);
     theCylinder->setMediumProperties(*_theMPTIB1);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -689,7 +719,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theCylinder = new BoundCylinder(thePosition,theRotation,TIB2);
     theCylinder->setMediumProperties(*_theMPTIB2);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -699,7 +729,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theCylinder = new BoundCylinder(thePosition,theRotation,TIB3);
     theCylinder->setMediumProperties(*_theMPTIB3);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -709,27 +739,25 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theCylinder = new BoundCylinder(thePosition,theRotation,TIB4);
     theCylinder->setMediumProperties(*_theMPTIB4);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
       delete theCylinder;
     
     layerNr = 108;
-    theDisk = new BoundDisk(PTIBEOut,theRotation2,TIBEOut);
-    theDisk->setMediumProperties(*_theMPTIBEOutside1);
+    theDisk = fixedDisk(layerNr);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
+      addLayer(TrackerLayer(theDisk,true,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
       delete theDisk;
     
     layerNr = 109;
-    theDisk = new BoundDisk(PTIBEOut2,theRotation2,TIBEOut2);
-    theDisk->setMediumProperties(*_theMPTIBEOutside2);
+    theDisk = fixedDisk(layerNr);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
+      addLayer(TrackerLayer(theDisk,true,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -741,7 +769,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PTID1,theRotation2,TID1);
     theDisk->setMediumProperties(*_theMPInner1);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,layerNr,
+      addLayer(TrackerLayer(theDisk,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -751,7 +779,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PTID2,theRotation2,TID2);
     theDisk->setMediumProperties(*_theMPInner2);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,layerNr,
+      addLayer(TrackerLayer(theDisk,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     
@@ -762,7 +790,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PTID3,theRotation2,TID3);
     theDisk->setMediumProperties(*_theMPInner3);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,12,layerNr,
+      addLayer(TrackerLayer(theDisk,12,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -772,7 +800,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PTIDEOut,theRotation2,TIDEOut);
     theDisk->setMediumProperties(*_theMPTIDEOutside);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
+      addLayer(TrackerLayer(theDisk,true,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -782,10 +810,9 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     // Outer Barrel 
     
     layerNr = 111;
-    theCylinder = new BoundCylinder(thePosition,theRotation,TOBCIn);
-    theCylinder->setMediumProperties(*_theMPTOBBInside);
+    theCylinder = fixedCylinder(layerNr);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -795,7 +822,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theCylinder = new BoundCylinder(thePosition,theRotation,TOB1);
     theCylinder->setMediumProperties(*_theMPTOB1);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -805,7 +832,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theCylinder = new BoundCylinder(thePosition,theRotation,TOB2);
     theCylinder->setMediumProperties(*_theMPTOB2);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -815,7 +842,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theCylinder = new BoundCylinder(thePosition,theRotation,TOB3);
     theCylinder->setMediumProperties(*_theMPTOB3);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -825,7 +852,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theCylinder = new BoundCylinder(thePosition,theRotation,TOB4);
     theCylinder->setMediumProperties(*_theMPTOB4);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -835,7 +862,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theCylinder = new BoundCylinder(thePosition,theRotation,TOB5);
     theCylinder->setMediumProperties(*_theMPTOB5);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -845,17 +872,16 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theCylinder = new BoundCylinder(thePosition,theRotation,TOB6);
     theCylinder->setMediumProperties(*_theMPTOB6);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
       delete theCylinder;
     
     layerNr = 112;
-    theDisk = new BoundDisk(PTOBEOut,theRotation2,TOBEOut);
-    theDisk->setMediumProperties(*_theMPTOBEOutside);
+    theDisk = fixedDisk(layerNr);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
+      addLayer(TrackerLayer(theDisk,true,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -867,7 +893,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PTEC1,theRotation2,TEC1);
     theDisk->setMediumProperties(*_theMPEndcap);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,layerNr,
+      addLayer(TrackerLayer(theDisk,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -877,7 +903,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PTEC2,theRotation2,TEC2);
     theDisk->setMediumProperties(*_theMPEndcap);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,layerNr,
+      addLayer(TrackerLayer(theDisk,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -887,7 +913,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PTEC3,theRotation2,TEC3);
     theDisk->setMediumProperties(*_theMPEndcap);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,layerNr,
+      addLayer(TrackerLayer(theDisk,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -897,7 +923,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PTEC4,theRotation2,TEC4);
     theDisk->setMediumProperties(*_theMPEndcap);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,layerNr,
+      addLayer(TrackerLayer(theDisk,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -907,7 +933,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PTEC5,theRotation2,TEC5);
     theDisk->setMediumProperties(*_theMPEndcap);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,layerNr,
+      addLayer(TrackerLayer(theDisk,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -917,7 +943,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PTEC6,theRotation2,TEC6);
     theDisk->setMediumProperties(*_theMPEndcap);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,layerNr,
+      addLayer(TrackerLayer(theDisk,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -927,7 +953,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PTEC7,theRotation2,TEC7);
     theDisk->setMediumProperties(*_theMPEndcap);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,layerNr,
+      addLayer(TrackerLayer(theDisk,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -937,7 +963,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PTEC8,theRotation2,TEC8);
     theDisk->setMediumProperties(*_theMPEndcap);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,layerNr,
+      addLayer(TrackerLayer(theDisk,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -947,7 +973,7 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     theDisk = new BoundDisk(PTEC9,theRotation2,TEC9);
     theDisk->setMediumProperties(*_theMPEndcap);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,layerNr,
+      addLayer(TrackerLayer(theDisk,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
@@ -957,48 +983,931 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     // Tracker Outside
     
     layerNr = 113;
-    theCylinder = new BoundCylinder(thePosition,theRotation,TBOut);
-    theCylinder->setMediumProperties(*_theMPBarrelOutside);
+    theCylinder = fixedCylinder(layerNr);
     if ( theCylinder->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theCylinder,false,layerNr,
+      addLayer(TrackerLayer(theCylinder,false,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
       delete theCylinder;
     
     layerNr = 114;
-    theDisk = new BoundDisk(PTEOut,theRotation2,TEOut);
-    theDisk->setMediumProperties(*_theMPEndcapOutside);
+    theDisk = fixedDisk(layerNr);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
+      addLayer(TrackerLayer(theDisk,true,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
       delete theDisk;
     
     layerNr = 115;
-    theDisk = new BoundDisk(PTEOut2,theRotation2,TEOut2);
-    theDisk->setMediumProperties(*_theMPEndcapOutside2);
+    theDisk = fixedDisk(layerNr);
     if ( theDisk->mediumProperties().radLen() > 0. ) 
-      _theCylinders.push_back(TrackerLayer(theDisk,true,layerNr,
+      addLayer(TrackerLayer(theDisk,true,layerNr,
 					   minDim(layerNr),maxDim(layerNr),
 					   fudgeFactors(layerNr)));
     else
       delete theDisk;
+
+    if ( _theProfiler ) _theProfiler->end();
+
+    // The negative side
+    if ( _theProfiler ) _theProfiler->begin("negative side");
+    buildNegativeSide(*thePositions);
+    if ( _theProfiler ) _theProfiler->end();
     
   }
   
+  if ( restricted ) 
+    edm::LogInfo("TrackerInteractionGeometry") 
+      << _theCylinders.size() << " + " << _theNegativeCylinders.size() 
+      << " layers reach into r < " << _theRegionMaxRadius << " cm and |z| < " << _theRegionMaxZ << " cm";
+
+  // Merge adjacent thin dead-material layers (e.g., cables at the same z)
+  // into a single effective layer, with the same material budget
+  if ( trackerMaterial.getParameter<bool>("merge_dead_layers") ) { 
+    TrackerGeometryProfiler::Scope scope(_theProfiler,"dead layer merging");
+    double tolerance = trackerMaterial.getParameter<double>("merge_tolerance");
+    mergeDeadLayers(PositiveZ,tolerance);
+    mergeDeadLayers(NegativeZ,tolerance);
+  }
 
   // Check overall compatibility of cylinder dimensions
   // (must be nested cylinders)
   // Throw an exception if the test fails
+  // (the flexible geometry may have overlapping layers, found through
+  // the layer index below rather than through the nesting)
+  if ( use_hardcoded || trackerMaterial.getUntrackedParameter<bool>("check_nesting",true) ) { 
+    TrackerGeometryProfiler::Scope scope(_theProfiler,"nesting check");
+    checkNesting(_theCylinders);
+    checkNesting(_theNegativeCylinders);
+  }
+
+  // First-order misalignment of the sensitive layers, from the module
+  // positions of the (misaligned) reco geometry
+  if ( use_hardcoded && thePositions && thePositions->hasMisalignment() && 
+       trackerMaterial.getParameter<bool>("first_order_misalignment") ) { 
+    TrackerGeometryProfiler::Scope scope(_theProfiler,"misalignment");
+    applyMisalignment(*thePositions);
+  }
+
+  // Index the layers
+  if ( _theProfiler ) _theProfiler->begin("layer index");
+  std::list<TrackerLayer>::const_iterator cyliter = cylinderBegin();
+  for ( ; cyliter != cylinderEnd(); ++cyliter ) 
+    _theLayers.push_back(&(*cyliter));
+  for ( cyliter = _theNegativeCylinders.begin(); cyliter != _theNegativeCylinders.end(); ++cyliter ) 
+    _theNegativeLayers.push_back(&(*cyliter));
+  _theLayerIndex[PositiveZ] = new TrackerLayerIndex(_theLayers);
+  _theLayerIndex[NegativeZ] = new TrackerLayerIndex(_theNegativeLayers);
+  if ( _theProfiler ) _theProfiler->end();
+
+  // (u, phi) material maps, from the configuration, from a file, or 
+  // converted from the fudge factor ranges
+  if ( _theProfiler ) _theProfiler->begin("material maps");
+  buildMaterialMaps(trackerMaterial);
+  if ( _theProfiler ) _theProfiler->end();
+
+  // The distinct materials of the layers, if requested (the sampling 
+  // tables are built per material)
+  bool useSamplingTables = trackerMaterial.getUntrackedParameter<bool>("sampling_tables",false);
+  _thePalette = TrackerMaterialPalette();
+  if ( useSamplingTables || trackerMaterial.getUntrackedParameter<bool>("material_palette",false) ) { 
+    TrackerGeometryProfiler::Scope scope(_theProfiler,"material palette");
+    for ( unsigned side=0; side<2; ++side ) { 
+      std::list<TrackerLayer>::iterator layeriter = _theSides[side]->begin();
+      for ( ; layeriter != _theSides[side]->end(); ++layeriter ) 
+	layeriter->setMaterialIndex(_thePalette.add(*layeriter));
+    }
+    edm::LogInfo("TrackerInteractionGeometry") 
+      << "Material palette : " << _thePalette.size() << " materials for " 
+      << _theLayers.size() + _theNegativeLayers.size() << " layers, "
+      << _mediumProperties.size() << " media";
+  }
+
+  // Alias tables for the energy loss in each material of the palette,
+  // and for the energy sharing of photon conversions
+  if ( useSamplingTables ) { 
+    TrackerGeometryProfiler::Scope scope(_theProfiler,"sampling tables");
+    unsigned nAngle = trackerMaterial.getUntrackedParameter<unsigned>("sampling_tables_angle_bins",8);
+    double maxAngle = trackerMaterial.getUntrackedParameter<double>("sampling_tables_max_angle",10.);
+    unsigned nEnergy = trackerMaterial.getUntrackedParameter<unsigned>("sampling_tables_energy_bins",24);
+    double energyMin = trackerMaterial.getUntrackedParameter<double>("sampling_tables_energy_min",0.1);
+    double energyMax = trackerMaterial.getUntrackedParameter<double>("sampling_tables_energy_max",1000.);
+    unsigned nBins = trackerMaterial.getUntrackedParameter<unsigned>("sampling_tables_x_bins",256);
+    unsigned nThreads = trackerMaterial.getUntrackedParameter<unsigned>("sampling_tables_threads",4);
+    _theEnergyLossDensity = new TrackerMaterialSamplingTables::LandauEnergyLoss(
+      trackerMaterial.getUntrackedParameter<double>("sampling_tables_mass",0.13957));
+    _theEnergyLossTables = new TrackerMaterialSamplingTables(_thePalette.radLens(),
+							     nAngle,maxAngle,
+							     nEnergy,energyMin,energyMax,
+							     nBins,*_theEnergyLossDensity,nThreads);
+    // The conversion sharing does not depend on the material
+    TrackerMaterialSamplingTables::ConversionSharing sharing;
+    _theConversionTables = new TrackerMaterialSamplingTables(std::vector<float>(1,1.f),
+							     1,maxAngle,
+							     nEnergy,energyMin,energyMax,
+							     nBins,sharing,1);
+    edm::LogInfo("TrackerInteractionGeometry") 
+      << "Sampling tables : " << _theEnergyLossTables->nTables() + _theConversionTables->nTables()
+      << " alias tables, " << _theEnergyLossTables->size() + _theConversionTables->size() << " bytes";
+  }
+
+  // Single-precision copy of the layer table (its accuracy is studied
+  // in test/TrackerRandomLineStudy.cpp)
+  if ( trackerMaterial.getUntrackedParameter<bool>("compact_table",false) ) { 
+    TrackerGeometryProfiler::Scope scope(_theProfiler,"single-precision table");
+    _theCompactTable = new TrackerCompactLayerTable(_theLayers,_theNegativeLayers);
+    edm::LogInfo("TrackerInteractionGeometry") 
+      << "Single-precision layer table : " << _theCompactTable->size() << " bytes";
+  }
+
+  // The material between the pairs of sensitive layers, for seeding
+  if ( trackerMaterial.getUntrackedParameter<bool>("layer_pair_tables",false) ) { 
+    TrackerGeometryProfiler::Scope scope(_theProfiler,"layer pair tables");
+    _theLayerPairTables = new TrackerLayerPairTables(
+      _theLayers,
+      _theNegativeLayers,
+      trackerMaterial.getUntrackedParameter<unsigned>("layer_pair_tables_eta_bins",100),
+      trackerMaterial.getUntrackedParameter<double>("layer_pair_tables_eta_max",3.));
+    edm::LogInfo("TrackerInteractionGeometry") 
+      << "Layer pair tables : " << _theLayerPairTables->nSensitive() << " sensitive layers, " 
+      << _theLayerPairTables->size() << " bytes";
+  }
+
+  // Precompute the layers crossed by photons and neutral hadrons
+  if ( trackerMaterial.getUntrackedParameter<bool>("neutral_templates",false) ) {
+    TrackerGeometryProfiler::Scope scope(_theProfiler,"neutral templates");
+    _theNeutralTemplates = new TrackerCrossingTemplates(
+      _theLayers,
+      _theNegativeLayers,
+      trackerMaterial.getUntrackedParameter<unsigned>("neutral_templates_eta_bins",250),
+      trackerMaterial.getUntrackedParameter<double>("neutral_templates_eta_max",5.),
+      trackerMaterial.getUntrackedParameter<unsigned>("neutral_templates_z_bins",30),
+      trackerMaterial.getUntrackedParameter<double>("neutral_templates_z_max",15.));
+    edm::LogInfo("TrackerInteractionGeometry") 
+      << "Neutral crossing templates : " << _theNeutralTemplates->nTemplates() 
+      << " templates, " << _theNeutralTemplates->nCrossings() << " crossings";
+  }
+
+  // The momenta above which the material effects are negligible
+  if ( trackerMaterial.getUntrackedParameter<bool>("effect_thresholds",false) ) { 
+    TrackerGeometryProfiler::Scope scope(_theProfiler,"effect thresholds");
+    _theEffectThresholds = new TrackerEffectThresholds(
+      *this,
+      trackerMaterial.getUntrackedParameter<double>("effect_thresholds_ms_tolerance",1E-5),
+      trackerMaterial.getUntrackedParameter<double>("effect_thresholds_eloss_tolerance",1E-4),
+      trackerMaterial.getUntrackedParameter<unsigned>("effect_thresholds_angle_bins",8),
+      trackerMaterial.getUntrackedParameter<double>("effect_thresholds_max_angle",10.));
+    std::ostringstream thresholds;
+    for ( unsigned iLayer=0; iLayer<_theLayers.size(); ++iLayer ) 
+      if ( _theLayers[iLayer]->sensitive() ) 
+	thresholds << " " << _theLayers[iLayer]->layerNumber() << ":" 
+		   << _theEffectThresholds->layerThreshold(TrackerEffectThresholds::MultipleScattering,
+							   PositiveZ,iLayer);
+    edm::LogInfo("TrackerInteractionGeometry") 
+      << "Multiple scattering thresholds (GeV) of the sensitive layers :" << thresholds.str();
+  }
+
+  // The (r,z) voxel grids, as an alternative to the surfaces for the 
+  // material budget of straight lines (compared to the surfaces by 
+  // test/TrackerRandomLineStudy.cpp)
+  std::string backend = trackerMaterial.getParameter<std::string>("material_backend");
+  if ( backend != "Surfaces" && backend != "Voxels" ) 
+    throw cms::Exception("FastSimulation/TrackerInteractionGeometry") 
+      << "Unknown material backend " << backend << " (Surfaces or Voxels)";
+  if ( backend == "Voxels" ) { 
+    TrackerGeometryProfiler::Scope scope(_theProfiler,"voxel grids");
+    buildVoxelGrids(trackerMaterial.getParameter<unsigned>("voxel_r_bins"),
+		    trackerMaterial.getParameter<unsigned>("voxel_z_bins"));
+    _useVoxels = true;
+  }
+    
+}
+
+void
+TrackerInteractionGeometry::applyMisalignment(const TrackerLayerPositions& thePositions) { 
+
+  // The sensitive layers follow the reco layers of the same number, on 
+  // each side (some may be left out by the region)
+  double maxShift = 0.;
+  double maxTilt = 0.;
+  for ( unsigned side=0; side<2; ++side ) { 
+    std::list<TrackerLayer>::iterator cyliter = _theSides[side]->begin();
+    for ( ; cyliter != _theSides[side]->end(); ++cyliter ) { 
+      int index = recoLayerIndex(*cyliter);
+      if ( index < 0 ) continue;
+      TrackerLayerMisalignment misalignment;
+      if ( cyliter->forward() ) { 
+	if ( index >= static_cast<int>(thePositions.nForwardLayers()) ) continue;
+	misalignment = thePositions.forwardMisalignment(side,index);
+      } else { 
+	if ( index >= static_cast<int>(thePositions.nBarrelLayers()) ) continue;
+	misalignment = thePositions.barrelMisalignment(index);
+      }
+      if ( side == NegativeZ ) misalignment = misalignment.folded();
+      misalignment.zCenter = cyliter->forward() ? std::abs(cyliter->diskZPosition()) : 0.;
+      _theMisalignments.push_back(new TrackerLayerMisalignment(misalignment));
+      cyliter->setMisalignment(_theMisalignments.back());
+      maxShift = std::max(maxShift,std::sqrt(misalignment.dx*misalignment.dx + 
+					     misalignment.dy*misalignment.dy + 
+					     misalignment.dz*misalignment.dz));
+      maxTilt = std::max(maxTilt,std::max(std::abs(misalignment.tiltX),std::abs(misalignment.tiltY)));
+      // How far a misaligned surface can be from its ideal position
+      double extent = cyliter->forward() ? cyliter->diskOuterRadius() : cyliter->cylinderHalfLength();
+      _theMisalignmentMargin = std::max(_theMisalignmentMargin,maxShift+maxTilt*extent);
+    }
+  }
+
+  edm::LogInfo("TrackerInteractionGeometry") 
+    << "First-order misalignment of " << _theMisalignments.size() 
+    << " sensitive layers : largest shift " << maxShift << " cm, largest tilt " << maxTilt << " rad";
+
+}
+
+void
+TrackerInteractionGeometry::buildVoxelGrids(unsigned nR, unsigned nZ) { 
+
+  // The grids enclose all the layers of both sides
+  double rMax = 0.;
+  double zMax = 0.;
+  for ( unsigned side=0; side<2; ++side ) { 
+    for ( unsigned iLayer=0; iLayer<_theSideLayers[side]->size(); ++iLayer ) { 
+      const TrackerLayer& theLayer = layer(static_cast<Side>(side),iLayer);
+      if ( theLayer.forward() ) { 
+	rMax = std::max(rMax,theLayer.diskOuterRadius());
+	zMax = std::max(zMax,std::abs(theLayer.diskZPosition()));
+      } else { 
+	rMax = std::max(rMax,theLayer.cylinderRadius());
+	zMax = std::max(zMax,theLayer.cylinderHalfLength());
+      }
+    }
+  }
+  rMax = 1.01*rMax + 1.;
+  zMax = 1.01*zMax + 1.;
+
+  _theVoxelGrid[PositiveZ] = new TrackerMaterialVoxelGrid(_theLayers,nR,rMax,nZ,zMax);
+  _theVoxelGrid[NegativeZ] = new TrackerMaterialVoxelGrid(_theNegativeLayers,nR,rMax,nZ,zMax);
+  edm::LogInfo("TrackerInteractionGeometry") 
+    << "Material voxel grids : " << nR << " x " << nZ << " cells over r < " << rMax 
+    << " cm, |z| < " << zMax << " cm, " 
+    << _theVoxelGrid[PositiveZ]->size() + _theVoxelGrid[NegativeZ]->size() << " bytes";
+
+}
+
+MediumProperties*
+TrackerInteractionGeometry::medium(double radLen) { 
+  for ( unsigned i=0; i<_mediumProperties.size(); ++i ) 
+    if ( _mediumProperties[i]->radLen() == radLen ) return _mediumProperties[i];
+  _mediumProperties.push_back(new MediumProperties(radLen,0.0001));
+  return _mediumProperties.back();
+}
+
+bool
+TrackerInteractionGeometry::reachesRegion(bool forward, double radius, double z) const { 
+  // A disk at |z| with its inner radius, a cylinder with its radius
+  if ( forward ) return std::abs(z) <= _theRegionMaxZ && radius <= _theRegionMaxRadius;
+  return radius <= _theRegionMaxRadius;
+}
+
+void
+TrackerInteractionGeometry::addLayer(const TrackerLayer& layer) {
+
+  bool reaches = layer.forward() ? 
+    reachesRegion(true,layer.diskInnerRadius(),layer.diskZPosition()) : 
+    reachesRegion(false,layer.cylinderRadius(),0.);
+  if ( reaches ) 
+    _theCylinders.push_back(layer);
+  else 
+    // The surfaces are owned by the layers (not shared between sides)
+    delete &(layer.surface());
+
+}
+
+int
+TrackerInteractionGeometry::recoLayerIndex(const TrackerLayer& layer) { 
+
+  // PXB1-3, TIB1-4, TOB1-6 and PXD1-2, TID1-3, TEC1-9, as in TrackerLayerPositions
+  if ( !layer.sensitive() ) return -1;
+  unsigned n = layer.layerNumber();
+  if ( layer.forward() ) { 
+    if ( n > PXD && n <= TIB ) return n-PXD-1;
+    if ( n > TID && n <= TOB ) return 2+n-TID-1;
+    if ( n > TEC && n <= TEC+9 ) return 5+n-TEC-1;
+  } else { 
+    if ( n > PXB && n <= PXD ) return n-PXB-1;
+    if ( n > TIB && n <= TID ) return 3+n-TIB-1;
+    if ( n > TOB && n <= TEC ) return 7+n-TOB-1;
+  }
+  return -1;
+
+}
+
+void
+TrackerInteractionGeometry::prepareDeadMaterial(const edm::ParameterSet& trackerMaterial) { 
+
+  // Thickness of all layers
+  // Version of the material description
+  if ( _theProfiler ) _theProfiler->begin("parameter fetch");
+  version = trackerMaterial.getParameter<unsigned int>("TrackerMaterialVersion");
+  // The material tables : from the generated tables when the digest 
+  // declared by the configuration is theirs, otherwise from the 
+  // configuration (the tables themselves are not hashed at each start)
+  if ( trackerMaterial.getParameter<std::string>("material_tables_digest") == TrackerMaterialTables::digest ) 
+    loadGeneratedTables();
+  else
+    readMaterialTables(trackerMaterial);
+  if ( _theProfiler ) _theProfiler->end();
+  
+  // The previous std::vector must have the same size!
+  if ( fudgeLayer.size() != fudgeMin.size() ||  
+	 fudgeLayer.size() != fudgeMax.size() ||  
+	 fudgeLayer.size() != fudgeFactor.size() ) {
+    throw cms::Exception("FastSimulation/TrackerInteractionGeometry ") 
+	<< " WARNING with fudge factors !  You have " << fudgeLayer.size() 
+	<< " layers, but " 
+	<< fudgeMin.size() << " min values, "
+	<< fudgeMax.size() << " max values and "
+	<< fudgeFactor.size() << " fudge factor values!"
+	<< std::endl
+	<< "Please make enter the same number of inputs " 
+	<< "in FastSimulation/TrackerInteractionGeometry/data/TrackerMaterial.cfi"
+	<< std::endl;
+  }
+  
+  // The Beam pipe
+  if ( _theProfiler ) _theProfiler->begin("dead material");
+  _theMPBeamPipe = medium(beamPipeThickness[version]);  
+  // The pixel barrel layers
+  _theMPPixelBarrel = medium(pxbThickness[version]);  
+  // Pixel Barrel services at the end of layers 1-3
+  _theMPPixelOutside1 = medium(pxb1CablesThickness[version]);  
+  _theMPPixelOutside2 = medium(pxb2CablesThickness[version]);  
+  _theMPPixelOutside3 = medium(pxb3CablesThickness[version]);  
+  // Pixel Barrel outside cables
+  _theMPPixelOutside4 = medium(pxbOutCables1Thickness[version]);  
+  _theMPPixelOutside  = medium(pxbOutCables2Thickness[version]);  
+  // The pixel endcap disks
+  _theMPPixelEndcap = medium(pxdThickness[version]);  
+  // Pixel Endcap outside cables
+  _theMPPixelOutside5 = medium(pxdOutCables1Thickness[version]);  
+  _theMPPixelOutside6 = medium(pxdOutCables2Thickness[version]);  
+  // The tracker inner barrel layers 1-4
+  _theMPTIB1 = medium(tibLayer1Thickness[version]);  
+  _theMPTIB2 = medium(tibLayer2Thickness[version]);  
+  _theMPTIB3 = medium(tibLayer3Thickness[version]);  
+  _theMPTIB4 = medium(tibLayer4Thickness[version]);  
+  // TIB outside services (endcap)
+  _theMPTIBEOutside1 = medium(tibOutCables1Thickness[version]);  
+  _theMPTIBEOutside2 = medium(tibOutCables2Thickness[version]);  
+  // The tracker inner disks 1-3
+  _theMPInner1 = medium(tidLayer1Thickness[version]);  
+  _theMPInner2 = medium(tidLayer2Thickness[version]);  
+  _theMPInner3 = medium(tidLayer3Thickness[version]);  
+  // TID outside wall (endcap)
+  _theMPTIDEOutside = medium(tidOutsideThickness[version]);  
+  // TOB inside wall (barrel)
+  _theMPTOBBInside = medium(tobInsideThickness[version]);  
+  // The tracker outer barrel layers 1-6
+  _theMPTOB1 = medium(tobLayer1Thickness[version]);  
+  _theMPTOB2 = medium(tobLayer2Thickness[version]);  
+  _theMPTOB3 = medium(tobLayer3Thickness[version]);  
+  _theMPTOB4 = medium(tobLayer4Thickness[version]);  
+  _theMPTOB5 = medium(tobLayer5Thickness[version]);  
+  _theMPTOB6 = medium(tobLayer6Thickness[version]);  
+  // TOB services (endcap)
+  _theMPTOBEOutside = medium(tobOutsideThickness[version]);  
+  // The tracker endcap disks 1-9
+  _theMPEndcap = medium(tecLayerThickness[version]);  
+  // TOB outside wall (barrel)
+  _theMPBarrelOutside = medium(barrelCablesThickness[version]);  
+  // TEC outside wall (endcap)
+  _theMPEndcapOutside = medium(endcapCables1Thickness[version]);  
+  _theMPEndcapOutside2 = medium(endcapCables2Thickness[version]);
+
+  // The dead material that does not depend on the active layer positions
+  const Surface::PositionType thePosition(0.,0.,0.);
+  const Surface::RotationType theRotation(1.,0.,0.,0.,1.,0.,0.,0.,1.);
+  // Beam Pipe
+  //  const SimpleCylinderBounds  PIPE( 0.997,   1.003,  -300., 300.);
+  const SimpleCylinderBounds  PIPE( beamPipeRadius[version]-0.003, beamPipeRadius[version]+0.003,  
+				      -beamPipeLength[version],       beamPipeLength[version]);
+  
+  // Pixel Barrel Outside walls and cables
+  const SimpleDiskBounds PIXBOut4( pxbOutCables1InnerRadius[version],pxbOutCables1OuterRadius[version],-0.5,0.5);
+  const Surface::PositionType PPIXBOut4(0.0,0.0,pxbOutCables1ZPosition[version]);
+  
+  const SimpleDiskBounds PIXBOut(pxbOutCables2InnerRadius[version],pxbOutCables2OuterRadius[version],-0.5,0.5);
+  const Surface::PositionType PPIXBOut(0.0,0.0,pxbOutCables2ZPosition[version]);
+  
+  const SimpleCylinderBounds  PIXBOut5( pixelOutCablesRadius[version]-0.1, pixelOutCablesRadius[version]+0.1, 
+					  -pixelOutCablesLength[version],     pixelOutCablesLength[version]);
+  
+  const SimpleDiskBounds PIXBOut6(pixelOutCablesInnerRadius[version],pixelOutCablesOuterRadius[version],-0.5,0.5);
+  const Surface::PositionType PPIXBOut6(0.0,0.0,pixelOutCablesZPosition[version]);
+  
+  // Inner Barrel Cylinder & Ends : Cables and walls
+  const SimpleDiskBounds TIBEOut(tibOutCables1InnerRadius[version],tibOutCables1OuterRadius[version],-0.05,0.05);
+  const Surface::PositionType PTIBEOut(0.0,0.0,tibOutCables1ZPosition[version]);
+  
+  const SimpleDiskBounds TIBEOut2(tibOutCables2InnerRadius[version],tibOutCables2OuterRadius[version],-0.05,0.05);
+  const Surface::PositionType PTIBEOut2(0.0,0.0,tibOutCables2ZPosition[version]);
+  
+  // Inner Tracker / Outer Barrel Wall
+  const SimpleCylinderBounds  TOBCIn ( tobInCablesRadius[version]-0.5, tobInCablesRadius[version]+0.5,
+					 -tobInCablesLength[version],     tobInCablesLength[version]);
+  
+  const SimpleDiskBounds TOBEOut(tobOutCablesInnerRadius[version],tobOutCablesOuterRadius[version],-0.5,0.5);
+  const Surface::PositionType PTOBEOut(0.0,0.0,tobOutCablesZPosition[version]);
+  
+  // Outside : Barrel
+  const SimpleCylinderBounds  TBOut ( tobOutCablesRadius[version]-0.5, tobOutCablesRadius[version]+0.5,
+					-tobOutCablesLength[version],     tobOutCablesLength[version]);
+  
+  // Outside : Endcap
+  const SimpleDiskBounds TEOut(tecOutCables1InnerRadius[version],tecOutCables1OuterRadius[version],-0.5,0.5);
+  const Surface::PositionType PTEOut(0.0,0.0,tecOutCables1ZPosition[version]);
+  
+  const SimpleDiskBounds TEOut2(tecOutCables2InnerRadius[version],tecOutCables2OuterRadius[version],-0.5,0.5);
+  const Surface::PositionType PTEOut2(0.0,0.0,tecOutCables2ZPosition[version]);
+
+  _theFixedCylinders[0] = new BoundCylinder(thePosition,theRotation,PIPE);
+  _theFixedCylinders[0]->setMediumProperties(*_theMPBeamPipe);
+  _theFixedDisks[4] = new BoundDisk(PPIXBOut4,theRotation,PIXBOut4);
+  _theFixedDisks[4]->setMediumProperties(*_theMPPixelOutside4);
+  _theFixedDisks[5] = new BoundDisk(PPIXBOut,theRotation,PIXBOut);
+  _theFixedDisks[5]->setMediumProperties(*_theMPPixelOutside);
+  _theFixedCylinders[6] = new BoundCylinder(thePosition,theRotation,PIXBOut5);
+  _theFixedCylinders[6]->setMediumProperties(*_theMPPixelOutside5);
+  _theFixedDisks[7] = new BoundDisk(PPIXBOut6,theRotation,PIXBOut6);
+  _theFixedDisks[7]->setMediumProperties(*_theMPPixelOutside6);
+  _theFixedDisks[8] = new BoundDisk(PTIBEOut,theRotation,TIBEOut);
+  _theFixedDisks[8]->setMediumProperties(*_theMPTIBEOutside1);
+  _theFixedDisks[9] = new BoundDisk(PTIBEOut2,theRotation,TIBEOut2);
+  _theFixedDisks[9]->setMediumProperties(*_theMPTIBEOutside2);
+  _theFixedCylinders[11] = new BoundCylinder(thePosition,theRotation,TOBCIn);
+  _theFixedCylinders[11]->setMediumProperties(*_theMPTOBBInside);
+  _theFixedDisks[12] = new BoundDisk(PTOBEOut,theRotation,TOBEOut);
+  _theFixedDisks[12]->setMediumProperties(*_theMPTOBEOutside);
+  _theFixedCylinders[13] = new BoundCylinder(thePosition,theRotation,TBOut);
+  _theFixedCylinders[13]->setMediumProperties(*_theMPBarrelOutside);
+  _theFixedDisks[14] = new BoundDisk(PTEOut,theRotation,TEOut);
+  _theFixedDisks[14]->setMediumProperties(*_theMPEndcapOutside);
+  _theFixedDisks[15] = new BoundDisk(PTEOut2,theRotation,TEOut2);
+  _theFixedDisks[15]->setMediumProperties(*_theMPEndcapOutside2);
+  if ( _theProfiler ) _theProfiler->end();
+
+  _deadMaterialReady = true;
+
+}
+
+BoundCylinder*
+TrackerInteractionGeometry::fixedCylinder(unsigned layerNr) { 
+  BoundCylinder* theCylinder = _theFixedCylinders[layerNr-100];
+  _theFixedCylinders[layerNr-100] = 0;
+  return theCylinder;
+}
+
+BoundDisk*
+TrackerInteractionGeometry::fixedDisk(unsigned layerNr) { 
+  BoundDisk* theDisk = _theFixedDisks[layerNr-100];
+  _theFixedDisks[layerNr-100] = 0;
+  return theDisk;
+}
+
+void
+TrackerInteractionGeometry::readMaterialTables(const edm::ParameterSet& trackerMaterial) {
+
+  // Beam Pipe
+  beamPipeThickness = trackerMaterial.getParameter<std::vector<double> >("BeamPipeThickness");
+  // Pixel Barrel Layers 1-3
+  pxbThickness = trackerMaterial.getParameter<std::vector<double> >("PXBThickness");
+  // Pixel Barrel services at the end of layers 1-3
+  pxb1CablesThickness = trackerMaterial.getParameter<std::vector<double> >("PXB1CablesThickness");
+  pxb2CablesThickness = trackerMaterial.getParameter<std::vector<double> >("PXB2CablesThickness");
+  pxb3CablesThickness = trackerMaterial.getParameter<std::vector<double> >("PXB3CablesThickness");
+  // Pixel Barrel outside cables
+  pxbOutCables1Thickness = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables1Thickness");
+  pxbOutCables2Thickness = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables2Thickness");
+  // Pixel Disks 1-2
+  pxdThickness = trackerMaterial.getParameter<std::vector<double> >("PXDThickness");
+  // Pixel Endcap outside cables
+  pxdOutCables1Thickness = trackerMaterial.getParameter<std::vector<double> >("PXDOutCables1Thickness");
+  pxdOutCables2Thickness = trackerMaterial.getParameter<std::vector<double> >("PXDOutCables2Thickness");
+  // Tracker Inner barrel layers 1-4
+  tibLayer1Thickness = trackerMaterial.getParameter<std::vector<double> >("TIBLayer1Thickness");
+  tibLayer2Thickness = trackerMaterial.getParameter<std::vector<double> >("TIBLayer2Thickness");
+  tibLayer3Thickness = trackerMaterial.getParameter<std::vector<double> >("TIBLayer3Thickness");
+  tibLayer4Thickness = trackerMaterial.getParameter<std::vector<double> >("TIBLayer4Thickness");
+  // TIB outside services (endcap)
+  tibOutCables1Thickness = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables1Thickness");
+  tibOutCables2Thickness = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables2Thickness");
+  // Tracker Inner disks layers 1-3
+  tidLayer1Thickness = trackerMaterial.getParameter<std::vector<double> >("TIDLayer1Thickness");
+  tidLayer2Thickness = trackerMaterial.getParameter<std::vector<double> >("TIDLayer2Thickness");
+  tidLayer3Thickness = trackerMaterial.getParameter<std::vector<double> >("TIDLayer3Thickness");
+  // TID outside wall (endcap)
+  tidOutsideThickness = trackerMaterial.getParameter<std::vector<double> >("TIDOutsideThickness");
+  // TOB inside wall (barrel)
+  tobInsideThickness = trackerMaterial.getParameter<std::vector<double> >("TOBInsideThickness");
+  // Tracker Outer barrel layers 1-6
+  tobLayer1Thickness = trackerMaterial.getParameter<std::vector<double> >("TOBLayer1Thickness");
+  tobLayer2Thickness = trackerMaterial.getParameter<std::vector<double> >("TOBLayer2Thickness");
+  tobLayer3Thickness = trackerMaterial.getParameter<std::vector<double> >("TOBLayer3Thickness");
+  tobLayer4Thickness = trackerMaterial.getParameter<std::vector<double> >("TOBLayer4Thickness");
+  tobLayer5Thickness = trackerMaterial.getParameter<std::vector<double> >("TOBLayer5Thickness");
+  tobLayer6Thickness = trackerMaterial.getParameter<std::vector<double> >("TOBLayer6Thickness");
+  // TOB services (endcap)
+  tobOutsideThickness = trackerMaterial.getParameter<std::vector<double> >("TOBOutsideThickness");
+  // Tracker EndCap disks layers 1-9
+  tecLayerThickness = trackerMaterial.getParameter<std::vector<double> >("TECLayerThickness");
+  // TOB outside wall (barrel)
+  barrelCablesThickness = trackerMaterial.getParameter<std::vector<double> >("BarrelCablesThickness");
+  // TEC outside wall (endcap)
+  endcapCables1Thickness = trackerMaterial.getParameter<std::vector<double> >("EndcapCables1Thickness");
+  endcapCables2Thickness = trackerMaterial.getParameter<std::vector<double> >("EndcapCables2Thickness");
+  
+  // Position of dead material layers (cables, services, etc.)
+  // Beam pipe
+  beamPipeRadius = trackerMaterial.getParameter<std::vector<double> >("BeamPipeRadius");
+  beamPipeLength = trackerMaterial.getParameter<std::vector<double> >("BeamPipeLength");
+  // Cables and Services at the end of PIXB1,2,3 ("disk")
+  pxb1CablesInnerRadius = trackerMaterial.getParameter<std::vector<double> >("PXB1CablesInnerRadius");
+  pxb2CablesInnerRadius = trackerMaterial.getParameter<std::vector<double> >("PXB2CablesInnerRadius");
+  pxb3CablesInnerRadius = trackerMaterial.getParameter<std::vector<double> >("PXB3CablesInnerRadius");
+  // Pixel Barrel Outside walls and cables
+  pxbOutCables1InnerRadius = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables1InnerRadius");
+  pxbOutCables1OuterRadius = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables1OuterRadius");
+  pxbOutCables1ZPosition = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables1ZPosition");
+  pxbOutCables2InnerRadius = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables2InnerRadius");
+  pxbOutCables2OuterRadius = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables2OuterRadius");
+  pxbOutCables2ZPosition = trackerMaterial.getParameter<std::vector<double> >("PXBOutCables2ZPosition");
+  // Pixel Outside walls and cables (barrel and endcaps)
+  pixelOutCablesRadius = trackerMaterial.getParameter<std::vector<double> >("PixelOutCablesRadius");
+  pixelOutCablesLength = trackerMaterial.getParameter<std::vector<double> >("PixelOutCablesLength");
+  pixelOutCablesInnerRadius = trackerMaterial.getParameter<std::vector<double> >("PixelOutCablesInnerRadius");
+  pixelOutCablesOuterRadius = trackerMaterial.getParameter<std::vector<double> >("PixelOutCablesOuterRadius");
+  pixelOutCablesZPosition = trackerMaterial.getParameter<std::vector<double> >("PixelOutCablesZPosition");
+  // Tracker Inner Barrel Outside Cables and walls (endcap) 
+  tibOutCables1InnerRadius = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables1InnerRadius");
+  tibOutCables1OuterRadius = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables1OuterRadius");
+  tibOutCables1ZPosition = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables1ZPosition");
+  tibOutCables2InnerRadius = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables2InnerRadius");
+  tibOutCables2OuterRadius = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables2OuterRadius");
+  tibOutCables2ZPosition = trackerMaterial.getParameter<std::vector<double> >("TIBOutCables2ZPosition");
+  // Tracker outer barrel Inside wall (barrel)
+  tobInCablesRadius = trackerMaterial.getParameter<std::vector<double> >("TOBInCablesRadius");
+  tobInCablesLength = trackerMaterial.getParameter<std::vector<double> >("TOBInCablesLength");
+  // Tracker Inner Disks Outside Cables and walls
+  tidOutCablesInnerRadius = trackerMaterial.getParameter<std::vector<double> >("TIDOutCablesInnerRadius");
+  tidOutCablesZPosition = trackerMaterial.getParameter<std::vector<double> >("TIDOutCablesZPosition");
+  // Tracker Outer Barrel Outside Cables and walls (barrel and endcaps)
+  tobOutCablesInnerRadius = trackerMaterial.getParameter<std::vector<double> >("TOBOutCablesInnerRadius");
+  tobOutCablesOuterRadius = trackerMaterial.getParameter<std::vector<double> >("TOBOutCablesOuterRadius");
+  tobOutCablesZPosition = trackerMaterial.getParameter<std::vector<double> >("TOBOutCablesZPosition");
+  tobOutCablesRadius = trackerMaterial.getParameter<std::vector<double> >("TOBOutCablesRadius");
+  tobOutCablesLength = trackerMaterial.getParameter<std::vector<double> >("TOBOutCablesLength");
+  // Tracker Endcaps Outside Cables and walls
+  tecOutCables1InnerRadius = trackerMaterial.getParameter<std::vector<double> >("TECOutCables1InnerRadius");
+  tecOutCables1OuterRadius = trackerMaterial.getParameter<std::vector<double> >("TECOutCables1OuterRadius");
+  tecOutCables1ZPosition = trackerMaterial.getParameter<std::vector<double> >("TECOutCables1ZPosition");
+  tecOutCables2InnerRadius = trackerMaterial.getParameter<std::vector<double> >("TECOutCables2InnerRadius");
+  tecOutCables2OuterRadius = trackerMaterial.getParameter<std::vector<double> >("TECOutCables2OuterRadius");
+  tecOutCables2ZPosition = trackerMaterial.getParameter<std::vector<double> >("TECOutCables2ZPosition");
+  
+  // Fudge factors for tracker layer material inhomogeneities
+  fudgeLayer = trackerMaterial.getParameter<std::vector<unsigned int> >("FudgeLayer");
+  fudgeMin = trackerMaterial.getParameter<std::vector<double> >("FudgeMin");
+  fudgeMax = trackerMaterial.getParameter<std::vector<double> >("FudgeMax");
+  fudgeFactor = trackerMaterial.getParameter<std::vector<double> >("FudgeFactor");
+
+}
+
+void
+TrackerInteractionGeometry::loadGeneratedTables() {
+
+  // Beam Pipe
+  assign(beamPipeThickness,TrackerMaterialTables::BeamPipeThickness);
+  // Pixel Barrel Layers 1-3
+  assign(pxbThickness,TrackerMaterialTables::PXBThickness);
+  // Pixel Barrel services at the end of layers 1-3
+  assign(pxb1CablesThickness,TrackerMaterialTables::PXB1CablesThickness);
+  assign(pxb2CablesThickness,TrackerMaterialTables::PXB2CablesThickness);
+  assign(pxb3CablesThickness,TrackerMaterialTables::PXB3CablesThickness);
+  // Pixel Barrel outside cables
+  assign(pxbOutCables1Thickness,TrackerMaterialTables::PXBOutCables1Thickness);
+  assign(pxbOutCables2Thickness,TrackerMaterialTables::PXBOutCables2Thickness);
+  // Pixel Disks 1-2
+  assign(pxdThickness,TrackerMaterialTables::PXDThickness);
+  // Pixel Endcap outside cables
+  assign(pxdOutCables1Thickness,TrackerMaterialTables::PXDOutCables1Thickness);
+  assign(pxdOutCables2Thickness,TrackerMaterialTables::PXDOutCables2Thickness);
+  // Tracker Inner barrel layers 1-4
+  assign(tibLayer1Thickness,TrackerMaterialTables::TIBLayer1Thickness);
+  assign(tibLayer2Thickness,TrackerMaterialTables::TIBLayer2Thickness);
+  assign(tibLayer3Thickness,TrackerMaterialTables::TIBLayer3Thickness);
+  assign(tibLayer4Thickness,TrackerMaterialTables::TIBLayer4Thickness);
+  // TIB outside services (endcap)
+  assign(tibOutCables1Thickness,TrackerMaterialTables::TIBOutCables1Thickness);
+  assign(tibOutCables2Thickness,TrackerMaterialTables::TIBOutCables2Thickness);
+  // Tracker Inner disks layers 1-3
+  assign(tidLayer1Thickness,TrackerMaterialTables::TIDLayer1Thickness);
+  assign(tidLayer2Thickness,TrackerMaterialTables::TIDLayer2Thickness);
+  assign(tidLayer3Thickness,TrackerMaterialTables::TIDLayer3Thickness);
+  // TID outside wall (endcap)
+  assign(tidOutsideThickness,TrackerMaterialTables::TIDOutsideThickness);
+  // TOB inside wall (barrel)
+  assign(tobInsideThickness,TrackerMaterialTables::TOBInsideThickness);
+  // Tracker Outer barrel layers 1-6
+  assign(tobLayer1Thickness,TrackerMaterialTables::TOBLayer1Thickness);
+  assign(tobLayer2Thickness,TrackerMaterialTables::TOBLayer2Thickness);
+  assign(tobLayer3Thickness,TrackerMaterialTables::TOBLayer3Thickness);
+  assign(tobLayer4Thickness,TrackerMaterialTables::TOBLayer4Thickness);
+  assign(tobLayer5Thickness,TrackerMaterialTables::TOBLayer5Thickness);
+  assign(tobLayer6Thickness,TrackerMaterialTables::TOBLayer6Thickness);
+  // TOB services (endcap)
+  assign(tobOutsideThickness,TrackerMaterialTables::TOBOutsideThickness);
+  // Tracker EndCap disks layers 1-9
+  assign(tecLayerThickness,TrackerMaterialTables::TECLayerThickness);
+  // TOB outside wall (barrel)
+  assign(barrelCablesThickness,TrackerMaterialTables::BarrelCablesThickness);
+  // TEC outside wall (endcap)
+  assign(endcapCables1Thickness,TrackerMaterialTables::EndcapCables1Thickness);
+  assign(endcapCables2Thickness,TrackerMaterialTables::EndcapCables2Thickness);
+
+  // Position of dead material layers (cables, services, etc.)
+  // Beam pipe
+  assign(beamPipeRadius,TrackerMaterialTables::BeamPipeRadius);
+  assign(beamPipeLength,TrackerMaterialTables::BeamPipeLength);
+  // Cables and Services at the end of PIXB1,2,3 ("disk")
+  assign(pxb1CablesInnerRadius,TrackerMaterialTables::PXB1CablesInnerRadius);
+  assign(pxb2CablesInnerRadius,TrackerMaterialTables::PXB2CablesInnerRadius);
+  assign(pxb3CablesInnerRadius,TrackerMaterialTables::PXB3CablesInnerRadius);
+  // Pixel Barrel Outside walls and cables
+  assign(pxbOutCables1InnerRadius,TrackerMaterialTables::PXBOutCables1InnerRadius);
+  assign(pxbOutCables1OuterRadius,TrackerMaterialTables::PXBOutCables1OuterRadius);
+  assign(pxbOutCables1ZPosition,TrackerMaterialTables::PXBOutCables1ZPosition);
+  assign(pxbOutCables2InnerRadius,TrackerMaterialTables::PXBOutCables2InnerRadius);
+  assign(pxbOutCables2OuterRadius,TrackerMaterialTables::PXBOutCables2OuterRadius);
+  assign(pxbOutCables2ZPosition,TrackerMaterialTables::PXBOutCables2ZPosition);
+  // Pixel Outside walls and cables (barrel and endcaps)
+  assign(pixelOutCablesRadius,TrackerMaterialTables::PixelOutCablesRadius);
+  assign(pixelOutCablesLength,TrackerMaterialTables::PixelOutCablesLength);
+  assign(pixelOutCablesInnerRadius,TrackerMaterialTables::PixelOutCablesInnerRadius);
+  assign(pixelOutCablesOuterRadius,TrackerMaterialTables::PixelOutCablesOuterRadius);
+  assign(pixelOutCablesZPosition,TrackerMaterialTables::PixelOutCablesZPosition);
+  // Tracker Inner Barrel Outside Cables and walls (endcap)
+  assign(tibOutCables1InnerRadius,TrackerMaterialTables::TIBOutCables1InnerRadius);
+  assign(tibOutCables1OuterRadius,TrackerMaterialTables::TIBOutCables1OuterRadius);
+  assign(tibOutCables1ZPosition,TrackerMaterialTables::TIBOutCables1ZPosition);
+  assign(tibOutCables2InnerRadius,TrackerMaterialTables::TIBOutCables2InnerRadius);
+  assign(tibOutCables2OuterRadius,TrackerMaterialTables::TIBOutCables2OuterRadius);
+  assign(tibOutCables2ZPosition,TrackerMaterialTables::TIBOutCables2ZPosition);
+  // Tracker outer barrel Inside wall (barrel)
+  assign(tobInCablesRadius,TrackerMaterialTables::TOBInCablesRadius);
+  assign(tobInCablesLength,TrackerMaterialTables::TOBInCablesLength);
+  // Tracker Inner Disks Outside Cables and walls
+  assign(tidOutCablesInnerRadius,TrackerMaterialTables::TIDOutCablesInnerRadius);
+  assign(tidOutCablesZPosition,TrackerMaterialTables::TIDOutCablesZPosition);
+  // Tracker Outer Barrel Outside Cables and walls (barrel and endcaps)
+  assign(tobOutCablesInnerRadius,TrackerMaterialTables::TOBOutCablesInnerRadius);
+  assign(tobOutCablesOuterRadius,TrackerMaterialTables::TOBOutCablesOuterRadius);
+  assign(tobOutCablesZPosition,TrackerMaterialTables::TOBOutCablesZPosition);
+  assign(tobOutCablesRadius,TrackerMaterialTables::TOBOutCablesRadius);
+  assign(tobOutCablesLength,TrackerMaterialTables::TOBOutCablesLength);
+  // Tracker Endcaps Outside Cables and walls
+  assign(tecOutCables1InnerRadius,TrackerMaterialTables::TECOutCables1InnerRadius);
+  assign(tecOutCables1OuterRadius,TrackerMaterialTables::TECOutCables1OuterRadius);
+  assign(tecOutCables1ZPosition,TrackerMaterialTables::TECOutCables1ZPosition);
+  assign(tecOutCables2InnerRadius,TrackerMaterialTables::TECOutCables2InnerRadius);
+  assign(tecOutCables2OuterRadius,TrackerMaterialTables::TECOutCables2OuterRadius);
+  assign(tecOutCables2ZPosition,TrackerMaterialTables::TECOutCables2ZPosition);
+
+  // Fudge factors for tracker layer material inhomogeneities
+  assign(fudgeLayer,TrackerMaterialTables::FudgeLayer);
+  assign(fudgeMin,TrackerMaterialTables::FudgeMin);
+  assign(fudgeMax,TrackerMaterialTables::FudgeMax);
+  assign(fudgeFactor,TrackerMaterialTables::FudgeFactor);
+
+}
+
+void
+TrackerInteractionGeometry::buildModuleGrids(const GeometricSearchTracker* theGeomSearchTracker,
+					     unsigned nPhi, unsigned nU, unsigned nThreads) { 
+
+  std::vector< BarrelDetLayer*> barrelLayers = 
+    theGeomSearchTracker->barrelLayers();
+  std::vector< ForwardDetLayer*>  posForwardLayers = 
+    theGeomSearchTracker->posForwardLayers();
+  std::vector< ForwardDetLayer*>  negForwardLayers = 
+    theGeomSearchTracker->negForwardLayers();
+
+  // The sensitive layers follow the reco layers of the same number, 
+  // separately for barrel and forward layers. The negative side has its 
+  // own forward grids, and shares the barrel grids of the positive side.
+  ModuleGridJobs jobs(nPhi,nU);
+  std::list<TrackerLayer>::iterator cyliter = _theCylinders.begin();
+  for ( ; cyliter != _theCylinders.end(); ++cyliter ) { 
+    int index = recoLayerIndex(*cyliter);
+    if ( index < 0 ) continue;
+    if ( cyliter->forward() ) { 
+      if ( index < static_cast<int>(posForwardLayers.size()) ) 
+	jobs.add(&(*cyliter),posForwardLayers[index]);
+    } else { 
+      if ( index < static_cast<int>(barrelLayers.size()) ) 
+	jobs.add(&(*cyliter),barrelLayers[index]);
+    }
+  }
+  for ( cyliter = _theNegativeCylinders.begin(); cyliter != _theNegativeCylinders.end(); ++cyliter ) { 
+    if ( !cyliter->forward() ) continue;
+    int index = recoLayerIndex(*cyliter);
+    if ( index >= 0 && index < static_cast<int>(negForwardLayers.size()) ) 
+      jobs.add(&(*cyliter),negForwardLayers[index]);
+  }
+
+  // Each grid is filled independently of the others
+  TrackerWorkerPool pool(nThreads);
+  try { 
+    pool.run(boost::bind(&ModuleGridJobs::work,&jobs));
+  } catch ( ... ) { 
+    // The grids already filled are not given to their layers yet
+    for ( unsigned iJob=0; iJob<jobs.grids.size(); ++iJob ) delete jobs.grids[iJob];
+    throw;
+  }
+  for ( unsigned iJob=0; iJob<jobs.layers.size(); ++iJob ) { 
+    _theModuleGrids.push_back(jobs.grids[iJob]);
+    jobs.layers[iJob]->setModuleGrid(jobs.grids[iJob]);
+  }
+
+  // The barrel layers of the negative side
+  std::list<TrackerLayer>::const_iterator positive = cylinderBegin();
+  for ( cyliter = _theNegativeCylinders.begin(); cyliter != _theNegativeCylinders.end(); ++cyliter ) { 
+    if ( !cyliter->sensitive() || cyliter->forward() ) continue;
+    while ( positive != cylinderEnd() && 
+	    ( positive->forward() || positive->layerNumber() != cyliter->layerNumber() ) ) 
+      ++positive;
+    if ( positive == cylinderEnd() ) break;
+    cyliter->setModuleGrid(positive->moduleGrid());
+  }
+
+  unsigned maxCandidates = 0;
+  for ( unsigned iGrid=0; iGrid<_theModuleGrids.size(); ++iGrid ) 
+    maxCandidates = std::max(maxCandidates,_theModuleGrids[iGrid]->maxCandidates());
+  edm::LogInfo("TrackerInteractionGeometry") 
+    << "Module lookup grids built for " << _theModuleGrids.size() 
+    << " sensitive layers (both sides) in " << std::max(nThreads,1U) 
+    << " threads, with at most " << maxCandidates << " modules per cell";
+
+}
+
+void
+TrackerInteractionGeometry::buildMaterialMaps(const edm::ParameterSet& trackerMaterial) { 
+
+  // The maps given explicitly, by layer number
+  std::map<unsigned,const TrackerLayerMaterialMap*> maps;
+  std::vector<unsigned> mapLayer = 
+    trackerMaterial.getParameter<std::vector<unsigned> >("material_map_layer");
+  if ( !mapLayer.empty() ) { 
+    std::vector<unsigned> nU = 
+      trackerMaterial.getParameter<std::vector<unsigned> >("material_map_u_bins");
+    std::vector<unsigned> nPhi = 
+      trackerMaterial.getParameter<std::vector<unsigned> >("material_map_phi_bins");
+    std::vector<double> uMin = 
+      trackerMaterial.getParameter<std::vector<double> >("material_map_u_min");
+    std::vector<double> uMax = 
+      trackerMaterial.getParameter<std::vector<double> >("material_map_u_max");
+    std::vector<double> factors = 
+      trackerMaterial.getParameter<std::vector<double> >("material_map_factors");
+    if ( nU.size() != mapLayer.size() || nPhi.size() != mapLayer.size() || 
+	 uMin.size() != mapLayer.size() || uMax.size() != mapLayer.size() ) 
+      throw cms::Exception("FastSimulation/TrackerInteractionGeometry") 
+	<< "The material map parameters have different sizes";
+    unsigned first = 0;
+    for ( unsigned iMap=0; iMap<mapLayer.size(); ++iMap ) { 
+      unsigned last = first + nU[iMap]*nPhi[iMap];
+      if ( last > factors.size() ) 
+	throw cms::Exception("FastSimulation/TrackerInteractionGeometry") 
+	  << "Missing material map factors for layer " << mapLayer[iMap];
+      _theMaterialMaps.push_back(new TrackerLayerMaterialMap(nU[iMap],uMin[iMap],uMax[iMap],nPhi[iMap],
+							     std::vector<float>(factors.begin()+first,
+										factors.begin()+last)));
+      maps[mapLayer[iMap]] = _theMaterialMaps.back();
+      first = last;
+    }
+  }
+
+  // The maps of a file, which override those of the configuration
+  std::string fileName = trackerMaterial.getParameter<std::string>("material_map_file");
+  if ( !fileName.empty() ) { 
+    std::vector<unsigned> fileLayers;
+    std::vector<TrackerLayerMaterialMap*> fileMaps;
+    TrackerLayerMaterialMap::read(fileName,fileLayers,fileMaps);
+    for ( unsigned iMap=0; iMap<fileMaps.size(); ++iMap ) { 
+      _theMaterialMaps.push_back(fileMaps[iMap]);
+      maps[fileLayers[iMap]] = fileMaps[iMap];
+    }
+  }
+
+  // The other layers with fudge factors, converted to a map
+  bool convert = trackerMaterial.getParameter<bool>("fudge_to_material_maps");
+  unsigned nConverted = 0;
+  unsigned nBins = trackerMaterial.getParameter<unsigned>("fudge_map_u_bins");
+  for ( unsigned side=0; side<2; ++side ) { 
+    std::list<TrackerLayer>::iterator layeriter = _theSides[side]->begin();
+    for ( ; layeriter != _theSides[side]->end(); ++layeriter ) { 
+      std::map<unsigned,const TrackerLayerMaterialMap*>::const_iterator found = 
+	maps.find(layeriter->layerNumber());
+      if ( found == maps.end() && convert && layeriter->fudgeNumber() ) { 
+	_theMaterialMaps.push_back(new TrackerLayerMaterialMap(*layeriter,nBins));
+	found = maps.insert(std::make_pair(layeriter->layerNumber(),_theMaterialMaps.back())).first;
+	++nConverted;
+      }
+      if ( found != maps.end() ) layeriter->setMaterialMap(found->second);
+    }
+  }
+
+  if ( !_theMaterialMaps.empty() ) 
+    edm::LogInfo("TrackerInteractionGeometry") 
+      << "Material maps : " << _theMaterialMaps.size() << " maps, of which " 
+      << nConverted << " converted from fudge factors";
+
+}
+
+void
+TrackerInteractionGeometry::flexibleFudgeFactors(const edm::ParameterSet& trackerMaterial,
+						 const std::string& prefix,
+						 std::vector< std::vector<double> >& theMin,
+						 std::vector< std::vector<double> >& theMax,
+						 std::vector< std::vector<double> >& theFudge) const { 
+
+  if ( !trackerMaterial.existsAs<std::vector<unsigned int> >(prefix+"_fudge_layer") ) return;
+  std::vector<unsigned int> layer = 
+    trackerMaterial.getParameter<std::vector<unsigned int> >(prefix+"_fudge_layer");
+  std::vector<double> min = trackerMaterial.getParameter<std::vector<double> >(prefix+"_fudge_min");
+  std::vector<double> max = trackerMaterial.getParameter<std::vector<double> >(prefix+"_fudge_max");
+  std::vector<double> factor = trackerMaterial.getParameter<std::vector<double> >(prefix+"_fudge_factor");
+
+  if ( layer.size() != min.size() || layer.size() != max.size() || layer.size() != factor.size() ) 
+    throw cms::Exception("FastSimulation/TrackerInteractionGeometry ") 
+      << " WARNING with " << prefix << " fudge factors !  You have " << layer.size() 
+      << " layers, but " 
+      << min.size() << " min values, "
+      << max.size() << " max values and "
+      << factor.size() << " fudge factor values!";
+
+  for ( unsigned iFudge=0; iFudge<layer.size(); ++iFudge ) { 
+    if ( layer[iFudge] >= theFudge.size() ) 
+      throw cms::Exception("FastSimulation/TrackerInteractionGeometry ") 
+	<< " WARNING with " << prefix << " fudge factors ! Layer " << layer[iFudge] 
+	<< " requested, but only " << theFudge.size() << " layers are defined";
+    theMin[layer[iFudge]].push_back(min[iFudge]);
+    theMax[layer[iFudge]].push_back(max[iFudge]);
+    theFudge[layer[iFudge]].push_back(factor[iFudge]);
+  }
+
+}
+
+std::vector<double>
+TrackerInteractionGeometry::minDim(unsigned layerNr) { 
+  std::vector<double> min;
+  for ( unsigned iLayer=0; iLayer<fudgeFactor.size(); ++iLayer ) {   
+    if ( layerNr != fudgeLayer[iLayer] ) continue;
+    min.push_back(fudgeMin[iLayer]);
+  }
+  return min;
+}
+
+std::vector<double>
+TrackerInteractionGeometry::maxDim(unsigned layerNr) { 
+  std::vector<double> max;
+  for ( unsigned iLayer=0; iLayer<fudgeFactor.size(); ++iLayer ) {   
+    if ( layerNr != fudgeLayer[iLayer] ) continue;
+    max.push_back(fudgeMax[iLayer]);
+  }
+  return max;
+}
+
+std::vector<double>
+TrackerInteractionGeometry::fudgeFactors(unsigned layerNr) { 
+  std::vector<double> fudge;
+  for ( unsigned iLayer=0; iLayer<fudgeFactor.size(); ++iLayer ) {   
+    if ( layerNr != fudgeLayer[iLayer] ) continue;
+    fudge.push_back(fudgeFactor[iLayer]);
+  }
+  return fudge;
+}
+
+void
+TrackerInteractionGeometry::checkNesting(const std::list<TrackerLayer>& cylinders) const { 
+
   double zin, rin;
   double zout, rout;
   unsigned nCyl=0;
-  std::list<TrackerLayer>::const_iterator cyliterOut=cylinderBegin();
+  if ( cylinders.empty() ) return;
+  std::list<TrackerLayer>::const_iterator cyliterOut=cylinders.begin();
   // Inner cylinder dimensions
   if ( cyliterOut->forward() ) {
-    zin = cyliterOut->disk()->position().z();
+    zin = std::abs(cyliterOut->disk()->position().z());
     rin = cyliterOut->disk()->outerRadius();
   } else {
     zin = cyliterOut->cylinder()->bounds().length()/2.;
@@ -1009,10 +1918,10 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
 
 
   // And loop over all cylinders
-  while ( cyliterOut != cylinderEnd() ) {
+  while ( cyliterOut != cylinders.end() ) {
     // Outer cylinder dimensions
     if ( cyliterOut->forward() ) {
-      zout = cyliterOut->disk()->position().z();
+      zout = std::abs(cyliterOut->disk()->position().z());
       rout = cyliterOut->disk()->outerRadius();
     } else {
       zout = cyliterOut->cylinder()->bounds().length()/2.;
@@ -1045,93 +1954,276 @@ TrackerInteractionGeometry::TrackerInteractionGeometry(const edm::ParameterSet&
     zin = zout;
     rin = rout;
     // End test
-  } 
-    
+  }
+
 }
 
-std::vector<double>
-TrackerInteractionGeometry::minDim(unsigned layerNr) { 
-  std::vector<double> min;
-  for ( unsigned iLayer=0; iLayer<fudgeFactor.size(); ++iLayer ) {   
-    if ( layerNr != fudgeLayer[iLayer] ) continue;
-    min.push_back(fudgeMin[iLayer]);
+double
+TrackerInteractionGeometry::materialBudget(double eta, double z0) const { 
+  // Time one call in N, if requested
+  double start = 0.;
+  bool sampled = _theProfiler && _theProfiler->sampleQuery(start);
+  // Fold to the side of the direction : z -> |z|
+  Side theSide = side(eta);
+  double sign = 1.-2.*theSide;
+  eta *= sign;
+  z0 *= sign;
+  double theta = 2.*std::atan(std::exp(-eta));
+  double sinTheta = std::sin(theta);
+  double cosTheta = std::cos(theta);
+  double radLen = 0.;
+  if ( _useVoxels ) { 
+    radLen = _theVoxelGrid[theSide]->materialBudget(z0,sinTheta,cosTheta);
+  } else if ( _theLayerIndex[theSide] ) { 
+    radLen = _theLayerIndex[theSide]->straightRadLen(z0,sinTheta,cosTheta);
+  } else { 
+    // Before the index is built (dead layer merging)
+    std::list<TrackerLayer>::const_iterator cyliter = cylinderBegin(theSide);
+    for ( ; cyliter != cylinderEnd(theSide); ++cyliter ) 
+      radLen += cyliter->straightRadLen(z0,sinTheta,cosTheta);
   }
-  return min;
+  if ( sampled ) _theProfiler->endQuery("materialBudget",start);
+  return radLen;
 }
 
-std::vector<double>
-TrackerInteractionGeometry::maxDim(unsigned layerNr) { 
-  std::vector<double> max;
-  for ( unsigned iLayer=0; iLayer<fudgeFactor.size(); ++iLayer ) {   
-    if ( layerNr != fudgeLayer[iLayer] ) continue;
-    max.push_back(fudgeMax[iLayer]);
+void
+TrackerInteractionGeometry::buildNegativeSide(const TrackerLayerPositions& thePositions) { 
+
+  std::list<TrackerLayer>::const_iterator cyliter = cylinderBegin();
+  for ( ; cyliter != cylinderEnd(); ++cyliter ) { 
+    double z = -cyliter->diskZPosition();
+    double innerRadius = cyliter->diskInnerRadius();
+    double outerRadius = cyliter->diskOuterRadius();
+    // The sensitive disks follow the (possibly misaligned) negative 
+    // reco layers, with the same margins as on the positive side
+    int fl = cyliter->forward() ? recoLayerIndex(*cyliter) : -1;
+    if ( fl >= 0 && fl < static_cast<int>(thePositions.nForwardLayers()) ) { 
+      z = thePositions.forwardZ(NegativeZ,fl);
+      innerRadius += thePositions.forwardInnerRadius(NegativeZ,fl) - thePositions.forwardInnerRadius(PositiveZ,fl);
+      outerRadius += thePositions.forwardOuterRadius(NegativeZ,fl) - thePositions.forwardOuterRadius(PositiveZ,fl);
+    }
+    // Outside the region : not built
+    if ( cyliter->forward() ? !reachesRegion(true,innerRadius,z) : 
+	 !reachesRegion(false,cyliter->cylinderRadius(),0.) ) continue;
+    _theNegativeCylinders.push_back(negativeLayer(*cyliter,cyliter->radLen(),
+						  z,innerRadius,outerRadius));
   }
-  return max;
+
 }
 
-std::vector<double>
-TrackerInteractionGeometry::fudgeFactors(unsigned layerNr) { 
-  std::vector<double> fudge;
-  for ( unsigned iLayer=0; iLayer<fudgeFactor.size(); ++iLayer ) {   
-    if ( layerNr != fudgeLayer[iLayer] ) continue;
-    fudge.push_back(fudgeFactor[iLayer]);
+TrackerLayer
+TrackerInteractionGeometry::negativeLayer(const TrackerLayer& layer, double thickness,
+					  double z, double innerRadius, double outerRadius) { 
+
+  // Same fudge factors as the positive side
+  std::vector<double> theMin, theMax, theFudge;
+  for ( unsigned iFudge=0; iFudge<layer.fudgeNumber(); ++iFudge ) { 
+    theMin.push_back(layer.fudgeMin(iFudge));
+    theMax.push_back(layer.fudgeMax(iFudge));
+    theFudge.push_back(layer.fudgeFactor(iFudge));
   }
-  return fudge;
+
+  // Share the material of the positive side, unless it differs
+  const MediumProperties* theMP = &(layer.surface().mediumProperties());
+  if ( thickness != layer.radLen() ) theMP = medium(thickness);
+
+  const Surface::RotationType theRotation(1.,0.,0.,0.,1.,0.,0.,0.,1.);
+  double halfThickness = layer.surface().bounds().thickness()/2.;
+  if ( layer.forward() ) { 
+    const SimpleDiskBounds diskBounds(innerRadius,outerRadius,-halfThickness,+halfThickness);
+    const Surface::PositionType position(0.,0.,z);
+    BoundDisk* theDisk = new BoundDisk(position,theRotation,diskBounds);
+    theDisk->setMediumProperties(*theMP);
+    TrackerLayer theLayer(theDisk,true,layer.layerNumber(),theMin,theMax,theFudge);
+    theLayer.setSensitive(layer.sensitive());
+    return theLayer;
+  }
+
+  const Surface::PositionType position(0.,0.,0.);
+  double radius = layer.cylinderRadius();
+  double halfLength = layer.cylinderHalfLength();
+  const SimpleCylinderBounds cylBounds(radius-halfThickness,radius+halfThickness,-halfLength,+halfLength);
+  BoundCylinder* theCylinder = new BoundCylinder(position,theRotation,cylBounds);
+  theCylinder->setMediumProperties(*theMP);
+  TrackerLayer theLayer(theCylinder,false,layer.layerNumber(),theMin,theMax,theFudge);
+  theLayer.setSensitive(layer.sensitive());
+  theLayer.setTilt(layer.tilt(),layer.tiltZMin());
+  return theLayer;
+
+}
+
+bool
+TrackerInteractionGeometry::mergeable(const TrackerLayer& first, 
+				      const TrackerLayer& second, 
+				      double tolerance) const { 
+  // Only dead material, and only layers of the same shape
+  if ( first.sensitive() || second.sensitive() ) return false;
+  if ( first.forward() != second.forward() ) return false;
+  if ( first.forward() ) 
+    return std::abs(second.diskZPosition()-first.diskZPosition()) <= tolerance;
+  return std::abs(second.cylinderRadius()-first.cylinderRadius()) <= tolerance;
+}
+
+TrackerLayer
+TrackerInteractionGeometry::mergedLayer(const TrackerLayer& first, 
+					const TrackerLayer& second) { 
+
+  // The extent of each layer along the fudge-factor dimension 
+  // (r for disks, |z| for cylinders)
+  const TrackerLayer* layers[2] = { &first, &second };
+  double lowDim[2], highDim[2];
+  for ( unsigned i=0; i<2; ++i ) { 
+    lowDim[i] = layers[i]->forward() ? layers[i]->diskInnerRadius() : 0.;
+    highDim[i] = layers[i]->forward() ? 
+      layers[i]->diskOuterRadius() : layers[i]->cylinderHalfLength();
+  }
+  double low = std::min(lowDim[0],lowDim[1]);
+  double high = std::max(highDim[0],highDim[1]);
+
+  // Cut the merged extent at every layer edge and every fudge range edge
+  std::vector<double> edges;
+  edges.push_back(low);
+  edges.push_back(high);
+  for ( unsigned i=0; i<2; ++i ) { 
+    edges.push_back(lowDim[i]);
+    edges.push_back(highDim[i]);
+    for ( unsigned iFudge=0; iFudge<layers[i]->fudgeNumber(); ++iFudge ) { 
+      edges.push_back(std::max(low,std::min(high,layers[i]->fudgeMin(iFudge))));
+      edges.push_back(std::max(low,std::min(high,layers[i]->fudgeMax(iFudge))));
+    }
+  }
+  std::sort(edges.begin(),edges.end());
+  edges.erase(std::unique(edges.begin(),edges.end()),edges.end());
+
+  // The merged layer gets the thickest of the two materials, and the 
+  // sum of the two materials is reproduced with fudge factors in each segment
+  double radLen = std::max(first.radLen(),second.radLen());
+  std::vector<double> theMin, theMax, theFudge;
+  for ( unsigned iEdge=0; iEdge+1<edges.size(); ++iEdge ) { 
+    double dim = 0.5*(edges[iEdge]+edges[iEdge+1]);
+    double sum = 0.;
+    for ( unsigned i=0; i<2; ++i ) 
+      if ( dim > lowDim[i] && dim < highDim[i] ) 
+	sum += layers[i]->radLen() * layers[i]->fudgeFactorAt(dim);
+    double fudge = sum/radLen;
+    if ( std::abs(fudge-1.) < 1E-9 ) continue;
+    if ( !theFudge.empty() && 
+	 theMax.back() == edges[iEdge] && 
+	 std::abs(theFudge.back()-fudge) < 1E-9 ) { 
+      theMax.back() = edges[iEdge+1];
+    } else { 
+      theMin.push_back(edges[iEdge]);
+      theMax.push_back(edges[iEdge+1]);
+      theFudge.push_back(fudge);
+    }
+  }
+
+  const MediumProperties* theMP = medium(radLen);
+  const Surface::RotationType theRotation(1.,0.,0.,0.,1.,0.,0.,0.,1.);
+  double thickness = std::max(first.surface().bounds().thickness(),
+			      second.surface().bounds().thickness());
+
+  // The second layer keeps its position, to preserve the nesting
+  if ( first.forward() ) { 
+    const SimpleDiskBounds diskBounds(low,high,-thickness/2.,+thickness/2.);
+    const Surface::PositionType position(0.,0.,second.diskZPosition());
+    BoundDisk* theDisk = new BoundDisk(position,theRotation,diskBounds);
+    theDisk->setMediumProperties(*theMP);
+    return TrackerLayer(theDisk,true,first.layerNumber(),theMin,theMax,theFudge);
+  } 
+
+  const Surface::PositionType position(0.,0.,0.);
+  double radius = second.cylinderRadius();
+  const SimpleCylinderBounds cylBounds(radius-thickness/2.,radius+thickness/2.,-high,+high);
+  BoundCylinder* theCylinder = new BoundCylinder(position,theRotation,cylBounds);
+  theCylinder->setMediumProperties(*theMP);
+  return TrackerLayer(theCylinder,false,first.layerNumber(),theMin,theMax,theFudge);
+
+}
+
+void
+TrackerInteractionGeometry::mergeDeadLayers(Side side, double tolerance) { 
+
+  std::list<TrackerLayer>& cylinders = *_theSides[side];
+
+  // Material budget before merging, for validation
+  const unsigned nEta = 51;
+  const double etaMax = side == PositiveZ ? 5. : -5.;
+  std::vector<double> budgetBefore(nEta);
+  for ( unsigned iEta=0; iEta<nEta; ++iEta ) 
+    budgetBefore[iEta] = materialBudget(iEta*etaMax/(nEta-1));
+  unsigned nBefore = cylinders.size();
+
+  std::list<TrackerLayer>::iterator cyliter = cylinders.begin();
+  while ( cyliter != cylinders.end() ) { 
+    std::list<TrackerLayer>::iterator next = cyliter;
+    ++next;
+    if ( next == cylinders.end() ) break;
+    if ( !mergeable(*cyliter,*next,tolerance) ) { 
+      cyliter = next;
+      continue;
+    }
+    // The merged layer replaces the first one, and may be merged again
+    TrackerLayer merged = mergedLayer(*cyliter,*next);
+    delete &(cyliter->surface());
+    delete &(next->surface());
+    cylinders.erase(next);
+    *cyliter = merged;
+  }
+
+  // Material budget after merging
+  double maxDiff = 0.;
+  double etaDiff = 0.;
+  for ( unsigned iEta=0; iEta<nEta; ++iEta ) { 
+    double eta = iEta*etaMax/(nEta-1);
+    double diff = std::abs(materialBudget(eta)-budgetBefore[iEta]);
+    if ( diff > maxDiff ) { 
+      maxDiff = diff;
+      etaDiff = eta;
+    }
+  }
+
+  edm::LogInfo("TrackerInteractionGeometry") 
+    << "Merged dead-material layers closer than " << tolerance << " cm"
+    << ( side == PositiveZ ? " (z>0) : " : " (z<0) : " )
+    << nBefore << " -> " << cylinders.size() << " layers." << std::endl
+    << "Largest material budget difference : " << maxDiff 
+    << " x/X0 at eta = " << etaDiff;
+
 }
 
 TrackerInteractionGeometry::~TrackerInteractionGeometry()
 {
+  delete _theNeutralTemplates;
+  delete _theCompactTable;
+  delete _theEnergyLossTables;
+  delete _theEnergyLossDensity;
+  delete _theLayerPairTables;
+  delete _theEffectThresholds;
+  delete _theConversionTables;
+  delete _theVoxelGrid[PositiveZ];
+  delete _theVoxelGrid[NegativeZ];
+  delete _theProfiler;
+  delete _theLayerIndex[PositiveZ];
+  delete _theLayerIndex[NegativeZ];
+  // The fixed dead material of a geometry that was never built
+  for ( unsigned i=0; i<16; ++i ) { 
+    delete _theFixedCylinders[i];
+    delete _theFixedDisks[i];
+  }
+  for ( unsigned iGrid=0; iGrid<_theModuleGrids.size(); ++iGrid ) 
+    delete _theModuleGrids[iGrid];
+  for ( unsigned iMap=0; iMap<_theMaterialMaps.size(); ++iMap ) 
+    delete _theMaterialMaps[iMap];
+  for ( unsigned i=0; i<_theMisalignments.size(); ++i ) 
+    delete _theMisalignments[i];
+  _theLayers.clear();
   _theCylinders.clear();
   //  _theRings.clear();
 
-  if(use_hardcoded){
-    // The Beam pipe
-    delete _theMPBeamPipe;
-    // The pixel barrel layers
-    delete _theMPPixelBarrel;
-    // The pixel endcap disks
-    delete _theMPPixelEndcap;
-    // The various cables thicnesses for each layer / disks
-    delete _theMPPixelOutside1;
-    delete _theMPPixelOutside2;
-    delete _theMPPixelOutside3;
-    delete _theMPPixelOutside4;
-    delete _theMPPixelOutside;
-    delete _theMPPixelOutside5;
-    delete _theMPPixelOutside6;
-    // The tracker inner barrel layers
-    delete _theMPTIB1;
-    delete _theMPTIB2;
-    delete _theMPTIB3;
-    delete _theMPTIB4;
-    // The tracker outer barrel layers
-    delete _theMPTOB1;
-    delete _theMPTOB2;
-    delete _theMPTOB3;
-    delete _theMPTOB4;
-    delete _theMPTOB5;
-    delete _theMPTOB6;
-    // The tracker inner disks
-    delete _theMPInner1;
-    delete _theMPInner2;
-    delete _theMPInner3;
-    // The tracker endcap disks
-    delete _theMPEndcap;
-    // Various cable thicknesses 
-    delete _theMPTOBBInside;
-    delete _theMPTIBEOutside1;
-    delete _theMPTIBEOutside2;
-    delete _theMPTIDEOutside;
-    delete _theMPTOBEOutside;
-    delete _theMPBarrelOutside;
-    delete _theMPEndcapOutside;
-    delete _theMPEndcapOutside2;
-    
-  }
-  else {
-    for(unsigned int i = 0; i < _mediumProperties.size(); i++){
-      delete _mediumProperties[i];
-    }
+  // All media (hardcoded and flexible geometries, merged layers)
+  for(unsigned int i = 0; i < _mediumProperties.size(); i++){
+    delete _mediumProperties[i];
   }
 
 }
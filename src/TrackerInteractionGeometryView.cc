@@ -0,0 +1,76 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerInteractionGeometryView.h"
+
+#include <algorithm>
+#include <cmath>
+
+TrackerInteractionGeometryView::TrackerInteractionGeometryView(const TrackerInteractionGeometry& geometry,
+							       double maxRadius, 
+							       double maxZ) :
+  theMaxRadius(maxRadius),
+  theMaxZ(maxZ)
+{
+  fill(geometry,0);
+}
+
+TrackerInteractionGeometryView::TrackerInteractionGeometryView(const TrackerInteractionGeometry& geometry,
+							       const std::vector<TrackerInteractionGeometry::FirstCylinders>& subDetectors) :
+  theMaxRadius(0.),
+  theMaxZ(0.)
+{
+
+  // The envelope of the sensitive layers of the subdetectors
+  for ( unsigned iLayer=0; iLayer<static_cast<unsigned>(geometry.nCylinders()); ++iLayer ) { 
+    const TrackerLayer& layer = geometry.layer(iLayer);
+    if ( !layer.sensitive() ) continue;
+    if ( std::find(subDetectors.begin(),subDetectors.end(),
+		   subDetector(layer.layerNumber())) == subDetectors.end() ) continue;
+    if ( layer.forward() ) { 
+      theMaxRadius = std::max(theMaxRadius,layer.diskOuterRadius());
+      theMaxZ = std::max(theMaxZ,std::abs(layer.diskZPosition()));
+    } else { 
+      theMaxRadius = std::max(theMaxRadius,layer.cylinderRadius());
+      theMaxZ = std::max(theMaxZ,layer.cylinderHalfLength());
+    }
+  }
+
+  fill(geometry,&subDetectors);
+
+}
+
+void
+TrackerInteractionGeometryView::fill(const TrackerInteractionGeometry& geometry,
+				     const std::vector<TrackerInteractionGeometry::FirstCylinders>* subDetectors) { 
+
+  for ( unsigned side=0; side<2; ++side ) { 
+    TrackerInteractionGeometry::Side theSide = static_cast<TrackerInteractionGeometry::Side>(side);
+    unsigned nLayers = geometry.nCylinders(theSide);
+    for ( unsigned iLayer=0; iLayer<nLayers; ++iLayer ) { 
+      const TrackerLayer& layer = geometry.layer(theSide,iLayer);
+      if ( !reaches(layer) ) continue;
+      // Only the sensitive layers of the requested subdetectors
+      if ( subDetectors && layer.sensitive() && 
+	   std::find(subDetectors->begin(),subDetectors->end(),
+		     subDetector(layer.layerNumber())) == subDetectors->end() ) continue;
+      theLayers[side].push_back(&layer);
+      theIndices[side].push_back(iLayer);
+    }
+  }
+
+}
+
+bool
+TrackerInteractionGeometryView::reaches(const TrackerLayer& layer) const { 
+  if ( layer.forward() ) 
+    return std::abs(layer.diskZPosition()) <= theMaxZ && layer.diskInnerRadius() <= theMaxRadius;
+  return layer.cylinderRadius() <= theMaxRadius;
+}
+
+TrackerInteractionGeometry::FirstCylinders
+TrackerInteractionGeometryView::subDetector(unsigned layerNumber) { 
+  if ( layerNumber > TrackerInteractionGeometry::TEC ) return TrackerInteractionGeometry::TEC;
+  if ( layerNumber > TrackerInteractionGeometry::TOB ) return TrackerInteractionGeometry::TOB;
+  if ( layerNumber > TrackerInteractionGeometry::TID ) return TrackerInteractionGeometry::TID;
+  if ( layerNumber > TrackerInteractionGeometry::TIB ) return TrackerInteractionGeometry::TIB;
+  if ( layerNumber > TrackerInteractionGeometry::PXD ) return TrackerInteractionGeometry::PXD;
+  return TrackerInteractionGeometry::PXB;
+}
@@ -0,0 +1,92 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerInteractionProfile.h"
+
+#include <algorithm>
+#include <cmath>
+
+const double TrackerInteractionProfile::maxTemplateVertexRadius = 0.1;
+
+void
+TrackerInteractionProfile::fill(const TrackerInteractionGeometry& geometry,
+				const GlobalPoint& vertex,
+				const GlobalVector& direction,
+				unsigned firstLayer) {
+
+  // Lines from the beam line : from the templates, if any
+  const TrackerCrossingTemplates* templates = geometry.neutralCrossingTemplates();
+  if ( templates && !firstLayer && vertex.perp() < maxTemplateVertexRadius && 
+       fill(*templates,vertex,direction) ) return;
+
+  theCrossings.clear();
+  theCumulative.assign(1,0.);
+  TrackerLayerStepper stepper(geometry,vertex,direction,firstLayer);
+  TrackerLayerStepper::Crossing crossing;
+  while ( stepper.next(crossing) ) {
+    theCrossings.push_back(crossing);
+    theCumulative.push_back(theCumulative.back()+crossing.radLen);
+  }
+
+}
+
+bool
+TrackerInteractionProfile::fill(const TrackerCrossingTemplates& templates,
+				const GlobalPoint& vertex,
+				const GlobalVector& direction) {
+
+  double eta = direction.eta();
+  if ( !templates.covers(eta,vertex.z()) ) return false;
+  TrackerCrossingTemplates::CrossingRange range = templates.crossings(eta,vertex.z());
+  GlobalVector unit = direction.unit();
+
+  theCrossings.resize(range.second-range.first);
+  theCumulative.resize(theCrossings.size()+1);
+  theCumulative[0] = 0.;
+  unsigned i = 0;
+  for ( std::vector<TrackerCrossingTemplates::Crossing>::const_iterator 
+	  crossing=range.first; crossing!=range.second; ++crossing, ++i ) {
+    TrackerLayerStepper::Crossing& result = theCrossings[i];
+    result.layer = crossing->layer;
+    result.path = crossing->path;
+    result.position = vertex + unit*crossing->path;
+    result.radLen = crossing->radLen;
+    theCumulative[i+1] = crossing->radLenBefore + crossing->radLen;
+  }
+  return true;
+
+}
+
+double
+TrackerInteractionProfile::probability(unsigned i, double lambda) const {
+  return 1.-std::exp(-theCumulative[i+1]/lambda);
+}
+
+double
+TrackerInteractionProfile::probability(double lambda) const {
+  return 1.-std::exp(-totalRadLen()/lambda);
+}
+
+int
+TrackerInteractionProfile::firstInteraction(double u, double v,
+					    const std::vector<double>& lambdas,
+					    unsigned& process) const {
+
+  // The processes compete : the depth of the first interaction follows
+  // an exponential law with the summed rate
+  double rate = 0.;
+  for ( unsigned iProcess=0; iProcess<lambdas.size(); ++iProcess )
+    rate += 1./lambdas[iProcess];
+  if ( rate <= 0. ) return -1;
+  double depth = -std::log(1.-u)/rate;
+  if ( depth >= totalRadLen() ) return -1;
+
+  // The crossing where the cumulative material reaches that depth
+  int i = std::upper_bound(theCumulative.begin(),theCumulative.end(),depth)
+    - theCumulative.begin() - 1;
+
+  // The process, in proportion of its rate
+  double threshold = v*rate;
+  process = 0;
+  for ( double sum=1./lambdas[0]; sum<threshold && process+1<lambdas.size(); )
+    sum += 1./lambdas[++process];
+  return i;
+
+}
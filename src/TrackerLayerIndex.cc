@@ -0,0 +1,188 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerIndex.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+TrackerLayerIndex::TrackerLayerIndex(const std::vector<const TrackerLayer*>& layers) :
+  theLayers(layers)
+{
+
+  // Sort (key, index) pairs, then fill the arrays in that order
+  std::vector< std::pair<double,unsigned> > cylinders;
+  std::vector< std::pair<double,unsigned> > disks;
+  for ( unsigned iLayer=0; iLayer<layers.size(); ++iLayer ) {
+    if ( layers[iLayer]->forward() )
+      disks.push_back(std::make_pair(std::abs(layers[iLayer]->diskZPosition()),iLayer));
+    else
+      cylinders.push_back(std::make_pair(layers[iLayer]->cylinderRadius(),iLayer));
+  }
+  std::stable_sort(cylinders.begin(),cylinders.end());
+  std::stable_sort(disks.begin(),disks.end());
+
+  for ( unsigned i=0; i<cylinders.size(); ++i ) {
+    const TrackerLayer* layer = layers[cylinders[i].second];
+    theCylinderRadius.push_back(cylinders[i].first);
+    theCylinderHalfLength.push_back(layer->cylinderHalfLength());
+    theCylinderIndex.push_back(cylinders[i].second);
+  }
+  for ( unsigned i=0; i<disks.size(); ++i ) {
+    const TrackerLayer* layer = layers[disks[i].second];
+    theDiskZ.push_back(disks[i].first);
+    theDiskInnerRadius.push_back(layer->diskInnerRadius());
+    theDiskOuterRadius.push_back(layer->diskOuterRadius());
+    theDiskIndex.push_back(disks[i].second);
+  }
+
+  // The max-trees, with the leaves in sorted order
+  for ( theCylinderLeaves=1; theCylinderLeaves<nCylinders(); theCylinderLeaves*=2 ) {}
+  theCylinderTree.assign(2*theCylinderLeaves,-1E30);
+  std::copy(theCylinderHalfLength.begin(),theCylinderHalfLength.end(),
+	    theCylinderTree.begin()+theCylinderLeaves);
+  buildMaxTree(theCylinderTree,theCylinderLeaves);
+  for ( theDiskLeaves=1; theDiskLeaves<nDisks(); theDiskLeaves*=2 ) {}
+  theDiskTree.assign(2*theDiskLeaves,-1E30);
+  std::copy(theDiskOuterRadius.begin(),theDiskOuterRadius.end(),
+	    theDiskTree.begin()+theDiskLeaves);
+  buildMaxTree(theDiskTree,theDiskLeaves);
+
+  // The segment tree of the disk radius intervals. The disks are added
+  // in |z| order, so that the positions of each node come sorted.
+  theDiskRadii = theDiskInnerRadius;
+  theDiskRadii.insert(theDiskRadii.end(),theDiskOuterRadius.begin(),theDiskOuterRadius.end());
+  std::sort(theDiskRadii.begin(),theDiskRadii.end());
+  theDiskRadii.erase(std::unique(theDiskRadii.begin(),theDiskRadii.end()),theDiskRadii.end());
+  unsigned nPieces = theDiskRadii.empty() ? 1 : 2*theDiskRadii.size()-1;
+  for ( theDiskPieces=1; theDiskPieces<nPieces; theDiskPieces*=2 ) {}
+  theDiskNodes.resize(2*theDiskPieces);
+  for ( unsigned pos=0; pos<nDisks(); ++pos ) {
+    if ( theDiskOuterRadius[pos] < theDiskInnerRadius[pos] ) continue;
+    unsigned low = 2*(std::lower_bound(theDiskRadii.begin(),theDiskRadii.end(),theDiskInnerRadius[pos])
+		      - theDiskRadii.begin());
+    unsigned high = 2*(std::lower_bound(theDiskRadii.begin(),theDiskRadii.end(),theDiskOuterRadius[pos])
+		       - theDiskRadii.begin());
+    for ( low+=theDiskPieces, high+=theDiskPieces+1; low<high; low/=2, high/=2 ) {
+      if ( low & 1 ) theDiskNodes[low++].push_back(pos);
+      if ( high & 1 ) theDiskNodes[--high].push_back(pos);
+    }
+  }
+
+}
+
+void
+TrackerLayerIndex::buildMaxTree(std::vector<double>& tree, unsigned nLeaves) {
+  for ( unsigned node=nLeaves-1; node>=1; --node )
+    tree[node] = std::max(tree[2*node],tree[2*node+1]);
+}
+
+unsigned
+TrackerLayerIndex::firstAtLeast(const std::vector<double>& tree, unsigned node,
+				unsigned low, unsigned high, unsigned from, double x) {
+  // Each level descends into at most one subtree that straddles from
+  // or fails, so that the search takes O(log N) steps
+  if ( high <= from || tree[node] < x ) return high;
+  if ( high-low == 1 ) return low;
+  unsigned middle = (low+high)/2;
+  unsigned left = firstAtLeast(tree,2*node,low,middle,from,x);
+  if ( left < middle ) return left;
+  return firstAtLeast(tree,2*node+1,middle,high,from,x);
+}
+
+unsigned
+TrackerLayerIndex::cylinderPosition(double r) const {
+  return std::upper_bound(theCylinderRadius.begin(),theCylinderRadius.end(),r)
+    - theCylinderRadius.begin();
+}
+
+unsigned
+TrackerLayerIndex::diskPosition(double z) const {
+  return std::upper_bound(theDiskZ.begin(),theDiskZ.end(),z) - theDiskZ.begin();
+}
+
+unsigned
+TrackerLayerIndex::firstCylinder(unsigned from, double z) const {
+  if ( from >= nCylinders() ) return nCylinders();
+  return std::min(nCylinders(),firstAtLeast(theCylinderTree,1,0,theCylinderLeaves,from,z));
+}
+
+unsigned
+TrackerLayerIndex::firstDisk(unsigned from, double r) const {
+  if ( from >= nDisks() ) return nDisks();
+  return std::min(nDisks(),firstAtLeast(theDiskTree,1,0,theDiskLeaves,from,r));
+}
+
+void
+TrackerLayerIndex::layers(double rMin, double rMax, double zMin, double zMax,
+			  std::vector<unsigned>& result) const {
+  result.clear();
+
+  // Cylinders with a radius in [rMin,rMax], long enough to reach zMin
+  unsigned pos = std::lower_bound(theCylinderRadius.begin(),theCylinderRadius.end(),rMin)
+    - theCylinderRadius.begin();
+  for ( pos=firstCylinder(pos,zMin); pos<nCylinders() && theCylinderRadius[pos]<=rMax;
+	pos=firstCylinder(pos+1,zMin) )
+    result.push_back(theCylinderIndex[pos]);
+
+  // Disks with a |z| in [zMin,zMax], overlapping [rMin,rMax]
+  pos = std::lower_bound(theDiskZ.begin(),theDiskZ.end(),zMin) - theDiskZ.begin();
+  for ( pos=firstDisk(pos,rMin); pos<nDisks() && theDiskZ[pos]<=zMax; pos=firstDisk(pos+1,rMin) )
+    if ( theDiskInnerRadius[pos] <= rMax ) result.push_back(theDiskIndex[pos]);
+}
+
+int
+TrackerLayerIndex::nextCylinder(double r, double z) const {
+  unsigned pos = firstCylinder(cylinderPosition(r),std::abs(z));
+  return pos < nCylinders() ? static_cast<int>(theCylinderIndex[pos]) : -1;
+}
+
+int
+TrackerLayerIndex::nextDisk(double r, double z) const {
+
+  // The piece of the radius axis containing r
+  if ( theDiskRadii.empty() || r < theDiskRadii.front() || r > theDiskRadii.back() ) return -1;
+  unsigned k = std::lower_bound(theDiskRadii.begin(),theDiskRadii.end(),r) - theDiskRadii.begin();
+  unsigned piece = theDiskRadii[k] == r ? 2*k : 2*k-1;
+
+  // The disks containing r are in the nodes above that piece
+  unsigned from = diskPosition(std::abs(z));
+  unsigned best = nDisks();
+  for ( unsigned node=piece+theDiskPieces; node>=1; node/=2 ) {
+    const std::vector<unsigned>& positions = theDiskNodes[node];
+    std::vector<unsigned>::const_iterator first =
+      std::lower_bound(positions.begin(),positions.end(),from);
+    if ( first != positions.end() ) best = std::min(best,*first);
+  }
+  return best < nDisks() ? static_cast<int>(theDiskIndex[best]) : -1;
+
+}
+
+double
+TrackerLayerIndex::straightRadLen(double z0, double sinTheta, double cosTheta) const {
+
+  double radLen = 0.;
+
+  // Cylinders : |z| grows with the radius along the line (cosTheta >= 0),
+  // so that each layer visited sets a lower bound on the half length of
+  // the next candidates
+  if ( sinTheta > 0. ) {
+    double cotTheta = cosTheta/sinTheta;
+    double zLower = std::max(0.,z0);
+    for ( unsigned pos=firstCylinder(0,zLower); pos<nCylinders(); pos=firstCylinder(pos+1,zLower) ) {
+      radLen += theLayers[theCylinderIndex[pos]]->straightRadLen(z0,sinTheta,cosTheta);
+      if ( cosTheta >= 0. ) zLower = std::max(zLower,z0+theCylinderRadius[pos]*cotTheta);
+    }
+  }
+
+  // Disks : the radius grows with |z|, and bounds the outer radius of
+  // the next candidates
+  if ( cosTheta > 0. ) {
+    double tanTheta = sinTheta/cosTheta;
+    for ( unsigned pos=firstDisk(diskPosition(z0),0.); pos<nDisks();
+	  pos=firstDisk(pos+1,(theDiskZ[pos]-z0)*tanTheta) )
+      radLen += theLayers[theDiskIndex[pos]]->straightRadLen(z0,sinTheta,cosTheta);
+  }
+
+  return radLen;
+
+}
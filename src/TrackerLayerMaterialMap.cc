@@ -0,0 +1,125 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerMaterialMap.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayer.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cstring>
+#include <fstream>
+
+TrackerLayerMaterialMap::TrackerLayerMaterialMap(unsigned nU, double uMin, double uMax,
+						 unsigned nPhi, const std::vector<float>& factors) :
+  theNU(nU),
+  theNPhi(nPhi),
+  theLastU(nU-1),
+  theLastPhi(nPhi-1),
+  theUMin(uMin),
+  theUMax(uMax),
+  theFactors(factors)
+{
+
+  if ( !nU || !nPhi || uMax <= uMin || factors.size() != nU*nPhi )
+    throw cms::Exception("FastSimulation/TrackerLayerMaterialMap")
+      << "Inconsistent material map : " << nU << " x " << nPhi << " bins over ["
+      << uMin << "," << uMax << "], with " << factors.size() << " factors";
+  theInvUStep = nU/(uMax-uMin);
+  theInvPhiStep = nPhi/(2.*M_PI);
+  fillMeanFactors();
+
+}
+
+TrackerLayerMaterialMap::TrackerLayerMaterialMap(const TrackerLayer& layer, unsigned nU) :
+  theNU(nU),
+  theNPhi(1),
+  theLastU(nU-1),
+  theLastPhi(0),
+  theUMin(layer.forward() ? layer.diskInnerRadius() : 0.),
+  theUMax(layer.forward() ? layer.diskOuterRadius() : layer.cylinderHalfLength()),
+  theFactors(nU)
+{
+
+  theInvUStep = nU/(theUMax-theUMin);
+  theInvPhiStep = 1./(2.*M_PI);
+
+  // The mean factor over each bin, so that the material budget of the
+  // layer is kept when the range edges do not fall on the bin edges
+  const unsigned nSamples = 16;
+  double step = (theUMax-theUMin)/nU;
+  for ( unsigned i=0; i<nU; ++i ) {
+    double sum = 0.;
+    for ( unsigned j=0; j<nSamples; ++j )
+      sum += layer.rangeFudgeFactorAt(theUMin+(i+(j+0.5)/nSamples)*step);
+    theFactors[i] = sum/nSamples;
+  }
+  fillMeanFactors();
+
+}
+
+float
+TrackerLayerMaterialMap::interpolated(double u, double phi) const {
+
+  // u clamped to the first and last bin centers, phi periodic
+  double x = std::min(std::max((u-theUMin)*theInvUStep-0.5,0.),static_cast<double>(theLastU));
+  double y = (phi+M_PI)*theInvPhiStep-0.5;
+  int i0 = static_cast<int>(x);
+  int i1 = std::min(i0+1,theLastU);
+  double fu = x-i0;
+  double yFloor = std::floor(y);
+  double fphi = y-yFloor;
+  int j0 = (static_cast<int>(yFloor)+theNPhi) % theNPhi;
+  int j1 = (j0+1) % theNPhi;
+  const float* row0 = &theFactors[j0*theNU];
+  const float* row1 = &theFactors[j1*theNU];
+  return (1.-fphi) * ( (1.-fu)*row0[i0] + fu*row0[i1] )
+    +          fphi  * ( (1.-fu)*row1[i0] + fu*row1[i1] );
+
+}
+
+void
+TrackerLayerMaterialMap::factors(unsigned n, const float* u, const float* phi,
+				 float* result) const {
+  float uMin = theUMin;
+  float invUStep = theInvUStep;
+  float invPhiStep = theInvPhiStep;
+  float pi = M_PI;
+  const float* table = &theFactors[0];
+  for ( unsigned i=0; i<n; ++i ) {
+    int iU = std::min(std::max(static_cast<int>((u[i]-uMin)*invUStep),0),theLastU);
+    int iPhi = std::min(std::max(static_cast<int>((phi[i]+pi)*invPhiStep),0),theLastPhi);
+    result[i] = table[iPhi*theNU+iU];
+  }
+}
+
+void
+TrackerLayerMaterialMap::fillMeanFactors() {
+  theMeanFactors.assign(theNU,0.);
+  for ( unsigned j=0; j<theNPhi; ++j )
+    for ( unsigned i=0; i<theNU; ++i )
+      theMeanFactors[i] += theFactors[j*theNU+i];
+  for ( unsigned i=0; i<theNU; ++i )
+    theMeanFactors[i] /= theNPhi;
+}
+
+void
+TrackerLayerMaterialMap::read(const std::string& fileName,
+			      std::vector<unsigned>& layerNumbers,
+			      std::vector<TrackerLayerMaterialMap*>& maps) {
+
+  std::ifstream file(fileName.c_str(),std::ios::binary);
+  char magic[8];
+  if ( !file.read(magic,8) || std::memcmp(magic,"TKMMAP01",8) )
+    throw cms::Exception("FastSimulation/TrackerLayerMaterialMap")
+      << fileName << " is not a material map file";
+
+  unsigned header[3];
+  float range[2];
+  while ( file.read(reinterpret_cast<char*>(header),sizeof(header)) ) {
+    std::vector<float> factors(header[1]*header[2]);
+    if ( !file.read(reinterpret_cast<char*>(range),sizeof(range)) ||
+	 !file.read(reinterpret_cast<char*>(&factors[0]),factors.size()*sizeof(float)) )
+      throw cms::Exception("FastSimulation/TrackerLayerMaterialMap")
+	<< fileName << " : truncated map for layer " << header[0];
+    layerNumbers.push_back(header[0]);
+    maps.push_back(new TrackerLayerMaterialMap(header[1],range[0],range[1],header[2],factors));
+  }
+
+}
@@ -0,0 +1,120 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerModuleGrid.h"
+
+#include "Geometry/CommonDetUnit/interface/GeomDet.h"
+#include "DataFormats/GeometrySurface/interface/Bounds.h"
+
+#include <algorithm>
+#include <cmath>
+
+TrackerLayerModuleGrid::TrackerLayerModuleGrid(const std::vector<const GeomDet*>& modules,
+					       bool isForward,
+					       unsigned nPhi,
+					       unsigned nU) :
+  theModules(modules),
+  isForward(isForward),
+  theNPhi(nPhi),
+  theNU(nU),
+  thePhiStep(2.*M_PI/nPhi)
+{
+
+  // The extent of each module in phi (around its center) and in u,
+  // from the corners and the middle of the edges of its bounds
+  std::vector<double> phiCenter(theModules.size());
+  std::vector<double> phiLow(theModules.size()), phiHigh(theModules.size());
+  std::vector<double> uLow(theModules.size()), uHigh(theModules.size());
+  theUMin = 1E9;
+  theUMax = -1E9;
+  for ( unsigned iMod=0; iMod<theModules.size(); ++iMod ) {
+    const BoundPlane& plane = theModules[iMod]->surface();
+    double halfWidth = plane.bounds().width()/2.;
+    double halfLength = plane.bounds().length()/2.;
+    phiCenter[iMod] = plane.position().phi();
+    phiLow[iMod] = 0.;
+    phiHigh[iMod] = 0.;
+    uLow[iMod] = 1E9;
+    uHigh[iMod] = -1E9;
+    for ( int ix=-1; ix<=1; ++ix ) {
+      for ( int iy=-1; iy<=1; ++iy ) {
+	GlobalPoint corner = plane.toGlobal(LocalPoint(ix*halfWidth,iy*halfLength,0.));
+	double dPhi = corner.phi()-phiCenter[iMod];
+	if ( dPhi > M_PI ) dPhi -= 2.*M_PI;
+	if ( dPhi < -M_PI ) dPhi += 2.*M_PI;
+	phiLow[iMod] = std::min(phiLow[iMod],dPhi);
+	phiHigh[iMod] = std::max(phiHigh[iMod],dPhi);
+	uLow[iMod] = std::min(uLow[iMod],u(corner));
+	uHigh[iMod] = std::max(uHigh[iMod],u(corner));
+      }
+    }
+    theUMin = std::min(theUMin,uLow[iMod]);
+    theUMax = std::max(theUMax,uHigh[iMod]);
+  }
+  // A layer without modules (or with all its modules at the same u)
+  // gets a single empty (or full) row of cells
+  if ( theModules.empty() ) {
+    theUMin = 0.;
+    theUMax = 0.;
+  }
+  theUStep = theUMax > theUMin ? (theUMax-theUMin)/theNU : 1.;
+
+  // Fill the cells overlapped by each module
+  std::vector< std::vector<unsigned> > cells(theNPhi*theNU);
+  for ( unsigned iMod=0; iMod<theModules.size(); ++iMod ) {
+    int iPhiLow = static_cast<int>(std::floor((phiCenter[iMod]+phiLow[iMod]+M_PI)/thePhiStep));
+    int iPhiHigh = static_cast<int>(std::floor((phiCenter[iMod]+phiHigh[iMod]+M_PI)/thePhiStep));
+    int iULow = std::max(0,static_cast<int>((uLow[iMod]-theUMin)/theUStep));
+    int iUHigh = std::min<int>(theNU-1,static_cast<int>((uHigh[iMod]-theUMin)/theUStep));
+    for ( int iPhi=iPhiLow; iPhi<=iPhiHigh; ++iPhi ) {
+      unsigned jPhi = (iPhi+theNPhi) % theNPhi;
+      for ( int iU=iULow; iU<=iUHigh; ++iU )
+	cells[jPhi*theNU+iU].push_back(iMod);
+    }
+  }
+
+  theOffsets.reserve(cells.size()+1);
+  theOffsets.push_back(0);
+  for ( unsigned iCell=0; iCell<cells.size(); ++iCell ) {
+    theIndices.insert(theIndices.end(),cells[iCell].begin(),cells[iCell].end());
+    theOffsets.push_back(theIndices.size());
+  }
+
+}
+
+int
+TrackerLayerModuleGrid::cell(const GlobalPoint& point) const {
+  double theU = u(point);
+  if ( theU < theUMin || theU > theUMax ) return -1;
+  unsigned iPhi = static_cast<unsigned>((point.phi()+M_PI)/thePhiStep) % theNPhi;
+  unsigned iU = std::min<unsigned>(theNU-1,static_cast<unsigned>((theU-theUMin)/theUStep));
+  return iPhi*theNU+iU;
+}
+
+const GeomDet*
+TrackerLayerModuleGrid::module(const GlobalPoint& point) const {
+  int iCell = cell(point);
+  if ( iCell < 0 ) return 0;
+  for ( unsigned i=theOffsets[iCell]; i<theOffsets[iCell+1]; ++i ) {
+    const GeomDet* det = theModules[theIndices[i]];
+    LocalPoint local = det->surface().toLocal(point);
+    if ( det->surface().bounds().inside(LocalPoint(local.x(),local.y(),0.)) )
+      return det;
+  }
+  return 0;
+}
+
+void
+TrackerLayerModuleGrid::candidates(const GlobalPoint& point,
+				   std::vector<const GeomDet*>& result) const {
+  result.clear();
+  int iCell = cell(point);
+  if ( iCell < 0 ) return;
+  for ( unsigned i=theOffsets[iCell]; i<theOffsets[iCell+1]; ++i )
+    result.push_back(theModules[theIndices[i]]);
+}
+
+unsigned
+TrackerLayerModuleGrid::maxCandidates() const {
+  unsigned maxSize = 0;
+  for ( unsigned iCell=0; iCell+1<theOffsets.size(); ++iCell )
+    maxSize = std::max(maxSize,theOffsets[iCell+1]-theOffsets[iCell]);
+  return maxSize;
+}
@@ -0,0 +1,84 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerPairTables.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayer.h"
+
+#include <utility>
+
+TrackerLayerPairTables::TrackerLayerPairTables(const std::vector<const TrackerLayer*>& positiveLayers,
+					       const std::vector<const TrackerLayer*>& negativeLayers,
+					       unsigned nEta, double etaMax) :
+  theNEta(nEta),
+  theEtaStep(etaMax/nEta),
+  theInvEtaStep(nEta/etaMax),
+  theNSensitive(0)
+{
+
+  // The sensitive layers of each side, in the order of the layer list
+  const std::vector<const TrackerLayer*>* layers[2] = { &positiveLayers, &negativeLayers };
+  for ( unsigned side=0; side<2; ++side ) {
+    theSensitiveIndex[side].assign(MaxLayerNumber,-1);
+    int n = 0;
+    for ( unsigned iLayer=0; iLayer<layers[side]->size(); ++iLayer ) {
+      if ( !(*layers[side])[iLayer]->sensitive() ) continue;
+      unsigned number = (*layers[side])[iLayer]->layerNumber();
+      if ( number < MaxLayerNumber && theSensitiveIndex[side][number] < 0 )
+	theSensitiveIndex[side][number] = n++;
+    }
+    theNSensitive = std::max(theNSensitive,static_cast<unsigned>(n));
+  }
+
+  theRadLen.assign(2*theNSensitive*theNSensitive*theNEta,-1.f);
+  theCoefficient.assign(theRadLen.size(),0.f);
+  fill(0,positiveLayers);
+  fill(1,negativeLayers);
+
+}
+
+void
+TrackerLayerPairTables::fill(unsigned side, const std::vector<const TrackerLayer*>& layers) {
+
+  std::vector< std::pair<double,unsigned> > crossings;
+  std::vector<double> radLens(layers.size());
+  std::vector<double> before(layers.size());
+  for ( unsigned iEta=0; iEta<theNEta; ++iEta ) {
+
+    // The crossings of the line at the bin center, in path order,
+    // in the coordinates folded to the side (z0 = 0)
+    double theta = 2.*std::atan(std::exp(-(iEta+0.5)*theEtaStep));
+    double sinTheta = std::sin(theta);
+    double cosTheta = std::cos(theta);
+    crossings.clear();
+    double path, dim, angle;
+    for ( unsigned iLayer=0; iLayer<layers.size(); ++iLayer ) {
+      const TrackerLayer& layer = *layers[iLayer];
+      if ( !layer.straightCrossing(0.,sinTheta,cosTheta,path,dim,angle) ) continue;
+      radLens[iLayer] = layer.radLen() * layer.fudgeFactorAt(dim) * angle;
+      crossings.push_back(std::make_pair(path,iLayer));
+    }
+    std::stable_sort(crossings.begin(),crossings.end());
+
+    // The material in front of each crossed layer
+    double sum = 0.;
+    for ( unsigned i=0; i<crossings.size(); ++i ) {
+      before[crossings[i].second] = sum;
+      sum += radLens[crossings[i].second];
+    }
+
+    // All the pairs of crossed sensitive layers, in crossing order
+    for ( unsigned i=0; i<crossings.size(); ++i ) {
+      if ( !layers[crossings[i].second]->sensitive() ) continue;
+      unsigned a = layers[crossings[i].second]->layerNumber();
+      int iA = theSensitiveIndex[side][a];
+      for ( unsigned j=i+1; j<crossings.size(); ++j ) {
+	if ( !layers[crossings[j].second]->sensitive() ) continue;
+	unsigned b = layers[crossings[j].second]->layerNumber();
+	int iB = theSensitiveIndex[side][b];
+	double x = before[crossings[j].second] - before[crossings[i].second];
+	unsigned index = ((side*theNSensitive+iA)*theNSensitive+iB)*theNEta+iEta;
+	theRadLen[index] = x;
+	theCoefficient[index] = x > 0. ? 0.0136*std::sqrt(x)*(1.+0.038*std::log(x)) : 0.;
+      }
+    }
+
+  }
+
+}
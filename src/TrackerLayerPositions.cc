@@ -0,0 +1,232 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerPositions.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "RecoTracker/TkDetLayers/interface/GeometricSearchTracker.h"
+#include "TrackingTools/DetLayers/interface/BarrelDetLayer.h"
+#include "TrackingTools/DetLayers/interface/ForwardDetLayer.h"
+#include "Geometry/CommonDetUnit/interface/GeomDet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace { 
+
+  // Means and covariances of the ideal module positions p and of their 
+  // displacements d to the misaligned positions, over the modules of a layer
+  struct Moments { 
+    Moments(const std::vector<GlobalPoint>& ideal, const std::vector<GlobalPoint>& misaligned) : 
+      x(0.), y(0.), z(0.), dx(0.), dy(0.), dz(0.), 
+      xx(0.), yy(0.), zz(0.), dxz(0.), dyz(0.), dzx(0.), dzy(0.) { 
+      double n = ideal.size();
+      if ( !n ) return;
+      for ( unsigned i=0; i<ideal.size(); ++i ) { 
+	const GlobalPoint& p = ideal[i];
+	GlobalVector d = misaligned[i]-p;
+	x += p.x(); y += p.y(); z += p.z();
+	dx += d.x(); dy += d.y(); dz += d.z();
+	xx += p.x()*p.x(); yy += p.y()*p.y(); zz += p.z()*p.z();
+	dxz += d.x()*p.z(); dyz += d.y()*p.z(); 
+	dzx += d.z()*p.x(); dzy += d.z()*p.y();
+      }
+      x /= n; y /= n; z /= n;
+      dx /= n; dy /= n; dz /= n;
+      xx = xx/n-x*x; yy = yy/n-y*y; zz = zz/n-z*z;
+      dxz = dxz/n-dx*z; dyz = dyz/n-dy*z;
+      dzx = dzx/n-dz*x; dzy = dzy/n-dz*y;
+    }
+    double x, y, z, dx, dy, dz;
+    double xx, yy, zz, dxz, dyz, dzx, dzy;
+  };
+
+  // The module positions of a layer, checked against those of the ideal layer
+  void modulePositions(const GeometricSearchDet& layer, const GeometricSearchDet& idealLayer, 
+		       std::vector<GlobalPoint>& positions, std::vector<GlobalPoint>& idealPositions) { 
+    const std::vector<const GeomDet*>& modules = layer.basicComponents();
+    const std::vector<const GeomDet*>& idealModules = idealLayer.basicComponents();
+    if ( modules.size() != idealModules.size() ) 
+      throw cms::Exception("FastSimulation/TrackerLayerPositions") 
+	<< "A layer has " << modules.size() << " modules, and " << idealModules.size() 
+	<< " in the ideal geometry";
+    positions.clear();
+    idealPositions.clear();
+    for ( unsigned i=0; i<modules.size(); ++i ) { 
+      if ( modules[i]->geographicalId() != idealModules[i]->geographicalId() ) 
+	throw cms::Exception("FastSimulation/TrackerLayerPositions") 
+	  << "The modules of a layer are not in the same order as in the ideal geometry";
+      positions.push_back(modules[i]->position());
+      idealPositions.push_back(idealModules[i]->position());
+    }
+  }
+
+}
+
+TrackerLayerMisalignment
+TrackerLayerPositions::fitBarrelMisalignment(const std::vector<GlobalPoint>& ideal,
+					     const std::vector<GlobalPoint>& misaligned) { 
+
+  // To first order, d = (dx + tiltY z, dy - tiltX z, dz - tiltY x + tiltX y)
+  Moments m(ideal,misaligned);
+  TrackerLayerMisalignment result;
+  result.tiltY = m.zz > 0. ? m.dxz/m.zz : 0.;
+  result.tiltX = m.zz > 0. ? -m.dyz/m.zz : 0.;
+  result.dx = m.dx - result.tiltY*m.z;
+  result.dy = m.dy + result.tiltX*m.z;
+  result.dz = m.dz + result.tiltY*m.x - result.tiltX*m.y;
+  result.zCenter = 0.;
+  return result;
+
+}
+
+TrackerLayerMisalignment
+TrackerLayerPositions::fitForwardMisalignment(const std::vector<GlobalPoint>& ideal,
+					      const std::vector<GlobalPoint>& misaligned,
+					      double z) { 
+
+  // The same, around (0,0,z) : the tilts from the slopes of dz with x and y
+  Moments m(ideal,misaligned);
+  TrackerLayerMisalignment result;
+  result.tiltY = m.xx > 0. ? -m.dzx/m.xx : 0.;
+  result.tiltX = m.yy > 0. ? m.dzy/m.yy : 0.;
+  result.dx = m.dx - result.tiltY*(m.z-z);
+  result.dy = m.dy + result.tiltX*(m.z-z);
+  result.dz = m.dz + result.tiltY*m.x - result.tiltX*m.y;
+  result.zCenter = z;
+  return result;
+
+}
+
+TrackerLayerPositions::TrackerLayerPositions(const GeometricSearchTracker& geomSearchTracker,
+					     const GeometricSearchTracker* idealGeomSearchTracker)
+{
+
+  std::vector< BarrelDetLayer*> barrelLayers = geomSearchTracker.barrelLayers();
+  for ( unsigned i=0; i<barrelLayers.size(); ++i ) { 
+    theBarrelRadius.push_back(barrelLayers[i]->specificSurface().radius());
+    theBarrelLength.push_back(barrelLayers[i]->specificSurface().bounds().length());
+  }
+
+  std::vector< ForwardDetLayer*> forwardLayers[2] = 
+    { geomSearchTracker.posForwardLayers(), geomSearchTracker.negForwardLayers() };
+  for ( unsigned side=0; side<2; ++side ) { 
+    for ( unsigned i=0; i<forwardLayers[side].size(); ++i ) { 
+      theForwardInnerRadius[side].push_back(forwardLayers[side][i]->specificSurface().innerRadius());
+      theForwardOuterRadius[side].push_back(forwardLayers[side][i]->specificSurface().outerRadius());
+      theForwardZ[side].push_back(forwardLayers[side][i]->surface().position().z());
+    }
+  }
+
+  // The misalignment, module by module against the ideal geometry
+  if ( !idealGeomSearchTracker ) return;
+  std::vector< BarrelDetLayer*> idealBarrelLayers = idealGeomSearchTracker->barrelLayers();
+  std::vector< ForwardDetLayer*> idealForwardLayers[2] = 
+    { idealGeomSearchTracker->posForwardLayers(), idealGeomSearchTracker->negForwardLayers() };
+  if ( idealBarrelLayers.size() != barrelLayers.size() || 
+       idealForwardLayers[0].size() != forwardLayers[0].size() || 
+       idealForwardLayers[1].size() != forwardLayers[1].size() ) 
+    throw cms::Exception("FastSimulation/TrackerLayerPositions") 
+      << "The ideal geometry does not have the same layers as the misaligned one";
+  std::vector<GlobalPoint> positions, idealPositions;
+  for ( unsigned i=0; i<barrelLayers.size(); ++i ) { 
+    modulePositions(*barrelLayers[i],*idealBarrelLayers[i],positions,idealPositions);
+    theBarrelMisalignment.push_back(fitBarrelMisalignment(idealPositions,positions));
+  }
+  for ( unsigned side=0; side<2; ++side ) { 
+    for ( unsigned i=0; i<forwardLayers[side].size(); ++i ) { 
+      modulePositions(*forwardLayers[side][i],*idealForwardLayers[side][i],positions,idealPositions);
+      theForwardMisalignment[side].push_back(fitForwardMisalignment(idealPositions,positions,
+								    idealForwardLayers[side][i]->surface().position().z()));
+    }
+  }
+
+}
+
+void
+TrackerLayerPositions::setMisalignment(const std::vector<TrackerLayerMisalignment>& barrel,
+				       const std::vector<TrackerLayerMisalignment>& positiveForward,
+				       const std::vector<TrackerLayerMisalignment>& negativeForward)
+{
+
+  if ( barrel.size() != nBarrelLayers() || 
+       positiveForward.size() != nForwardLayers() || negativeForward.size() != nForwardLayers() ) 
+    throw cms::Exception("FastSimulation/TrackerLayerPositions") 
+      << "The misalignment is given for " << barrel.size() << " barrel and " 
+      << positiveForward.size() << "+" << negativeForward.size() << " forward layers, instead of " 
+      << nBarrelLayers() << " and " << nForwardLayers() << "+" << nForwardLayers();
+  theBarrelMisalignment = barrel;
+  theForwardMisalignment[0] = positiveForward;
+  theForwardMisalignment[1] = negativeForward;
+
+}
+
+TrackerLayerPositions::TrackerLayerPositions(const edm::ParameterSet& layerPositions)
+{
+
+  theBarrelRadius = layerPositions.getParameter<std::vector<double> >("BarrelRadius");
+  theBarrelLength = layerPositions.getParameter<std::vector<double> >("BarrelLength");
+  theForwardInnerRadius[0] = layerPositions.getParameter<std::vector<double> >("ForwardInnerRadius");
+  theForwardOuterRadius[0] = layerPositions.getParameter<std::vector<double> >("ForwardOuterRadius");
+  theForwardZ[0] = layerPositions.getParameter<std::vector<double> >("ForwardZPosition");
+
+  // The negative side is the mirror image of the positive side
+  theForwardInnerRadius[1] = theForwardInnerRadius[0];
+  theForwardOuterRadius[1] = theForwardOuterRadius[0];
+  for ( unsigned i=0; i<theForwardZ[0].size(); ++i ) 
+    theForwardZ[1].push_back(-theForwardZ[0][i]);
+
+  if ( theBarrelRadius.size() != theBarrelLength.size() || 
+       theForwardZ[0].size() != theForwardInnerRadius[0].size() || 
+       theForwardZ[0].size() != theForwardOuterRadius[0].size() ) 
+    throw cms::Exception("FastSimulation/TrackerLayerPositions ") 
+      << " WARNING with layer positions ! You have " 
+      << theBarrelRadius.size() << " barrel radii, "
+      << theBarrelLength.size() << " barrel lengths, "
+      << theForwardZ[0].size() << " forward z positions, "
+      << theForwardInnerRadius[0].size() << " forward inner radii and "
+      << theForwardOuterRadius[0].size() << " forward outer radii!";
+
+}
+
+double
+TrackerLayerPositions::maxDifference(const TrackerLayerPositions& other, std::string& where) const
+{
+
+  if ( nBarrelLayers() != other.nBarrelLayers() || 
+       theForwardZ[0].size() != other.theForwardZ[0].size() || 
+       theForwardZ[1].size() != other.theForwardZ[1].size() ) 
+    throw cms::Exception("FastSimulation/TrackerLayerPositions ") 
+      << " The layer positions have " << nBarrelLayers() << " barrel and " 
+      << theForwardZ[0].size() << "+" << theForwardZ[1].size() << " forward layers, the other ones " << other.nBarrelLayers() << " barrel and "
+      << other.theForwardZ[0].size() << "+" << other.theForwardZ[1].size() << " forward layers!";
+
+  double result = 0.;
+  std::ostringstream worst;
+  for ( unsigned i=0; i<nBarrelLayers(); ++i ) { 
+    double diff = std::max(std::abs(theBarrelRadius[i]-other.theBarrelRadius[i]),
+			   std::abs(theBarrelLength[i]-other.theBarrelLength[i]));
+    if ( diff <= result ) continue;
+    result = diff;
+    worst.str("");
+    worst << "barrel layer " << i << " (radius " << theBarrelRadius[i] << "/" << other.theBarrelRadius[i]
+	  << ", length " << theBarrelLength[i] << "/" << other.theBarrelLength[i] << ")";
+  }
+  for ( unsigned side=0; side<2; ++side ) { 
+    for ( unsigned i=0; i<theForwardZ[side].size(); ++i ) { 
+      double diff = std::max(std::abs(theForwardZ[side][i]-other.theForwardZ[side][i]),
+			     std::max(std::abs(theForwardInnerRadius[side][i]-other.theForwardInnerRadius[side][i]),
+				      std::abs(theForwardOuterRadius[side][i]-other.theForwardOuterRadius[side][i])));
+      if ( diff <= result ) continue;
+      result = diff;
+      worst.str("");
+      worst << "forward layer " << i << " of side " << side 
+	    << " (z " << theForwardZ[side][i] << "/" << other.theForwardZ[side][i]
+	    << ", radii " << theForwardInnerRadius[side][i] << "-" << theForwardOuterRadius[side][i]
+	    << "/" << other.theForwardInnerRadius[side][i] << "-" << other.theForwardOuterRadius[side][i] << ")";
+    }
+  }
+  where = worst.str();
+  return result;
+
+}
@@ -0,0 +1,186 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerStepper.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerCrossingRecorder.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+TrackerLayerStepper::TrackerLayerStepper(const TrackerInteractionGeometry& geometry,
+					 const GlobalPoint& vertex,
+					 const GlobalVector& direction,
+					 unsigned firstLayer,
+					 TrackerCrossingRecorder* recorder) :
+  theGeometry(&geometry),
+  theSide(TrackerInteractionGeometry::side(direction.z())),
+  theFirstLayer(firstLayer),
+  thePath(0.),
+  theRecorder(recorder),
+  isIdeal(false)
+{
+  theIndex = &geometry.layerIndex(theSide);
+  theNCylinders = theIndex->nCylinders();
+  theNDisks = theIndex->nDisks();
+  theMargin = geometry.misalignmentMargin();
+  double sign = 1.-2.*theSide;
+  double norm = direction.mag();
+  if ( norm > 0. ) norm = 1./norm;
+  theX = vertex.x();
+  theY = vertex.y();
+  theZ = sign*vertex.z();
+  theDX = direction.x()*norm;
+  theDY = direction.y()*norm;
+  theDZ = sign*direction.z()*norm;
+
+  // The line only leaves the cylinders it starts in, and only reaches
+  // the disks ahead of it
+  theCylinder.found = false;
+  theDisk.found = false;
+  theCylinder.position = theIndex->cylinderPosition(std::sqrt(theX*theX+theY*theY)-theMargin);
+  theDisk.position = theDZ > 0. ? theIndex->diskPosition(theZ-theMargin) : theNDisks;
+  if ( norm <= 0. ) { 
+    theCylinder.position = theNCylinders;
+    theDisk.position = theNDisks;
+  }
+  theZLower = std::max(0.,theZ)-theMargin;
+  theRLower = minRadius(0.)-theMargin;
+}
+
+bool
+TrackerLayerStepper::next(Crossing& result) { 
+
+  if ( !theCylinder.found && theCylinder.position < theNCylinders ) nextCylinder();
+  if ( !theDisk.found && theDisk.position < theNDisks ) nextDisk();
+
+  // The closer of the two candidates
+  Candidate* candidate = 0;
+  if ( theCylinder.found ) candidate = &theCylinder;
+  if ( theDisk.found && ( !candidate || theDisk.t < candidate->t ) ) candidate = &theDisk;
+  if ( !candidate ) return false;
+  unsigned iLayer = candidate == &theCylinder ? 
+    theIndex->cylinder(candidate->position) : theIndex->disk(candidate->position);
+  candidate->found = false;
+  ++candidate->position;
+
+  const TrackerLayer& layer = theGeometry->layer(theSide,iLayer);
+  double t = candidate->t;
+  double sign = 1.-2.*theSide;
+  result.layer = iLayer;
+  result.position = GlobalPoint(theX+t*theDX,theY+t*theDY,sign*(theZ+t*theDZ));
+  result.path = t;
+  result.radLen = layer.radLen() * layer.fudgeFactorAt(candidate->dim,result.position.phi()) * candidate->angle;
+  thePath = t;
+  if ( theRecorder ) 
+    theRecorder->record(theSide,iLayer,layer,result.position,result.path,result.radLen);
+  return true;
+
+}
+
+void
+TrackerLayerStepper::nextCylinder() { 
+
+  double a = theDX*theDX+theDY*theDY;
+  while ( true ) { 
+    theCylinder.position = theIndex->firstCylinder(theCylinder.position,theZLower);
+    if ( theCylinder.position >= theNCylinders ) return;
+    unsigned iLayer = theIndex->cylinder(theCylinder.position);
+
+    // The line reaches the radius of this cylinder, hence of the next
+    // ones, beyond the |z| of its (ideal) crossing
+    double radius = theIndex->cylinderRadius(theCylinder.position);
+    double b = theX*theDX+theY*theDY;
+    double c = theX*theX+theY*theY-radius*radius;
+    if ( a > 0. && c < 0. ) 
+      theZLower = std::max(theZLower,theZ+(-b+std::sqrt(b*b-a*c))/a*theDZ-theMargin);
+
+    if ( iLayer >= theFirstLayer && 
+	 crossing(theGeometry->layer(theSide,iLayer),theCylinder.t,theCylinder.dim,theCylinder.angle) ) { 
+      theCylinder.found = true;
+      return;
+    }
+    ++theCylinder.position;
+  }
+
+}
+
+void
+TrackerLayerStepper::nextDisk() { 
+
+  while ( true ) { 
+    theDisk.position = theIndex->firstDisk(theDisk.position,theRLower);
+    if ( theDisk.position >= theNDisks ) return;
+    unsigned iLayer = theIndex->disk(theDisk.position);
+
+    // The line reaches the |z| of this disk, hence of the next ones, 
+    // beyond the radius it has there
+    theRLower = std::max(theRLower,minRadius((theIndex->diskZ(theDisk.position)-theZ)/theDZ)-theMargin);
+
+    if ( iLayer >= theFirstLayer && 
+	 crossing(theGeometry->layer(theSide,iLayer),theDisk.t,theDisk.dim,theDisk.angle) ) { 
+      theDisk.found = true;
+      return;
+    }
+    ++theDisk.position;
+  }
+
+}
+
+double
+TrackerLayerStepper::minRadius(double t) const { 
+  double x = theX+t*theDX;
+  double y = theY+t*theDY;
+  // Still moving towards the beam line : the distance of closest approach
+  double a = theDX*theDX+theDY*theDY;
+  if ( a > 0. && x*theDX+y*theDY < 0. ) return std::abs(theX*theDY-theY*theDX)/std::sqrt(a);
+  return std::sqrt(x*x+y*y);
+}
+
+bool
+TrackerLayerStepper::crossing(const TrackerLayer& layer, 
+			      double& t, double& dim, double& angle) const { 
+
+  const TrackerLayerMisalignment* misalignment = layer.misalignment();
+  if ( !misalignment || isIdeal ) 
+    return crossing(layer,theX,theY,theZ,theDX,theDY,theDZ,t,dim,angle);
+
+  // The line in the frame of the ideal layer : the path length along 
+  // the line is the same, to first order
+  double x = theX, y = theY, z = theZ;
+  double dx = theDX, dy = theDY, dz = theDZ;
+  misalignment->toLayer(x,y,z,dx,dy,dz);
+  return crossing(layer,x,y,z,dx,dy,dz,t,dim,angle);
+
+}
+
+bool
+TrackerLayerStepper::crossing(const TrackerLayer& layer, 
+			      double x, double y, double z, 
+			      double dx, double dy, double dz,
+			      double& t, double& dim, double& angle) { 
+
+  if ( layer.forward() ) { 
+    if ( dz <= 0. ) return false;
+    t = (std::abs(layer.diskZPosition())-z)/dz;
+    if ( t <= 0. ) return false;
+    double xt = x+t*dx;
+    double yt = y+t*dy;
+    dim = std::sqrt(xt*xt+yt*yt);
+    angle = 1./dz;
+    return dim >= layer.diskInnerRadius() && dim <= layer.diskOuterRadius();
+  }
+
+  // The outgoing crossing of a cylinder the line starts inside of
+  double a = dx*dx+dy*dy;
+  if ( a <= 0. ) return false;
+  double b = x*dx+y*dy;
+  double radius = layer.cylinderRadius();
+  double c = x*x+y*y-radius*radius;
+  if ( c >= 0. ) return false;
+  t = (-b+std::sqrt(b*b-a*c))/a;
+  dim = std::abs(z+t*dz);
+  // cos(incidence) = (radial unit vector).(direction)
+  double cosIncidence = ((x+t*dx)*dx+(y+t*dy)*dy)/radius;
+  if ( cosIncidence <= 0. ) return false;
+  angle = layer.cylinderAngle(cosIncidence,dz,z+t*dz);
+  return dim <= layer.cylinderHalfLength();
+
+}
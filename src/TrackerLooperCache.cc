@@ -0,0 +1,106 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerLooperCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  struct SmallerAngle {
+    template <class T>
+    bool operator()(const T& a, const T& b) const { return a.angle < b.angle; }
+  };
+}
+
+TrackerLooperCache::TrackerLooperCache(const TrackerInteractionGeometry& geometry,
+				       double xc, double yc, double radius,
+				       double phi0, int q,
+				       double z0, double dzdphi) :
+  theGeometry(&geometry),
+  theSide(TrackerInteractionGeometry::side(z0)),
+  theXC(xc),
+  theYC(yc),
+  theRadius(radius),
+  thePhi0(phi0),
+  theQ(q < 0 ? -1 : 1),
+  theZ0(z0),
+  theDZDPhi(dzdphi),
+  thePathPerAngle(std::sqrt(radius*radius+dzdphi*dzdphi))
+{
+
+  // The transverse circle spans [rMin,rMax] in radius
+  double d = std::sqrt(xc*xc+yc*yc);
+  double rMin = std::abs(d-radius);
+  double rMax = d+radius;
+  double phiC = std::atan2(yc,xc);
+
+  // z, folded to the side of the start, moves by dzf per unit angle
+  double sign = 1.-2.*theSide;
+  double zf = sign*z0;
+  double dzf = sign*dzdphi;
+  theMaxAngle = 1E30;
+  if ( dzf < 0. ) theMaxAngle = zf/-dzf;
+
+  for ( int iLayer=0; iLayer<geometry.nCylinders(theSide); ++iLayer ) {
+    const TrackerLayer& layer = geometry.layer(theSide,iLayer);
+
+    if ( layer.forward() ) {
+      // A disk met by the circle ends the periodic sequence
+      if ( layer.diskOuterRadius() < rMin || layer.diskInnerRadius() > rMax ) continue;
+      double zDisk = std::abs(layer.diskZPosition());
+      if ( dzf > 0. && zDisk > zf ) theMaxAngle = std::min(theMaxAngle,(zDisk-zf)/dzf);
+      if ( dzf < 0. && zDisk < zf ) theMaxAngle = std::min(theMaxAngle,(zf-zDisk)/-dzf);
+      continue;
+    }
+
+    // A cylinder : |c + R u(theta)| = r  <=>  cos(theta-phiC) = k/d
+    double r = layer.cylinderRadius();
+    if ( r <= rMin || r >= rMax || d <= 0. ) continue;
+    double k = (r*r-d*d-radius*radius)/(2.*radius);
+    double delta = std::acos(std::max(-1.,std::min(1.,k/d)));
+    for ( int s=-1; s<=1; s+=2 ) {
+      double theta = phiC + s*delta;
+      double angle = std::fmod(theQ*(theta-phi0),2.*M_PI);
+      if ( angle < 0. ) angle += 2.*M_PI;
+      // Incidence : (radial unit vector).(unit tangent)
+      double x = xc + radius*std::cos(theta);
+      double y = yc + radius*std::sin(theta);
+      double tx = -theQ*radius*std::sin(theta);
+      double ty = theQ*radius*std::cos(theta);
+      double cosIncidence = std::abs(x*tx+y*ty)/(r*thePathPerAngle);
+      if ( cosIncidence <= 0. ) continue;
+      Crossing crossing;
+      crossing.layer = iLayer;
+      crossing.angle = angle;
+      crossing.radLen = layer.radLen()/cosIncidence;
+      theCrossings.push_back(crossing);
+    }
+  }
+  std::sort(theCrossings.begin(),theCrossings.end(),SmallerAngle());
+
+}
+
+unsigned
+TrackerLooperCache::nTurns() const {
+  return static_cast<unsigned>(std::min(theMaxAngle/(2.*M_PI),1E6));
+}
+
+void
+TrackerLooperCache::turn(unsigned k, std::vector<TrackerLayerStepper::Crossing>& result) const {
+
+  result.clear();
+  for ( unsigned i=0; i<theCrossings.size(); ++i ) {
+    double angle = theCrossings[i].angle + 2.*M_PI*k;
+    if ( angle > theMaxAngle ) break;
+    double z = theZ0 + angle*theDZDPhi;
+    const TrackerLayer& layer = theGeometry->layer(theSide,theCrossings[i].layer);
+    if ( std::abs(z) > layer.cylinderHalfLength() ) continue;
+    double phi = thePhi0 + theQ*angle;
+    TrackerLayerStepper::Crossing crossing;
+    crossing.layer = theCrossings[i].layer;
+    crossing.position = GlobalPoint(theXC+theRadius*std::cos(phi),
+				    theYC+theRadius*std::sin(phi),z);
+    crossing.path = angle*thePathPerAngle;
+    crossing.radLen = theCrossings[i].radLen * layer.fudgeFactorAt(std::abs(z),crossing.position.phi());
+    result.push_back(crossing);
+  }
+
+}
@@ -0,0 +1,34 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerMaterialPalette.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayer.h"
+
+unsigned short
+TrackerMaterialPalette::add(const TrackerLayer& layer) { 
+
+  if ( theFudgeOffsets.empty() ) theFudgeOffsets.push_back(0);
+
+  // An identical material (same values, in single precision, and same map)
+  float radLen = layer.radLen();
+  const TrackerLayerMaterialMap* map = layer.materialMap();
+  unsigned nFudges = layer.fudgeNumber();
+  for ( unsigned i=0; i<size(); ++i ) { 
+    if ( theRadLen[i] != radLen || theMaterialMap[i] != map || fudgeNumber(i) != nFudges ) continue;
+    unsigned iFudge = 0;
+    for ( unsigned first=theFudgeOffsets[i]; iFudge<nFudges; ++iFudge ) 
+      if ( theFudgeMin[first+iFudge] != static_cast<float>(layer.fudgeMin(iFudge)) ||
+	   theFudgeMax[first+iFudge] != static_cast<float>(layer.fudgeMax(iFudge)) ||
+	   theFudgeFactor[first+iFudge] != static_cast<float>(layer.fudgeFactor(iFudge)) ) break;
+    if ( iFudge == nFudges ) return i;
+  }
+
+  // A new material
+  theRadLen.push_back(radLen);
+  theMaterialMap.push_back(map);
+  for ( unsigned iFudge=0; iFudge<nFudges; ++iFudge ) { 
+    theFudgeMin.push_back(layer.fudgeMin(iFudge));
+    theFudgeMax.push_back(layer.fudgeMax(iFudge));
+    theFudgeFactor.push_back(layer.fudgeFactor(iFudge));
+  }
+  theFudgeOffsets.push_back(theFudgeMin.size());
+  return size()-1;
+
+}
@@ -0,0 +1,137 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerMaterialSamplingTables.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerWorkerPool.h"
+
+#include <boost/bind.hpp>
+
+namespace {
+  // Electron mass, and silicon : X0 (g/cm2), Z/A, mean excitation energy (GeV)
+  const double electronMass = 0.000510999;
+  const double siliconX0 = 21.82;
+  const double siliconZoverA = 0.49848;
+  const double siliconI = 173E-9;
+}
+
+double
+TrackerMaterialSamplingTables::LandauEnergyLoss::operator()(double lambda,
+							   double thickness,
+							   double energy) const {
+  return std::exp(-0.5*(lambda+std::exp(-lambda)));
+}
+
+double
+TrackerMaterialSamplingTables::LandauEnergyLoss::xi(double thickness, double energy) const {
+  double gamma = std::max(energy/theMass,1.0001);
+  double beta2 = 1.-1./(gamma*gamma);
+  return 0.5 * 0.307075E-3 * siliconZoverA * thickness*siliconX0 / beta2;
+}
+
+double
+TrackerMaterialSamplingTables::LandauEnergyLoss::mostProbableLoss(double thickness, double energy) const {
+  double gamma = std::max(energy/theMass,1.0001);
+  double beta2 = 1.-1./(gamma*gamma);
+  double bg2 = beta2*gamma*gamma;
+  double width = xi(thickness,energy);
+  return width * ( std::log(2.*electronMass*bg2/siliconI) + std::log(width/siliconI)
+		   + 0.2 - beta2 );
+}
+
+double
+TrackerMaterialSamplingTables::LandauEnergyLoss::energyLoss(double lambda,
+							     double thickness,
+							     double energy) const {
+  return mostProbableLoss(thickness,energy) + lambda*xi(thickness,energy);
+}
+
+void
+TrackerMaterialSamplingTables::LandauEnergyLoss::range(double thickness, double energy,
+						       double& xMin, double& xMax) const {
+
+  double gamma = std::max(energy/theMass,1.0001);
+  double beta2 = 1.-1./(gamma*gamma);
+  double bg2 = beta2*gamma*gamma;
+  double ratio = electronMass/theMass;
+
+  // The largest transfer to an electron, in units of xi from the most
+  // probable loss
+  double tMax = 2.*electronMass*bg2 / (1.+2.*gamma*ratio+ratio*ratio);
+
+  xMin = -3.5;
+  xMax = std::min(std::max((tMax-mostProbableLoss(thickness,energy))/xi(thickness,energy),
+			   xMin+1.),50.);
+
+}
+
+double
+TrackerMaterialSamplingTables::ConversionSharing::operator()(double x,
+							    double thickness,
+							    double energy) const {
+  return 1.-4./3.*x*(1.-x);
+}
+
+void
+TrackerMaterialSamplingTables::ConversionSharing::range(double thickness, double energy,
+							double& xMin, double& xMax) const {
+  xMin = std::min(electronMass/energy,0.49);
+  xMax = 1.-xMin;
+}
+
+TrackerMaterialSamplingTables::TrackerMaterialSamplingTables(const std::vector<float>& thicknesses,
+							     unsigned nAngle, double maxAngle,
+							     unsigned nEnergy, double energyMin, double energyMax,
+							     unsigned nBins,
+							     const Density& density,
+							     unsigned nThreads) :
+  theThicknesses(thicknesses),
+  theNAngle(nAngle),
+  theAngleStep((maxAngle-1.)/nAngle),
+  theInvAngleStep(nAngle/(maxAngle-1.)),
+  theNEnergy(nEnergy),
+  theEnergyMin(energyMin),
+  theLogEnergyStep(std::log(energyMax/energyMin)/nEnergy),
+  theInvLogEnergyStep(nEnergy/std::log(energyMax/energyMin)),
+  theNBins(nBins),
+  theTables(thicknesses.size()*nAngle*nEnergy),
+  theNextTable(0)
+{
+
+  TrackerWorkerPool pool(nThreads);
+  pool.run(boost::bind(&TrackerMaterialSamplingTables::work,this,&density));
+
+}
+
+unsigned
+TrackerMaterialSamplingTables::size() const {
+  unsigned bytes = theTables.size()*sizeof(TrackerAliasTable);
+  for ( unsigned i=0; i<theTables.size(); ++i )
+    bytes += theTables[i].size()*(sizeof(float)+sizeof(unsigned short));
+  return bytes;
+}
+
+void
+TrackerMaterialSamplingTables::work(const Density* density) {
+
+  std::vector<double> weights(theNBins);
+  while ( true ) {
+    unsigned iTable;
+    {
+      boost::mutex::scoped_lock lock(theMutex);
+      if ( theNextTable == theTables.size() ) break;
+      iTable = theNextTable++;
+    }
+
+    // The thickness and energy at the center of the bin
+    unsigned iEnergy = iTable % theNEnergy;
+    unsigned iAngle = (iTable/theNEnergy) % theNAngle;
+    unsigned material = iTable/(theNEnergy*theNAngle);
+    double thickness = theThicknesses[material] * (1.+(iAngle+0.5)*theAngleStep);
+    double energy = theEnergyMin * std::exp((iEnergy+0.5)*theLogEnergyStep);
+
+    double xMin, xMax;
+    density->range(thickness,energy,xMin,xMax);
+    double step = (xMax-xMin)/theNBins;
+    for ( unsigned i=0; i<theNBins; ++i )
+      weights[i] = (*density)(xMin+(i+0.5)*step,thickness,energy);
+    theTables[iTable].build(weights,xMin,xMax);
+  }
+
+}
@@ -0,0 +1,97 @@
+#include "FastSimulation/TrackerSetup/interface/TrackerMaterialVoxelGrid.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayer.h"
+
+#include <algorithm>
+#include <cmath>
+
+TrackerMaterialVoxelGrid::TrackerMaterialVoxelGrid(const std::vector<const TrackerLayer*>& layers,
+						   unsigned nR, double rMax,
+						   unsigned nZ, double zMax) :
+  theNR(nR),
+  theNZ(nZ),
+  theRMax(rMax),
+  theZMax(zMax),
+  theRStep(rMax/nR),
+  theZStep(2.*zMax/nZ),
+  theDensity(nR*nZ,0.f)
+{
+
+  for ( unsigned iLayer=0; iLayer<layers.size(); ++iLayer ) {
+    const TrackerLayer& layer = *layers[iLayer];
+
+    if ( layer.forward() ) {
+      // A disk : x/X0 spread over the thickness of its z cell, and over
+      // the r cells it overlaps
+      double z = std::abs(layer.diskZPosition());
+      if ( z >= theZMax ) continue;
+      unsigned iZ = static_cast<unsigned>((z+theZMax)/theZStep);
+      double density = layer.radLen()/theZStep;
+      double rIn = layer.diskInnerRadius();
+      double rOut = std::min(layer.diskOuterRadius(),theRMax);
+      unsigned first = static_cast<unsigned>(rIn/theRStep);
+      for ( unsigned iR=first; iR<theNR && iR*theRStep<rOut; ++iR ) {
+	double low = std::max(rIn,iR*theRStep);
+	double high = std::min(rOut,(iR+1)*theRStep);
+	if ( high <= low ) continue;
+	theDensity[iR*theNZ+iZ] +=
+	  density * layer.fudgeFactorAt((low+high)/2.) * (high-low)/theRStep;
+      }
+      continue;
+    }
+
+    // A cylinder : x/X0 spread over the thickness of its r cell, and over
+    // the z cells it overlaps
+    double r = layer.cylinderRadius();
+    if ( r >= theRMax ) continue;
+    unsigned iR = static_cast<unsigned>(r/theRStep);
+    double density = layer.radLen()/theRStep;
+    double halfLength = std::min(layer.cylinderHalfLength(),theZMax);
+    for ( unsigned iZ=0; iZ<theNZ; ++iZ ) {
+      double low = std::max(-halfLength,-theZMax+iZ*theZStep);
+      double high = std::min(halfLength,-theZMax+(iZ+1)*theZStep);
+      if ( high <= low ) continue;
+      // The fudge factors depend on |z|
+      double dim = low >= 0. || high <= 0. ? std::abs((low+high)/2.) : 0.;
+      theDensity[iR*theNZ+iZ] +=
+	density * layer.fudgeFactorAt(dim) * (high-low)/theZStep;
+    }
+  }
+
+}
+
+double
+TrackerMaterialVoxelGrid::materialBudget(double z0, double sinTheta, double cosTheta,
+					 unsigned* nCells) const {
+
+  if ( nCells ) *nCells = 0;
+  if ( std::abs(z0) >= theZMax ) return 0.;
+
+  // Walk the cells from (r=0,z0), always to the nearest cell boundary
+  const double infinity = 1E30;
+  unsigned iR = 0;
+  unsigned iZ = static_cast<unsigned>((z0+theZMax)/theZStep);
+  double tDeltaR = sinTheta > 0. ? theRStep/sinTheta : infinity;
+  double tDeltaZ = cosTheta > 0. ? theZStep/cosTheta : infinity;
+  double tMaxR = tDeltaR;
+  double tMaxZ = cosTheta > 0. ? (-theZMax+(iZ+1)*theZStep-z0)/cosTheta : infinity;
+  double t = 0.;
+  double radLen = 0.;
+  unsigned n = 0;
+  while ( true ) {
+    double tNext = std::min(tMaxR,tMaxZ);
+    if ( tNext >= infinity ) break;
+    radLen += theDensity[iR*theNZ+iZ] * (tNext-t);
+    t = tNext;
+    ++n;
+    if ( tMaxR < tMaxZ ) {
+      if ( ++iR == theNR ) break;
+      tMaxR += tDeltaR;
+    } else {
+      if ( ++iZ == theNZ ) break;
+      tMaxZ += tDeltaZ;
+    }
+  }
+  if ( nCells ) *nCells = n;
+  return radLen;
+
+}
@@ -0,0 +1,136 @@
+/** The alias tables of the material effects :
+ *  - samples of the table of the energy loss density of a pion in a
+ *    silicon module must follow the density (chi2 of the bin contents,
+ *    and uniform positions inside the bins), and convert into energy
+ *    losses around the expected most probable loss.
+ *  - a density that cannot be tabulated must give an exception in the
+ *    calling thread when the tables are built in several threads.
+ */
+
+#include "FastSimulation/TrackerSetup/interface/TrackerMaterialSamplingTables.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerAliasTable.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+  double flat(unsigned& seed) {
+    seed = 1664525*seed + 1013904223;
+    return (seed>>8) / 16777216.;
+  }
+
+  /// A density with an empty range
+  class EmptyDensity : public TrackerMaterialSamplingTables::Density {
+  public:
+    virtual double operator()(double x, double thickness, double energy) const { return 1.; }
+    virtual void range(double thickness, double energy, double& xMin, double& xMax) const {
+      xMin = 1.;
+      xMax = 0.;
+    }
+  };
+
+}
+
+int main() {
+
+  bool ok = true;
+
+  // A 300 micron silicon module (x/X0 = 0.0032) crossed by a 1 GeV pion
+  const double thickness = 0.0032;
+  const double energy = 1.;
+  const unsigned nBins = 64;
+  const unsigned nSamples = 1000000;
+  TrackerMaterialSamplingTables::LandauEnergyLoss density(0.13957);
+  double xMin, xMax;
+  density.range(thickness,energy,xMin,xMax);
+  double step = (xMax-xMin)/nBins;
+  std::vector<double> weights(nBins);
+  double sum = 0.;
+  for ( unsigned i=0; i<nBins; ++i ) {
+    weights[i] = density(xMin+(i+0.5)*step,thickness,energy);
+    sum += weights[i];
+  }
+  TrackerAliasTable table;
+  table.build(weights,xMin,xMax);
+
+  std::vector<unsigned> counts(nBins,0);
+  unsigned outside = 0;
+  unsigned lowerHalf = 0;
+  double meanLoss = 0.;
+  unsigned seed = 12345;
+  for ( unsigned n=0; n<nSamples; ++n ) {
+    double u = flat(seed);
+    double lambda = table.sample(u,flat(seed));
+    int bin = static_cast<int>(std::floor((lambda-xMin)/step));
+    if ( bin < 0 || bin >= static_cast<int>(nBins) ) {
+      ++outside;
+      continue;
+    }
+    ++counts[bin];
+    if ( lambda-xMin-bin*step < 0.5*step ) ++lowerHalf;
+    meanLoss += density.energyLoss(lambda,thickness,energy);
+  }
+  meanLoss /= nSamples;
+
+  // The bins expecting less than 5 samples are counted together
+  double chi2 = 0.;
+  unsigned nTerms = 0;
+  double tailCount = 0.;
+  double tailExpected = 0.;
+  for ( unsigned i=0; i<nBins; ++i ) {
+    double expected = nSamples*weights[i]/sum;
+    if ( expected < 5. ) {
+      tailCount += counts[i];
+      tailExpected += expected;
+      continue;
+    }
+    chi2 += (counts[i]-expected)*(counts[i]-expected)/expected;
+    ++nTerms;
+  }
+  if ( tailExpected > 0. ) {
+    chi2 += (tailCount-tailExpected)*(tailCount-tailExpected)/tailExpected;
+    ++nTerms;
+  }
+  // 5 standard deviations above the number of degrees of freedom
+  double ndf = nTerms-1.;
+  bool chi2Ok = chi2 < ndf+5.*std::sqrt(2.*ndf);
+  std::printf("%u samples in %u bins : chi2 %.1f for %.0f degrees of freedom, %u outside : %s\n",
+	      nSamples,nBins,chi2,ndf,outside,chi2Ok && !outside ? "ok" : "FAILED");
+  ok = chi2Ok && !outside && ok;
+
+  double fraction = double(lowerHalf)/nSamples;
+  bool uniformOk = std::abs(fraction-0.5) < 5.*0.5/std::sqrt(double(nSamples));
+  std::printf("Fraction in the lower half of the bins : %.4f : %s\n",
+	      fraction,uniformOk ? "ok" : "FAILED");
+  ok = uniformOk && ok;
+
+  // lambda = 0 is the most probable loss, and lambda counts in units
+  // of xi ; the most probable loss of a pion at beta*gamma = 7 is about
+  // 80 keV in 300 microns of silicon, and the mean loss is above it
+  double xi = density.xi(thickness,energy);
+  double mostProbable = density.mostProbableLoss(thickness,energy);
+  bool lossOk = std::abs(density.energyLoss(0.,thickness,energy)-mostProbable) < 1E-12 &&
+    std::abs(density.energyLoss(1.,thickness,energy)-mostProbable-xi) < 1E-12 &&
+    mostProbable > 60E-6 && mostProbable < 100E-6 && meanLoss > mostProbable;
+  std::printf("xi %.2f keV, most probable loss %.1f keV, mean sampled loss %.1f keV : %s\n",
+	      1E6*xi,1E6*mostProbable,1E6*meanLoss,lossOk ? "ok" : "FAILED");
+  ok = lossOk && ok;
+
+  // The error of a worker thread must reach the caller
+  EmptyDensity empty;
+  bool thrown = false;
+  try {
+    TrackerMaterialSamplingTables tables(std::vector<float>(3,0.01f),
+					 4,10.,8,0.1,1000.,nBins,empty,4);
+  } catch ( cms::Exception& e ) {
+    thrown = true;
+  }
+  std::printf("Empty density in 4 threads : %s\n",thrown ? "exception, ok" : "no exception, FAILED");
+  ok = thrown && ok;
+
+  return ok ? 0 : 1;
+
+}
@@ -0,0 +1,113 @@
+/** The expected hit patterns of helices in the hardcoded interaction
+ *  geometry :
+ *  - a stiff central helix must cross the 13 barrel layers (PXB1-3 =
+ *    1-3, TIB1-4 = 6-9, TOB1-6 = 13-18), and the beam pipe ;
+ *  - a looper reaching a radius of 10 cm must cross PXB1 and PXB2 only ;
+ *  - stiff helices (R = 10 m, |eta| < 2) from the luminous region must
+ *    cross the layers of the straight-line walk of the layer stepper,
+ *    but for lines grazing a layer edge (at most 1 in 100).
+ */
+
+#include "FastSimulation/TrackerSetup/interface/TrackerHitPatternQuery.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerInteractionGeometry.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerPositions.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerStepper.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ProcessDesc.h"
+#include "FWCore/PythonParameterSet/interface/PythonProcessDesc.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+  double flat(unsigned& seed) {
+    seed = 1664525*seed + 1013904223;
+    return (seed>>8) / 16777216.;
+  }
+
+  /// The helix of radius R (positive charge) from (0,0,z0), along eta
+  /// and phi at the start
+  TrackerHitPatternQuery::Helix helix(double R, double z0, double eta, double phi) {
+    TrackerHitPatternQuery::Helix h;
+    h.radius = R;
+    h.q = 1;
+    h.phi0 = phi-0.5*M_PI;
+    h.xc = -R*std::cos(h.phi0);
+    h.yc = -R*std::sin(h.phi0);
+    h.z0 = z0;
+    h.dzdphi = R*std::sinh(eta);
+    return h;
+  }
+
+  bool check(const char* what, const TrackerHitPatternQuery::HitPattern& pattern,
+	     unsigned long long expected) {
+    bool ok = pattern.sensitive == expected;
+    std::printf("%-28s sensitive %016llx, expected %016llx, dead %016llx : %s\n",what,
+		pattern.sensitive,expected,pattern.dead,ok ? "ok" : "FAILED");
+    return ok;
+  }
+
+}
+
+int main() {
+
+  std::string config =
+    "import FWCore.ParameterSet.Config as cms\n"
+    "process = cms.Process('TrackerHitPatternQueryTest')\n"
+    "process.load('FastSimulation.TrackerSetup.TrackerInteractionGeometryESProducer_cfi')\n";
+  PythonProcessDesc builder(config);
+  boost::shared_ptr<edm::ParameterSet> process = builder.processDesc()->getProcessPSet();
+  edm::ParameterSet producer = process->getParameter<edm::ParameterSet>("TrackerInteractionGeometryESProducer");
+  edm::ParameterSet trackerMaterial = producer.getParameter<edm::ParameterSet>("TrackerMaterial");
+  TrackerLayerPositions thePositions(producer.getParameter<edm::ParameterSet>("LayerPositions"));
+  TrackerInteractionGeometry geometry(trackerMaterial,&thePositions);
+  TrackerHitPatternQuery query(geometry);
+
+  bool ok = true;
+
+  // The barrel layers, and the first two pixel layers
+  unsigned long long barrel = 0;
+  for ( unsigned n=1; n<=3; ++n ) barrel |= 1ULL << n;
+  for ( unsigned n=6; n<=9; ++n ) barrel |= 1ULL << n;
+  for ( unsigned n=13; n<=18; ++n ) barrel |= 1ULL << n;
+  unsigned long long pixels = (1ULL << 1) | (1ULL << 2);
+
+  TrackerHitPatternQuery::HitPattern central = query.hitPattern(helix(1000.,0.,0.01,0.3));
+  ok = check("stiff central helix",central,barrel) && central.dead && ok;
+  TrackerHitPatternQuery::HitPattern backward = query.hitPattern(helix(1000.,0.,-0.01,2.1));
+  ok = check("same, backward",backward,barrel) && ok;
+  ok = check("looper up to 10 cm",query.hitPattern(helix(5.,0.,0.02,-1.2)),pixels) && ok;
+
+  // Stiff helices against the straight-line walk
+  const unsigned nLines = 100000;
+  unsigned seed = 12345;
+  unsigned mismatch = 0;
+  TrackerLayerStepper::Crossing crossing;
+  for ( unsigned i=0; i<nLines; ++i ) {
+    double z0 = 10.*(flat(seed)-0.5);
+    double eta = 4.*(flat(seed)-0.5);
+    double phi = M_PI*(2.*flat(seed)-1.);
+    double theta = 2.*std::atan(std::exp(-eta));
+    GlobalVector direction(std::sin(theta)*std::cos(phi),std::sin(theta)*std::sin(phi),std::cos(theta));
+    TrackerLayerStepper stepper(geometry,GlobalPoint(0.,0.,z0),direction);
+    TrackerHitPatternQuery::HitPattern walked = { 0, 0 };
+    while ( stepper.next(crossing) ) {
+      unsigned number = geometry.layer(stepper.side(),crossing.layer).layerNumber();
+      if ( number < 100 ) walked.sensitive |= 1ULL << number;
+      else walked.dead |= 1ULL << (number-100);
+    }
+    TrackerHitPatternQuery::HitPattern pattern = query.hitPattern(helix(1000.,z0,eta,phi));
+    if ( pattern.sensitive != walked.sensitive || pattern.dead != walked.dead ) ++mismatch;
+  }
+  bool walkOk = mismatch*100 <= nLines;
+  std::printf("%u stiff helices, %u with layers different from the straight-line walk : %s\n",
+	      nLines,mismatch,walkOk ? "ok" : "FAILED");
+  ok = walkOk && ok;
+
+  return ok ? 0 : 1;
+
+}
@@ -0,0 +1,163 @@
+/** Lookup cost against the number of layers : the layer index
+ *  (nextCylinder, nextDisk, materialBudget) against a linear scan of the
+ *  layer list, on synthetic flexible geometries of non-nested layers.
+ *  The index should grow as log N, the scan as N.
+ */
+
+#include "FastSimulation/TrackerSetup/interface/TrackerInteractionGeometry.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerIndex.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <sys/time.h>
+
+namespace {
+
+  double now() {
+    timeval tv;
+    gettimeofday(&tv,0);
+    return tv.tv_sec + 1E-6*tv.tv_usec;
+  }
+
+  double flat(unsigned& seed) {
+    seed = 1664525*seed + 1013904223;
+    return (seed>>8) / 16777216.;
+  }
+
+  /// A flexible geometry of nLayers overlapping cylinders and disks
+  edm::ParameterSet configuration(unsigned nLayers, unsigned seed) {
+    std::vector<double> barrelRadius, barrelLength, barrelThickness;
+    std::vector<double> diskZ, diskInner, diskOuter, diskThickness;
+    unsigned nCylinders = nLayers/2;
+    unsigned nDisks = nLayers-nCylinders;
+    for ( unsigned i=0; i<nCylinders; ++i ) {
+      barrelRadius.push_back(3.+110.*(i+1)/nCylinders);
+      barrelLength.push_back(40.+500.*flat(seed));
+      barrelThickness.push_back(0.001+0.01*flat(seed));
+    }
+    for ( unsigned j=0; j<nDisks; ++j ) {
+      diskZ.push_back(30.+250.*(j+1)/nDisks);
+      diskInner.push_back(5.+45.*flat(seed));
+      diskOuter.push_back(diskInner.back()+10.+50.*flat(seed));
+      diskThickness.push_back(0.001+0.01*flat(seed));
+    }
+    edm::ParameterSet pset;
+    pset.addParameter<bool>("use_hardcoded_geometry",false);
+    pset.addParameter<std::vector<double> >("barrel_radius",barrelRadius);
+    pset.addParameter<std::vector<double> >("barrel_length",barrelLength);
+    pset.addParameter<std::vector<double> >("barrel_thickness",barrelThickness);
+    pset.addParameter<std::vector<double> >("disk_z",diskZ);
+    pset.addParameter<std::vector<double> >("disk_inner_radius",diskInner);
+    pset.addParameter<std::vector<double> >("disk_outer_radius",diskOuter);
+    pset.addParameter<std::vector<double> >("disk_thickness",diskThickness);
+    pset.addUntrackedParameter<bool>("check_nesting",false);
+    pset.addParameter<bool>("merge_dead_layers",false);
+    pset.addParameter<double>("merge_tolerance",0.01);
+    pset.addParameter<double>("region_max_radius",-1.);
+    pset.addParameter<double>("region_max_z",-1.);
+    pset.addParameter<std::string>("material_backend","Surfaces");
+    pset.addParameter<unsigned>("voxel_r_bins",480);
+    pset.addParameter<unsigned>("voxel_z_bins",1200);
+    pset.addParameter<std::vector<unsigned> >("material_map_layer",std::vector<unsigned>());
+    pset.addParameter<std::string>("material_map_file","");
+    pset.addParameter<bool>("fudge_to_material_maps",false);
+    pset.addParameter<unsigned>("fudge_map_u_bins",64);
+    return pset;
+  }
+
+  /// The linear scans the index replaces
+  int scanCylinder(const std::vector<const TrackerLayer*>& layers, double r, double z) {
+    int best = -1;
+    for ( unsigned i=0; i<layers.size(); ++i ) {
+      const TrackerLayer& layer = *layers[i];
+      if ( layer.forward() || layer.cylinderRadius() <= r || layer.cylinderHalfLength() < z ) continue;
+      if ( best < 0 || layer.cylinderRadius() < layers[best]->cylinderRadius() ) best = i;
+    }
+    return best;
+  }
+
+  int scanDisk(const std::vector<const TrackerLayer*>& layers, double r, double z) {
+    int best = -1;
+    for ( unsigned i=0; i<layers.size(); ++i ) {
+      const TrackerLayer& layer = *layers[i];
+      if ( !layer.forward() || std::abs(layer.diskZPosition()) <= z ) continue;
+      if ( r < layer.diskInnerRadius() || r > layer.diskOuterRadius() ) continue;
+      if ( best < 0 || std::abs(layer.diskZPosition()) < std::abs(layers[best]->diskZPosition()) ) best = i;
+    }
+    return best;
+  }
+
+}
+
+int main() {
+
+  const unsigned nQueries = 100000;
+  std::printf("%8s %12s %12s %12s %12s %12s %12s %10s\n",
+	      "layers","scan(ns)","next(ns)","ratio","list(ns)","budget(ns)","ratio","mismatch");
+
+  for ( unsigned nLayers=16; nLayers<=1024; nLayers*=2 ) {
+
+    TrackerInteractionGeometry geometry(configuration(nLayers,nLayers),
+					static_cast<const TrackerLayerPositions*>(0));
+    const TrackerLayerIndex& index = geometry.layerIndex(TrackerInteractionGeometry::PositiveZ);
+    std::vector<const TrackerLayer*> layers;
+    for ( unsigned i=0; i<static_cast<unsigned>(geometry.nCylinders(TrackerInteractionGeometry::PositiveZ)); ++i )
+      layers.push_back(&geometry.layer(TrackerInteractionGeometry::PositiveZ,i));
+
+    std::vector<double> r(nQueries), z(nQueries), eta(nQueries), z0(nQueries);
+    unsigned seed = 12345;
+    for ( unsigned i=0; i<nQueries; ++i ) {
+      r[i] = 120.*flat(seed);
+      z[i] = 300.*flat(seed);
+      eta[i] = 3.*flat(seed);
+      z0[i] = 10.*(flat(seed)-0.5);
+    }
+
+    // Next cylinder and disk : index against scan
+    std::vector<int> scanned(2*nQueries), found(2*nQueries);
+    double start = now();
+    for ( unsigned i=0; i<nQueries; ++i ) {
+      scanned[2*i] = scanCylinder(layers,r[i],z[i]);
+      scanned[2*i+1] = scanDisk(layers,r[i],z[i]);
+    }
+    double scanTime = now()-start;
+    start = now();
+    for ( unsigned i=0; i<nQueries; ++i ) {
+      found[2*i] = index.nextCylinder(r[i],z[i]);
+      found[2*i+1] = index.nextDisk(r[i],z[i]);
+    }
+    double nextTime = now()-start;
+    unsigned mismatch = 0;
+    for ( unsigned i=0; i<2*nQueries; ++i )
+      if ( scanned[i] != found[i] ) ++mismatch;
+
+    // Material budget : index against the sum over the list
+    std::vector<double> listBudget(nQueries,0.), indexBudget(nQueries);
+    start = now();
+    for ( unsigned i=0; i<nQueries; ++i ) {
+      double theta = 2.*std::atan(std::exp(-eta[i]));
+      double sinTheta = std::sin(theta);
+      double cosTheta = std::cos(theta);
+      for ( unsigned j=0; j<layers.size(); ++j )
+	listBudget[i] += layers[j]->straightRadLen(z0[i],sinTheta,cosTheta);
+    }
+    double listTime = now()-start;
+    start = now();
+    for ( unsigned i=0; i<nQueries; ++i )
+      indexBudget[i] = geometry.materialBudget(eta[i],z0[i]);
+    double budgetTime = now()-start;
+    for ( unsigned i=0; i<nQueries; ++i )
+      if ( std::abs(listBudget[i]-indexBudget[i]) > 1E-9*(1.+listBudget[i]) ) ++mismatch;
+
+    std::printf("%8u %12.1f %12.1f %12.1f %12.1f %12.1f %12.1f %10u\n",nLayers,
+		1E9*scanTime/nQueries,1E9*nextTime/nQueries,scanTime/nextTime,
+		1E9*listTime/nQueries,1E9*budgetTime/nQueries,listTime/budgetTime,mismatch);
+  }
+
+  return 0;
+
+}
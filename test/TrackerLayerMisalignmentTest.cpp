@@ -0,0 +1,81 @@
+/** The first-order misalignment fits of TrackerLayerPositions, on the
+ *  module positions of a barrel layer and of a forward layer with rings
+ *  staggered in z : the ideal positions must give no misalignment, and
+ *  positions moved by a known misalignment must give it back.
+ */
+
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerPositions.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerMisalignment.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+  /// The misaligned position of a module, i.e. the point that
+  /// TrackerLayerMisalignment::toLayer brings back to its ideal position
+  GlobalPoint misaligned(const GlobalPoint& ideal, const TrackerLayerMisalignment& m) {
+    double vx = ideal.x();
+    double vy = ideal.y();
+    double vz = ideal.z()-m.zCenter;
+    // Inverse of the first-order rotation of toLayer
+    double x = vx + m.tiltY*vz;
+    double y = vy - m.tiltX*vz;
+    double z = vz + m.tiltX*vy - m.tiltY*vx;
+    return GlobalPoint(x+m.dx,y+m.dy,z+m.zCenter+m.dz);
+  }
+
+  std::vector<GlobalPoint> misaligned(const std::vector<GlobalPoint>& ideal, const TrackerLayerMisalignment& m) {
+    std::vector<GlobalPoint> result;
+    for ( unsigned i=0; i<ideal.size(); ++i ) result.push_back(misaligned(ideal[i],m));
+    return result;
+  }
+
+  /// Shifts within 1 micron, tilts within 1 microradian
+  bool same(const char* what, const TrackerLayerMisalignment& fit, const TrackerLayerMisalignment& expected) {
+    bool ok = std::abs(fit.dx-expected.dx) < 1E-4 && std::abs(fit.dy-expected.dy) < 1E-4 &&
+      std::abs(fit.dz-expected.dz) < 1E-4 &&
+      std::abs(fit.tiltX-expected.tiltX) < 1E-6 && std::abs(fit.tiltY-expected.tiltY) < 1E-6;
+    std::printf("%-24s dx %9.2e dy %9.2e dz %9.2e tiltX %9.2e tiltY %9.2e : %s\n",what,
+		fit.dx,fit.dy,fit.dz,fit.tiltX,fit.tiltY,ok ? "ok" : "FAILED");
+    return ok;
+  }
+
+}
+
+int main() {
+
+  bool ok = true;
+  TrackerLayerMisalignment none = { 0., 0., 0., 0., 0., 0. };
+
+  // A barrel layer : 12 modules along z, 40 in phi
+  std::vector<GlobalPoint> barrel;
+  for ( unsigned iPhi=0; iPhi<40; ++iPhi )
+    for ( unsigned iZ=0; iZ<12; ++iZ )
+      barrel.push_back(GlobalPoint(30.*std::cos(0.157*iPhi),30.*std::sin(0.157*iPhi),-55.+10.*iZ));
+  TrackerLayerMisalignment barrelShift = { 0.010, -0.020, 0.030, 2E-4, -3E-4, 0. };
+  ok = same("barrel, ideal",TrackerLayerPositions::fitBarrelMisalignment(barrel,barrel),none) && ok;
+  ok = same("barrel, misaligned",
+	    TrackerLayerPositions::fitBarrelMisalignment(barrel,misaligned(barrel,barrelShift)),barrelShift) && ok;
+
+  // A forward layer at z = 120 cm : 4 rings, alternately 1.5 cm in front
+  // of and behind the layer surface (the mean module z is not the layer z)
+  double z = 120.;
+  std::vector<GlobalPoint> forward;
+  for ( unsigned iRing=0; iRing<4; ++iRing )
+    for ( unsigned iPhi=0; iPhi<30+10*iRing; ++iPhi ) {
+      double r = 25.+20.*iRing;
+      double phi = 2.*M_PI*iPhi/(30+10*iRing);
+      forward.push_back(GlobalPoint(r*std::cos(phi),r*std::sin(phi),z+(iRing%2 ? 1.5 : -1.3)));
+    }
+  TrackerLayerMisalignment forwardShift = { 0.010, -0.020, 0.030, 2E-4, -3E-4, z };
+  none.zCenter = z;
+  ok = same("forward, ideal",TrackerLayerPositions::fitForwardMisalignment(forward,forward,z),none) && ok;
+  ok = same("forward, misaligned",
+	    TrackerLayerPositions::fitForwardMisalignment(forward,misaligned(forward,forwardShift),z),
+	    forwardShift) && ok;
+
+  return ok ? 0 : 1;
+
+}
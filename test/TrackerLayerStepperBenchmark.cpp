@@ -0,0 +1,147 @@
+/** Walk of straight outgoing lines through the hardcoded interaction
+ *  geometry : the loop form (every layer of the side tested, in list
+ *  order) against the layer stepper, one line at a time and interleaved
+ *  round-robin over groups of lines. The three forms must see the same
+ *  crossings and the same material.
+ */
+
+#include "FastSimulation/TrackerSetup/interface/TrackerInteractionGeometry.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerPositions.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerStepper.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ProcessDesc.h"
+#include "FWCore/PythonParameterSet/interface/PythonProcessDesc.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <sys/time.h>
+
+namespace {
+
+  double now() {
+    timeval tv;
+    gettimeofday(&tv,0);
+    return tv.tv_sec + 1E-6*tv.tv_usec;
+  }
+
+  double flat(unsigned& seed) {
+    seed = 1664525*seed + 1013904223;
+    return (seed>>8) / 16777216.;
+  }
+
+  /// The loop form : all the layers of the side, crossed or not
+  void loop(const TrackerInteractionGeometry& geometry,
+	    double z0, double eta, double phi,
+	    unsigned& nCrossings, double& radLen) {
+    TrackerInteractionGeometry::Side side = TrackerInteractionGeometry::side(eta);
+    double theta = 2.*std::atan(std::exp(-std::abs(eta)));
+    double sinTheta = std::sin(theta);
+    double cosTheta = std::cos(theta);
+    double z = side == TrackerInteractionGeometry::PositiveZ ? z0 : -z0;
+    nCrossings = 0;
+    radLen = 0.;
+    double path, dim, angle;
+    for ( int i=0; i<geometry.nCylinders(side); ++i ) {
+      const TrackerLayer& layer = geometry.layer(side,i);
+      if ( !layer.straightCrossing(z,sinTheta,cosTheta,path,dim,angle) ) continue;
+      ++nCrossings;
+      radLen += layer.radLen() * layer.fudgeFactorAt(dim,phi) * angle;
+    }
+  }
+
+  GlobalVector direction(double eta, double phi) {
+    double theta = 2.*std::atan(std::exp(-eta));
+    return GlobalVector(std::sin(theta)*std::cos(phi),std::sin(theta)*std::sin(phi),std::cos(theta));
+  }
+
+}
+
+int main() {
+
+  std::string config =
+    "import FWCore.ParameterSet.Config as cms\n"
+    "process = cms.Process('TrackerLayerStepperBenchmark')\n"
+    "process.load('FastSimulation.TrackerSetup.TrackerInteractionGeometryESProducer_cfi')\n";
+  PythonProcessDesc builder(config);
+  boost::shared_ptr<edm::ParameterSet> process = builder.processDesc()->getProcessPSet();
+  edm::ParameterSet producer = process->getParameter<edm::ParameterSet>("TrackerInteractionGeometryESProducer");
+  edm::ParameterSet trackerMaterial = producer.getParameter<edm::ParameterSet>("TrackerMaterial");
+  TrackerLayerPositions thePositions(producer.getParameter<edm::ParameterSet>("LayerPositions"));
+  TrackerInteractionGeometry geometry(trackerMaterial,&thePositions);
+
+  const unsigned nLines = 200000;
+  const unsigned nGroup = 16;
+  std::vector<double> z0(nLines), eta(nLines), phi(nLines);
+  unsigned seed = 12345;
+  for ( unsigned i=0; i<nLines; ++i ) {
+    z0[i] = 10.*(flat(seed)-0.5);
+    eta[i] = 6.*(flat(seed)-0.5);
+    phi[i] = M_PI*(2.*flat(seed)-1.);
+  }
+
+  // The loop form
+  std::vector<unsigned> loopCrossings(nLines), stepCrossings(nLines,0), groupCrossings(nLines,0);
+  std::vector<double> loopRadLen(nLines), stepRadLen(nLines,0.), groupRadLen(nLines,0.);
+  double start = now();
+  for ( unsigned i=0; i<nLines; ++i )
+    loop(geometry,z0[i],eta[i],phi[i],loopCrossings[i],loopRadLen[i]);
+  double loopTime = now()-start;
+
+  // The stepper, one line after the other
+  TrackerLayerStepper::Crossing crossing;
+  start = now();
+  for ( unsigned i=0; i<nLines; ++i ) {
+    TrackerLayerStepper stepper(geometry,GlobalPoint(0.,0.,z0[i]),direction(eta[i],phi[i]));
+    while ( stepper.next(crossing) ) {
+      ++stepCrossings[i];
+      stepRadLen[i] += crossing.radLen;
+    }
+  }
+  double stepTime = now()-start;
+
+  // The stepper, one crossing of each line of a group in turn
+  start = now();
+  std::vector<TrackerLayerStepper> steppers;
+  steppers.reserve(nGroup);
+  for ( unsigned first=0; first<nLines; first+=nGroup ) {
+    unsigned last = std::min(first+nGroup,nLines);
+    steppers.clear();
+    for ( unsigned i=first; i<last; ++i )
+      steppers.push_back(TrackerLayerStepper(geometry,GlobalPoint(0.,0.,z0[i]),direction(eta[i],phi[i])));
+    unsigned nActive = last-first;
+    while ( nActive ) {
+      nActive = 0;
+      for ( unsigned i=first; i<last; ++i ) {
+	if ( !steppers[i-first].next(crossing) ) continue;
+	++nActive;
+	++groupCrossings[i];
+	groupRadLen[i] += crossing.radLen;
+      }
+    }
+  }
+  double groupTime = now()-start;
+
+  unsigned mismatch = 0;
+  for ( unsigned i=0; i<nLines; ++i ) {
+    if ( stepCrossings[i] != loopCrossings[i] || groupCrossings[i] != loopCrossings[i] ) ++mismatch;
+    else if ( std::abs(stepRadLen[i]-loopRadLen[i]) > 1E-9*(1.+loopRadLen[i]) ||
+	      std::abs(groupRadLen[i]-loopRadLen[i]) > 1E-9*(1.+loopRadLen[i]) ) ++mismatch;
+  }
+
+  std::printf("%u lines, %d + %d layers (ns per line) :\n",nLines,
+	      geometry.nCylinders(TrackerInteractionGeometry::PositiveZ),
+	      geometry.nCylinders(TrackerInteractionGeometry::NegativeZ));
+  std::printf("  loop form                  %8.1f\n",1E9*loopTime/nLines);
+  std::printf("  stepper                    %8.1f\n",1E9*stepTime/nLines);
+  std::printf("  stepper, %2u interleaved    %8.1f\n",nGroup,1E9*groupTime/nLines);
+  std::printf("Lines with different crossings or material : %u\n",mismatch);
+
+  return mismatch ? 1 : 0;
+
+}
@@ -0,0 +1,236 @@
+/** Accuracy and timing of the alternative material kernels of the
+ *  hardcoded interaction geometry, on the same random straight lines
+ *  from the luminous region (|eta| < 5, |z0| < 15 cm) :
+ *  - the single-precision layer table against the double-precision
+ *    layers (crossing path lengths and material budget). The study fails
+ *    if they differ by more than the tolerances, or if more than 1 line
+ *    in 1000 grazes a layer edge (crossed with one precision only).
+ *  - the (r,z) voxel grids (material_backend = 'Voxels') against the
+ *    surfaces (material budget, and cells walked per line).
+ *  - the layer walk of the stepper with a random first-order misalignment
+ *    of the sensitive layers (shifts of 100 microns, tilts of 0.1 mrad)
+ *    against the same walk ignoring it.
+ *  The number of lines can be given as argument.
+ */
+
+#include "FastSimulation/TrackerSetup/interface/TrackerInteractionGeometry.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerCompactLayerTable.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerMaterialVoxelGrid.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerPositions.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerStepper.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ProcessDesc.h"
+#include "FWCore/PythonParameterSet/interface/PythonProcessDesc.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <sys/time.h>
+
+namespace {
+
+  double now() {
+    timeval tv;
+    gettimeofday(&tv,0);
+    return tv.tv_sec + 1E-6*tv.tv_usec;
+  }
+
+  double flat(unsigned& seed) {
+    seed = 1664525*seed + 1013904223;
+    return (seed>>8) / 16777216.;
+  }
+
+  /// The random lines, shared by all the studies
+  struct Lines {
+    Lines(unsigned n) : eta(n), phi(n), z0(n) {
+      unsigned seed = 12345;
+      for ( unsigned i=0; i<n; ++i ) {
+	eta[i] = 10.*(flat(seed)-0.5);
+	phi[i] = M_PI*(2.*flat(seed)-1.);
+	z0[i] = 30.*(flat(seed)-0.5);
+      }
+    }
+    unsigned size() const { return eta.size(); }
+    GlobalPoint vertex(unsigned i) const { return GlobalPoint(0.,0.,z0[i]); }
+    GlobalVector direction(unsigned i) const {
+      double theta = 2.*std::atan(std::exp(-eta[i]));
+      return GlobalVector(std::sin(theta)*std::cos(phi[i]),std::sin(theta)*std::sin(phi[i]),std::cos(theta));
+    }
+    std::vector<double> eta, phi, z0;
+  };
+
+  /// A random misalignment of all the layers
+  std::vector<TrackerLayerMisalignment> randomMisalignment(unsigned n, unsigned& seed) {
+    std::vector<TrackerLayerMisalignment> result(n);
+    for ( unsigned i=0; i<n; ++i ) {
+      result[i].dx = 0.02*(flat(seed)-0.5);
+      result[i].dy = 0.02*(flat(seed)-0.5);
+      result[i].dz = 0.02*(flat(seed)-0.5);
+      result[i].tiltX = 2E-4*(flat(seed)-0.5);
+      result[i].tiltY = 2E-4*(flat(seed)-0.5);
+      result[i].zCenter = 0.;
+    }
+    return result;
+  }
+
+  /// The single-precision layer table against the layers. A crossing
+  /// found by one precision only is a line grazing a layer edge : such
+  /// lines are counted, and left out of the comparison.
+  bool compactTableStudy(const TrackerInteractionGeometry& geometry, const Lines& lines,
+			 double pathTolerance, double radLenTolerance) {
+    const TrackerCompactLayerTable& table = *geometry.compactLayerTable();
+    unsigned nEdges = 0;
+    double maxPathDiff = 0.;
+    double maxRadLenDiff = 0.;
+    double time[2] = { 0., 0. };
+    for ( unsigned i=0; i<lines.size(); ++i ) {
+      double eta = lines.eta[i];
+      double z0 = lines.z0[i];
+      TrackerInteractionGeometry::Side side = TrackerInteractionGeometry::side(eta);
+      double sign = 1.-2.*side;
+      double theta = 2.*std::atan(std::exp(-eta*sign));
+      float theta32 = 2.f*std::atan(std::exp(-static_cast<float>(eta*sign)));
+      bool edge = false;
+      double path, dim, angle;
+      float path32, dim32, angle32;
+      for ( int iLayer=0; iLayer<geometry.nCylinders(side); ++iLayer ) {
+	bool crossed = geometry.layer(side,iLayer).straightCrossing(z0*sign,std::sin(theta),std::cos(theta),
+								    path,dim,angle);
+	bool crossed32 = table.straightCrossing(side,iLayer,z0*sign,std::sin(theta32),std::cos(theta32),
+						path32,dim32,angle32);
+	if ( crossed != crossed32 ) edge = true;
+	else if ( crossed ) maxPathDiff = std::max(maxPathDiff,std::abs(path-path32));
+      }
+      if ( edge ) {
+	++nEdges;
+	continue;
+      }
+      double start = now();
+      double radLen = geometry.materialBudget(eta,z0);
+      time[0] += now()-start;
+      start = now();
+      double radLen32 = table.materialBudget(eta,z0);
+      time[1] += now()-start;
+      if ( radLen > 0. ) maxRadLenDiff = std::max(maxRadLenDiff,std::abs(radLen-radLen32)/radLen);
+    }
+    std::printf("Single-precision layer table (%u bytes) :\n",table.size());
+    std::printf("  material budget            %8.1f ns per line (layers %8.1f)\n",
+		1E9*time[1]/lines.size(),1E9*time[0]/lines.size());
+    std::printf("  max path difference        %8.2g cm (tolerance %g)\n",maxPathDiff,pathTolerance);
+    std::printf("  max material difference    %8.2g (tolerance %g)\n",maxRadLenDiff,radLenTolerance);
+    std::printf("  lines grazing a layer edge %8u\n",nEdges);
+    return maxPathDiff <= pathTolerance && maxRadLenDiff <= radLenTolerance && nEdges <= 1E-3*lines.size();
+  }
+
+  /// The voxel grids against the surfaces
+  void voxelStudy(const TrackerInteractionGeometry& surfaces, 
+		  const TrackerInteractionGeometry& voxels, const Lines& lines) {
+    std::vector<double> surfaceRadLen(lines.size()), voxelRadLen(lines.size());
+    double start = now();
+    for ( unsigned i=0; i<lines.size(); ++i ) 
+      surfaceRadLen[i] = surfaces.materialBudget(lines.eta[i],lines.z0[i]);
+    double surfaceTime = now()-start;
+    start = now();
+    for ( unsigned i=0; i<lines.size(); ++i ) 
+      voxelRadLen[i] = voxels.materialBudget(lines.eta[i],lines.z0[i]);
+    double voxelTime = now()-start;
+    unsigned nCells, totalCells = 0;
+    for ( unsigned i=0; i<lines.size(); ++i ) {
+      TrackerInteractionGeometry::Side side = TrackerInteractionGeometry::side(lines.eta[i]);
+      double sign = 1.-2.*side;
+      double theta = 2.*std::atan(std::exp(-sign*lines.eta[i]));
+      voxels.voxelGrid(side)->materialBudget(sign*lines.z0[i],std::sin(theta),std::cos(theta),&nCells);
+      totalCells += nCells;
+    }
+    double sumDiff = 0.;
+    double maxDiff = 0.;
+    for ( unsigned i=0; i<lines.size(); ++i ) {
+      if ( surfaceRadLen[i] <= 0. ) continue;
+      double diff = std::abs(voxelRadLen[i]-surfaceRadLen[i])/surfaceRadLen[i];
+      sumDiff += diff;
+      maxDiff = std::max(maxDiff,diff);
+    }
+    std::printf("Voxel grids (%u bytes) :\n",
+		voxels.voxelGrid(TrackerInteractionGeometry::PositiveZ)->size() + 
+		voxels.voxelGrid(TrackerInteractionGeometry::NegativeZ)->size());
+    std::printf("  material budget            %8.1f ns per line (surfaces %8.1f), %.1f cells per line\n",
+		1E9*voxelTime/lines.size(),1E9*surfaceTime/lines.size(),double(totalCells)/lines.size());
+    std::printf("  material difference        %8.2g mean, %8.2g max\n",sumDiff/lines.size(),maxDiff);
+  }
+
+  /// The stepper through the misaligned layers, and ignoring the misalignment
+  void misalignmentStudy(const TrackerInteractionGeometry& geometry, const Lines& lines) {
+    double time[2];
+    std::vector<double> radLen[2];
+    TrackerLayerStepper::Crossing crossing;
+    for ( unsigned ideal=0; ideal<2; ++ideal ) {
+      radLen[ideal].assign(lines.size(),0.);
+      double start = now();
+      for ( unsigned i=0; i<lines.size(); ++i ) {
+	TrackerLayerStepper stepper(geometry,lines.vertex(i),lines.direction(i));
+	if ( ideal ) stepper.ignoreMisalignment();
+	while ( stepper.next(crossing) ) radLen[ideal][i] += crossing.radLen;
+      }
+      time[ideal] = now()-start;
+    }
+    double maxDiff = 0.;
+    for ( unsigned i=0; i<lines.size(); ++i )
+      if ( radLen[1][i] > 0. ) maxDiff = std::max(maxDiff,std::abs(radLen[0][i]-radLen[1][i])/radLen[1][i]);
+    std::printf("First-order misalignment (margin %.3g cm) :\n",geometry.misalignmentMargin());
+    std::printf("  layer walk                 %8.1f ns per line (ideal %8.1f)\n",
+		1E9*time[0]/lines.size(),1E9*time[1]/lines.size());
+    std::printf("  max material difference    %8.2g\n",maxDiff);
+  }
+
+}
+
+int main(int argc, char** argv) {
+
+  std::string config =
+    "import FWCore.ParameterSet.Config as cms\n"
+    "process = cms.Process('TrackerRandomLineStudy')\n"
+    "process.load('FastSimulation.TrackerSetup.TrackerInteractionGeometryESProducer_cfi')\n";
+  PythonProcessDesc builder(config);
+  boost::shared_ptr<edm::ParameterSet> process = builder.processDesc()->getProcessPSet();
+  edm::ParameterSet producer = process->getParameter<edm::ParameterSet>("TrackerInteractionGeometryESProducer");
+  edm::ParameterSet trackerMaterial = producer.getParameter<edm::ParameterSet>("TrackerMaterial");
+  TrackerLayerPositions thePositions(producer.getParameter<edm::ParameterSet>("LayerPositions"));
+
+  Lines lines(argc > 1 ? std::atoi(argv[1]) : 100000);
+  bool ok = true;
+
+  edm::ParameterSet compactMaterial = trackerMaterial;
+  compactMaterial.addUntrackedParameter<bool>("compact_table",true);
+  TrackerInteractionGeometry compactGeometry(compactMaterial,&thePositions);
+  ok = compactTableStudy(compactGeometry,lines,1E-3,1E-4) && ok;
+
+  edm::ParameterSet voxelMaterial = trackerMaterial;
+  voxelMaterial.addParameter<std::string>("material_backend","Voxels");
+  TrackerInteractionGeometry voxelGeometry(voxelMaterial,&thePositions);
+  voxelStudy(compactGeometry,voxelGeometry,lines);
+
+  unsigned seed = 54321;
+  TrackerLayerPositions misalignedPositions = thePositions;
+  std::vector<TrackerLayerMisalignment> barrel = randomMisalignment(thePositions.nBarrelLayers(),seed);
+  std::vector<TrackerLayerMisalignment> positiveForward = randomMisalignment(thePositions.nForwardLayers(),seed);
+  std::vector<TrackerLayerMisalignment> negativeForward = randomMisalignment(thePositions.nForwardLayers(),seed);
+  for ( unsigned i=0; i<thePositions.nForwardLayers(); ++i ) {
+    positiveForward[i].zCenter = thePositions.forwardZ(0,i);
+    negativeForward[i].zCenter = thePositions.forwardZ(1,i);
+  }
+  misalignedPositions.setMisalignment(barrel,positiveForward,negativeForward);
+  edm::ParameterSet misalignedMaterial = trackerMaterial;
+  misalignedMaterial.addParameter<bool>("first_order_misalignment",true);
+  TrackerInteractionGeometry misalignedGeometry(misalignedMaterial,&misalignedPositions);
+  misalignmentStudy(misalignedGeometry,lines);
+
+  return ok ? 0 : 1;
+
+}
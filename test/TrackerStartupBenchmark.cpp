@@ -0,0 +1,106 @@
+/** Startup cost of the hardcoded interaction geometry : the full
+ *  construction against the concurrent one, where the part that does not
+ *  depend on the layer positions (material tables, media, fixed dead
+ *  material) is prepared in a thread while the layer positions are
+ *  obtained. Here the layer positions come from the configuration
+ *  snapshot; with the reco geometry, the preparation is hidden behind
+ *  the much longer GeometricSearchTracker construction, so that the
+ *  saving is the preparation time.
+ */
+
+#include "FastSimulation/TrackerSetup/interface/TrackerInteractionGeometry.h"
+#include "FastSimulation/TrackerSetup/interface/TrackerLayerPositions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ProcessDesc.h"
+#include "FWCore/PythonParameterSet/interface/PythonProcessDesc.h"
+
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <sys/time.h>
+
+namespace {
+
+  double now() {
+    timeval tv;
+    gettimeofday(&tv,0);
+    return tv.tv_sec + 1E-6*tv.tv_usec;
+  }
+
+  void prepare(const edm::ParameterSet* trackerMaterial, TrackerInteractionGeometry** result) {
+    *result = new TrackerInteractionGeometry(*trackerMaterial);
+  }
+
+  double median(std::vector<double> times) {
+    std::sort(times.begin(),times.end());
+    return times[times.size()/2];
+  }
+
+}
+
+int main() {
+
+  std::string config =
+    "import FWCore.ParameterSet.Config as cms\n"
+    "process = cms.Process('TrackerStartupBenchmark')\n"
+    "process.load('FastSimulation.TrackerSetup.TrackerInteractionGeometryESProducer_cfi')\n";
+  PythonProcessDesc builder(config);
+  boost::shared_ptr<edm::ParameterSet> process = builder.processDesc()->getProcessPSet();
+  edm::ParameterSet producer = process->getParameter<edm::ParameterSet>("TrackerInteractionGeometryESProducer");
+  edm::ParameterSet trackerMaterial = producer.getParameter<edm::ParameterSet>("TrackerMaterial");
+  edm::ParameterSet layerPositions = producer.getParameter<edm::ParameterSet>("LayerPositions");
+
+  const unsigned nRuns = 21;
+  std::vector<double> full, prepared, built, concurrent;
+  for ( unsigned iRun=0; iRun<nRuns; ++iRun ) {
+
+    // Sequential : layer positions, then the whole geometry
+    double start = now();
+    {
+      TrackerLayerPositions thePositions(layerPositions);
+      TrackerInteractionGeometry geometry(trackerMaterial,&thePositions);
+    }
+    full.push_back(now()-start);
+
+    // The two parts alone
+    start = now();
+    TrackerInteractionGeometry* geometry = new TrackerInteractionGeometry(trackerMaterial);
+    prepared.push_back(now()-start);
+    start = now();
+    {
+      TrackerLayerPositions thePositions(layerPositions);
+      geometry->build(trackerMaterial,&thePositions);
+    }
+    built.push_back(now()-start);
+    delete geometry;
+
+    // Concurrent : the preparation in a thread, the layer positions in
+    // this one
+    start = now();
+    geometry = 0;
+    boost::thread thread(boost::bind(&prepare,&trackerMaterial,&geometry));
+    {
+      TrackerLayerPositions thePositions(layerPositions);
+      thread.join();
+      geometry->build(trackerMaterial,&thePositions);
+    }
+    concurrent.push_back(now()-start);
+    delete geometry;
+
+  }
+
+  std::printf("Median of %u runs (ms) :\n",nRuns);
+  std::printf("  sequential construction    %8.3f\n",1E3*median(full));
+  std::printf("  preparation alone          %8.3f\n",1E3*median(prepared));
+  std::printf("  build after preparation    %8.3f\n",1E3*median(built));
+  std::printf("  concurrent construction    %8.3f\n",1E3*median(concurrent));
+  std::printf("Time hidden behind the reco geometry : up to %.3f ms\n",1E3*median(prepared));
+
+  return 0;
+
+}